@@ -5,6 +5,7 @@
  */
 
 #include "curve_tracker.h"
+#include "timeseries_qwt.h"
 #include "qwt_series_data.h"
 #include "qwt_plot.h"
 #include "qwt_plot_curve.h"
@@ -281,20 +282,22 @@ void CurveTracker::setReferencePosition(std::optional<QPointF> reference_pos)
 
 std::optional<QPointF> curvePointAt(const QwtPlotCurve* curve, double x)
 {
-  if (curve->dataSize() >= 2)
+  // search the samples with full resolution, not the decimated ones
+  const auto series = UnwrapSeries(curve->data());
+  if (series->size() >= 2)
   {
-    int index = qwtUpperSampleIndex<QPointF>(*curve->data(), x, compareX());
+    int index = qwtUpperSampleIndex<QPointF>(*series, x, compareX());
 
-    if (index > 0 && index < curve->dataSize())
+    if (index > 0 && index < series->size())
     {
-      auto p1 = (curve->sample(index - 1));
-      auto p2 = (curve->sample(index));
+      auto p1 = (series->sample(index - 1));
+      auto p2 = (series->sample(index));
       double middle_X = (p1.x() + p2.x()) / 2.0;
       return (x < middle_X) ? p1 : p2;
     }
-    else if (index >= curve->dataSize())
+    else if (index >= series->size())
     {
-      return curve->sample(curve->dataSize() - 1);
+      return series->sample(series->size() - 1);
     }
   }
   return std::nullopt;
@@ -95,11 +95,18 @@ void CurveListPanel::clear()
   _custom_view->clear();
   _tree_view->clear();
   _tree_view_items.clear();
+  _listed_array_elements.clear();
   ui->labelNumberDisplayed->setText("0 of 0");
 }
 
 bool CurveListPanel::addCurve(const std::string& plot_name)
 {
+  auto array_it = _plot_data.arrays.find(plot_name);
+  if (array_it != _plot_data.arrays.end())
+  {
+    return addArrayElements(plot_name, array_it->second);
+  }
+
   QString plot_id = QString::fromStdString(plot_name);
   if (_tree_view_items.count(plot_name) > 0)
   {
@@ -138,6 +145,34 @@ bool CurveListPanel::addCurve(const std::string& plot_name)
   return true;
 }
 
+bool CurveListPanel::addArrayElements(const std::string& array_name, const ArraySeries& array)
+{
+  // the elements are listed, but their series are created only when used
+  // (see PlotDataMapRef::materializeArrayElement()). Arrays may grow.
+  size_t& listed = _listed_array_elements[array_name];
+  if (listed >= array.width())
+  {
+    return false;
+  }
+  QString group_name;
+  if (array.group())
+  {
+    group_name = QString::fromStdString(array.group()->name());
+  }
+  for (size_t i = listed; i < array.width(); i++)
+  {
+    const std::string element_name = ArrayElementName(array_name, i);
+    if (_tree_view_items.insert(element_name).second)
+    {
+      QString plot_id = QString::fromStdString(element_name);
+      _tree_view->addItem(group_name, getTreeName(plot_id), plot_id);
+    }
+  }
+  listed = array.width();
+  _column_width_dirty = true;
+  return true;
+}
+
 void CurveListPanel::addCustom(const QString& item_name)
 {
   _custom_view->addItem({}, item_name, item_name);
@@ -313,37 +348,69 @@ void CurveListPanel::refreshValues()
     return num_text + " ";
   };
 
-  auto GetValue = [&](const std::string& name) -> QString {
+  // The handle of the series is stored in the item the first time,
+  // then the series is found without converting and hashing its name.
+  auto GetValue = [&](QTreeWidgetItem* cell, const QString& curve_name) -> QString {
+    const QVariant handle = cell->data(0, CustomRoles::SeriesHandle);
+    SeriesId id = SeriesId::fromUInt64(handle.toULongLong());
+    if (!handle.isValid() || (!_plot_data.series(id) && !_plot_data.stringSeries(id)))
     {
-      auto it = _plot_data.numeric.find(name);
-      if (it != _plot_data.numeric.end())
+      const SeriesId new_id = _plot_data.findSeriesId(curve_name.toStdString());
+      if (!handle.isValid() || new_id != id)
       {
-        auto& plot_data = it->second;
-        auto val = plot_data.getYfromX(_tracker_time);
-        if (val)
+        cell->setData(0, CustomRoles::SeriesHandle, qulonglong(new_id.toUInt64()));
+      }
+      id = new_id;
+    }
+
+    if (const PlotData* plot_data = _plot_data.series(id))
+    {
+      auto val = cursorOf(_value_cursors, id, plot_data).yFromX(_tracker_time);
+      if (val)
+      {
+        return FormattedNumber(val.value());
+      }
+    }
+
+    if (const StringSeries* plot_data = _plot_data.stringSeries(id))
+    {
+      const int index = cursorOf(_string_cursors, id, plot_data).indexFromX(_tracker_time);
+      std::optional<std::string_view> str;
+      if (index >= 0)
+      {
+        str = plot_data->getString(plot_data->at(index).y);
+      }
+      if (str)
+      {
+        char last_byte = str->data()[str->size() - 1];
+        if (last_byte == '\0')
         {
-          return FormattedNumber(val.value());
+          return QString::fromLocal8Bit(str->data(), str->size() - 1);
+        }
+        else
+        {
+          return QString::fromLocal8Bit(str->data(), str->size());
         }
       }
     }
 
+    // element of an array, not materialized
+    std::string array_name;
+    size_t element_index = 0;
+    if (SplitArrayElementName(curve_name.toStdString(), array_name, element_index))
     {
-      auto it = _plot_data.strings.find(name);
-      if (it != _plot_data.strings.end())
+      auto array_it = _plot_data.arrays.find(array_name);
+      if (array_it != _plot_data.arrays.end())
       {
-        auto& plot_data = it->second;
-        auto str = plot_data.getStringFromX(_tracker_time);
-        if (str)
+        const int index = array_it->second.getIndexFromX(_tracker_time);
+        std::optional<float> val;
+        if (index >= 0)
         {
-          char last_byte = str->data()[str->size() - 1];
-          if (last_byte == '\0')
-          {
-            return QString::fromLocal8Bit(str->data(), str->size() - 1);
-          }
-          else
-          {
-            return QString::fromLocal8Bit(str->data(), str->size());
-          }
+          val = array_it->second.element(index, element_index);
+        }
+        if (val)
+        {
+          return FormattedNumber(val.value());
         }
       }
     }
@@ -373,7 +440,7 @@ void CurveListPanel::refreshValues()
 
         if (!is2ndColumnHidden())
         {
-          QString str_value = GetValue(curve_name.toStdString());
+          QString str_value = GetValue(cell, curve_name);
           cell->setText(1, str_value);
         }
       }
@@ -478,6 +545,18 @@ void CurveListPanel::removeCurve(const std::string& name)
   _tree_view->removeCurve(curve_name);
   _tree_view_items.erase(name);
   _custom_view->removeCurve(curve_name);
+
+  auto array_it = _listed_array_elements.find(name);
+  if (array_it != _listed_array_elements.end())
+  {
+    for (size_t i = 0; i < array_it->second; i++)
+    {
+      const std::string element_name = ArrayElementName(name, i);
+      _tree_view->removeCurve(QString::fromStdString(element_name));
+      _tree_view_items.erase(element_name);
+    }
+    _listed_array_elements.erase(array_it);
+  }
 }
 
 void CurveListPanel::on_buttonAddCustom_clicked()
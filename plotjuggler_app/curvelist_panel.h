@@ -19,7 +19,9 @@
 #include "transforms/custom_function.h"
 #include "tree_completer.h"
 #include "curvetree_view.h"
+#include "PlotJuggler/series_cursor.h"
 #include <array>
+#include <vector>
 
 namespace Ui
 {
@@ -98,12 +100,37 @@ private:
 
   void updateTreeModel();
 
+  bool addArrayElements(const std::string& array_name, const ArraySeries& array);
+
   CurveTreeView* _custom_view;
   CurveTreeView* _tree_view;
   std::unordered_set<std::string> _tree_view_items;
+  // number of elements listed, for each ArraySeries
+  std::unordered_map<std::string, size_t> _listed_array_elements;
 
   double _tracker_time = 0;
 
+  // the tracker usually moves by small steps: the search of the value at _tracker_time
+  // starts from the position found at the previous refresh. Indexed by SeriesId::index
+  std::vector<SeriesCursor<double>> _value_cursors;
+  std::vector<SeriesCursor<StringDictIndex>> _string_cursors;
+
+  template <typename Value>
+  static SeriesCursor<Value>& cursorOf(std::vector<SeriesCursor<Value>>& cursors, SeriesId id,
+                                       const TimeseriesBase<Value>* series)
+  {
+    if (cursors.size() <= id.index)
+    {
+      cursors.resize(id.index + 1);
+    }
+    auto& cursor = cursors[id.index];
+    if (cursor.series() != series)
+    {
+      cursor.setSeries(series);
+    }
+    return cursor;
+  }
+
   const TransformsMap& _transforms_map;
 
   QString _style_dir;
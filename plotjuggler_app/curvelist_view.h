@@ -45,7 +45,9 @@ enum CustomRoles
 {
   Name = Qt::UserRole,
   IsGroupName = Qt::UserRole + 1,
-  ToolTip = Qt::UserRole + 2
+  ToolTip = Qt::UserRole + 2,
+  // PJ::SeriesId of the curve, stored with SeriesId::toUInt64()
+  SeriesHandle = Qt::UserRole + 3
 };
 
 class CurvesView
@@ -15,6 +15,7 @@
 #include <QDebug>
 #include <QDesktopServices>
 #include <QDirIterator>
+#include <QDockWidget>
 #include <QDomDocument>
 #include <QDoubleSpinBox>
 #include <QElapsedTimer>
@@ -63,6 +64,7 @@
 #include "nlohmann_parsers.h"
 #include "cheatsheet/cheatsheet_dialog.h"
 #include "colormap_editor.h"
+#include "retention_dialog.h"
 
 #ifdef COMPILED_WITH_CATKIN
 
@@ -320,8 +322,31 @@ MainWindow::MainWindow(const QCommandLineParser& commandline_parser, QWidget* pa
   // save initial state
   onUndoableChange();
 
-  _replot_timer = new QTimer(this);
-  connect(_replot_timer, &QTimer::timeout, this, [this]() { updateDataAndReplot(false); });
+  _replot_scheduler = new ReplotScheduler(this);
+  connect(_replot_scheduler, &ReplotScheduler::replotRequested, this,
+          [this]() { updateDataAndReplot(false); });
+
+  _metrics_panel = new StreamingMetricsPanel(this);
+  _metrics_panel->setPlotsProvider([this](const StreamingMetricsPanel::PlotVisitor& visit) {
+    forEachWidget([&](PlotWidget* plot, PlotDocker* docker, int index) {
+      visit(QString("%1 / %2").arg(docker->name()).arg(index + 1), plot->paintLatency());
+    });
+  });
+  auto metrics_dock = new QDockWidget(tr("Streaming metrics"), this);
+  metrics_dock->setObjectName("StreamingMetricsDock");
+  metrics_dock->setWidget(_metrics_panel);
+  addDockWidget(Qt::BottomDockWidgetArea, metrics_dock);
+  metrics_dock->hide();
+  ui->menuTools->addAction(metrics_dock->toggleViewAction());
+
+  _record_action = ui->menuTools->addAction(tr("Record streaming to MCAP..."));
+  _record_action->setCheckable(true);
+  _record_action->setEnabled(false);
+  _record_action->setToolTip(tr("Save the messages received by the streaming plugin, "
+                                "before they are parsed, into a MCAP file"));
+  connect(_record_action, &QAction::toggled, this, [this](bool checked) {
+    checked ? startRecording() : stopRecording();
+  });
 
   _publish_timer = new QTimer(this);
   _publish_timer->setInterval(20);
@@ -778,10 +803,9 @@ void MainWindow::initializePlugins()
     connect(streamer_ptr, &DataStreamer::removeGroup, this, &MainWindow::on_deleteSerieFromGroup);
 
     connect(streamer_ptr, &DataStreamer::dataReceived, this, [this]() {
-      if (isStreamingActive() && !_replot_timer->isActive())
+      if (isStreamingActive())
       {
-        _replot_timer->setSingleShot(true);
-        _replot_timer->start(40);
+        _replot_scheduler->requestReplot();
       }
     });
 
@@ -1050,6 +1074,8 @@ QDomDocument MainWindow::xmlSaveState() const
   streaming_buffer.setAttribute("value", ui->streamingSpinBox->value());
   root.appendChild(streaming_buffer);
 
+  root.appendChild(RetentionDialog::xmlSaveState(doc, _retention_rules, _memory_budget));
+
   return doc;
 }
 
@@ -1189,6 +1215,12 @@ bool MainWindow::xmlLoadState(QDomDocument state_document)
     int buffer_val = streaming_buffer.attribute("value", "5").toInt();
     ui->streamingSpinBox->setValue(buffer_val);
   }
+
+  if (RetentionDialog::xmlLoadState(root.firstChildElement("streaming_retention"),
+                                    _retention_rules, _memory_budget))
+  {
+    applyRetention();
+  }
   return true;
 }
 
@@ -1364,10 +1396,12 @@ void MainWindow::importPlotDataMap(PlotDataMapRef& new_data, bool remove_old)
     ClearOldSeries(_mapped_plot_data.scatter_xy, new_data.scatter_xy);
     ClearOldSeries(_mapped_plot_data.numeric, new_data.numeric);
     ClearOldSeries(_mapped_plot_data.strings, new_data.strings);
+    ClearOldSeries(_mapped_plot_data.arrays, new_data.arrays);
   }
 
   auto [added_curves, curve_updated, data_pushed] =
       MoveData(new_data, _mapped_plot_data, remove_old);
+  _mapped_plot_data.updateArrayElements();
 
   for (const auto& added_curve : added_curves)
   {
@@ -1573,6 +1607,11 @@ std::unordered_set<std::string> MainWindow::loadDataFromFile(const FileLoadInfo&
       {
         AddPrefixToPlotData(info.prefix.toStdString(), mapped_data.numeric);
         AddPrefixToPlotData(info.prefix.toStdString(), mapped_data.strings);
+        AddPrefixToPlotData(info.prefix.toStdString(), mapped_data.arrays);
+        // the series were moved: handles created by the loader are not valid anymore
+        mapped_data.invalidateSeriesIds();
+        // data loaded from file is mostly read: keep its older chunks compressed
+        mapped_data.setCompression(true);
 
         added_names = mapped_data.getAllNames();
         bool remove_old = !merge_files;
@@ -1710,8 +1749,12 @@ void MainWindow::stopStreamingPlugin()
     on_buttonStreamingPause_toggled(true);
   }
 
+  stopRecording();
+  _record_action->setEnabled(false);
+
   if (_active_streamer_plugin)
   {
+    // the latencies stay visible in the StreamingMetricsPanel
     _active_streamer_plugin->shutdown();
     _active_streamer_plugin = nullptr;
   }
@@ -1723,12 +1766,16 @@ void MainWindow::stopStreamingPlugin()
 
   // reset max range.
   _mapped_plot_data.setMaximumRangeX(std::numeric_limits<double>::max());
+  _mapped_plot_data.setRetentionRules({});
+  _mapped_plot_data.setMemoryBudget(0);
+  _field_demand.reset();
 }
 
 void MainWindow::startStreamingPlugin(QString streamer_name)
 {
   if (_active_streamer_plugin)
   {
+    stopRecording();
     _active_streamer_plugin->shutdown();
     _active_streamer_plugin = nullptr;
   }
@@ -1751,6 +1798,36 @@ void MainWindow::startStreamingPlugin(QString streamer_name)
     return;
   }
 
+  // samples received out of order (multiple publishers, jittery timestamps) are merged in
+  // batches, at the latest when the data is moved into _mapped_plot_data
+  {
+    QSettings settings;
+    double reorder_window = settings.value("Preferences::streaming_reorder_window", 0.1).toDouble();
+    _active_streamer_plugin->dataMap().setReorderWindow(reorder_window);
+    // policies of the series, moved with the samples into _mapped_plot_data
+    _active_streamer_plugin->dataMap().setRetentionRules(_retention_rules);
+    _mapped_plot_data.setMemoryBudget(_memory_budget);
+
+    // the parsers store only the samples of the series that are needed
+    if (settings.value("Preferences::lazy_fields", false).toBool())
+    {
+      _field_demand = std::make_shared<FieldDemand>();
+      _field_demand->setBackfillMessages(
+          settings.value("Preferences::lazy_fields_backfill", 0).toUInt());
+      updateFieldDemand();
+    }
+    else
+    {
+      _field_demand.reset();
+    }
+    _active_streamer_plugin->setFieldDemand(_field_demand);
+
+    // the refresh rate is lowered when a frame takes longer than this
+    int frame_budget = settings.value("Preferences::streaming_frame_budget", 20).toInt();
+    _replot_scheduler->setFrameBudget(frame_budget);
+    _replot_scheduler->reset();
+  }
+
   bool started = false;
   try
   {
@@ -1769,13 +1846,15 @@ void MainWindow::startStreamingPlugin(QString streamer_name)
   // The attempt to start the plugin may have succeeded or failed
   if (started)
   {
-    {
-      std::lock_guard<std::mutex> lock(_active_streamer_plugin->mutex());
-      importPlotDataMap(_active_streamer_plugin->dataMap(), false);
-    }
+    _active_streamer_plugin->metrics().reset();
+    _metrics_panel->setStreamer(_active_streamer_plugin);
+
+    _active_streamer_plugin->consumeData(
+        [this](PlotDataMapRef& data) { importPlotDataMap(data, false); });
 
     ui->actionClearBuffer->setEnabled(true);
     ui->actionDeleteAllData->setToolTip("Stop streaming to be able to delete the data");
+    _record_action->setEnabled(true);
 
     ui->buttonStreamingStart->setText("Stop");
     ui->buttonStreamingPause->setEnabled(true);
@@ -2419,6 +2498,11 @@ bool MainWindow::loadLayoutFromFile(QString filename, bool load_datafiles)
 }
 
 void MainWindow::linkedZoomOut()
+{
+  linkedZoomOut([](const PlotWidget*) { return true; });
+}
+
+void MainWindow::linkedZoomOut(const std::function<bool(const PlotWidget*)>& predicate)
 {
   if (ui->buttonLink->isChecked())
   {
@@ -2427,7 +2511,17 @@ void MainWindow::linkedZoomOut()
       auto tabs = it.second->tabWidget();
       for (int t = 0; t < tabs->count(); t++)
       {
-        if (PlotDocker* matrix = dynamic_cast<PlotDocker*>(tabs->widget(t)))
+        PlotDocker* matrix = dynamic_cast<PlotDocker*>(tabs->widget(t));
+        if (!matrix)
+        {
+          continue;
+        }
+        bool to_update = false;
+        for (int index = 0; index < matrix->plotCount() && !to_update; index++)
+        {
+          to_update = predicate(matrix->plotAt(index));
+        }
+        if (to_update)
         {
           bool first = true;
           Range range;
@@ -2473,7 +2567,12 @@ void MainWindow::linkedZoomOut()
   }
   else
   {
-    this->forEachWidget([](PlotWidget* plot) { plot->zoomOut(false); });
+    this->forEachWidget([&](PlotWidget* plot) {
+      if (predicate(plot))
+      {
+        plot->zoomOut(false);
+      }
+    });
   }
 }
 
@@ -2540,16 +2639,17 @@ void MainWindow::updateTimeOffset()
 
 void MainWindow::updateDataAndReplot(bool replot_hidden_tabs)
 {
-  _replot_timer->stop();
+  _replot_scheduler->cancel();
 
   MoveDataRet move_ret;
 
   if (_active_streamer_plugin)
   {
-    {
-      std::lock_guard<std::mutex> lock(_active_streamer_plugin->mutex());
-      move_ret = MoveData(_active_streamer_plugin->dataMap(), _mapped_plot_data, false);
-    }
+    updateFieldDemand();
+    _active_streamer_plugin->consumeData([&](PlotDataMapRef& data) {
+      move_ret = MoveData(data, _mapped_plot_data, false);
+    });
+    _mapped_plot_data.updateArrayElements();
 
     for (const auto& str : move_ret.added_curves)
     {
@@ -2575,6 +2675,7 @@ void MainWindow::updateDataAndReplot(bool replot_hidden_tabs)
       syncCurves(_mapped_plot_data.numeric);
       syncCurves(_mapped_plot_data.scatter_xy);
       syncCurves(_mapped_plot_data.strings);
+      syncCurves(_mapped_plot_data.arrays);
       if (any_added)
       {
         move_ret.curves_updated = true;
@@ -2594,6 +2695,22 @@ void MainWindow::updateDataAndReplot(bool replot_hidden_tabs)
     {
       _mapped_plot_data.setMaximumRangeX(ui->streamingSpinBox->value());
     }
+
+    // about once per second: the series displayed now are the last ones to be trimmed
+    if (_mapped_plot_data.memoryBudget() > 0 && ++_memory_budget_counter >= 25)
+    {
+      _memory_budget_counter = 0;
+      forEachWidget([this](PlotWidget* plot) {
+        if (plot->isVisible())
+        {
+          for (const auto& info : plot->curveList())
+          {
+            _mapped_plot_data.markViewed(info.src_name);
+          }
+        }
+      });
+      _mapped_plot_data.enforceMemoryBudget();
+    }
   }
 
   const bool is_streaming_active = isStreamingActive();
@@ -2620,7 +2737,9 @@ void MainWindow::updateDataAndReplot(bool replot_hidden_tabs)
     }
   }
 
-  forEachWidget([](PlotWidget* plot) { plot->updateCurves(false); });
+  // When called by the scheduler, the widgets in the hidden tabs and the ones whose series
+  // did not change are skipped. The tracker and the time slider are updated anyway.
+  const auto updated_widgets = updateWidgetCurves(replot_hidden_tabs);
 
   //--------------------------------
   // trigger again the execution of this callback if steaming == true
@@ -2637,7 +2756,33 @@ void MainWindow::updateDataAndReplot(bool replot_hidden_tabs)
     updateTimeSlider();
   }
   //--------------------------------
-  linkedZoomOut();
+  if (!updated_widgets.empty())
+  {
+    linkedZoomOut([&](const PlotWidget* plot) { return updated_widgets.count(plot) != 0; });
+  }
+}
+
+std::set<const PlotWidget*> MainWindow::updateWidgetCurves(bool update_all)
+{
+  std::set<const PlotWidget*> updated_widgets;
+  forEachWidget([&](PlotWidget* plot) {
+    if (update_all || (plot->isVisible() && plot->curvesChanged()))
+    {
+      plot->updateCurves(false);
+      updated_widgets.insert(plot);
+    }
+  });
+  return updated_widgets;
+}
+
+void MainWindow::onPlotTabChanged()
+{
+  // the widgets of this tab were skipped by updateDataAndReplot() while it was hidden
+  const auto updated_widgets = updateWidgetCurves(false);
+  if (!updated_widgets.empty())
+  {
+    linkedZoomOut([&](const PlotWidget* plot) { return updated_widgets.count(plot) != 0; });
+  }
 }
 
 void MainWindow::on_streamingSpinBox_valueChanged(int value)
@@ -2669,6 +2814,146 @@ void MainWindow::on_streamingSpinBox_valueChanged(int value)
   }
 }
 
+void MainWindow::on_buttonStreamingRetention_clicked()
+{
+  RetentionDialog dialog(_retention_rules, _memory_budget, this);
+  if (dialog.exec() != QDialog::Accepted)
+  {
+    return;
+  }
+  _retention_rules = dialog.rules();
+  _memory_budget = dialog.memoryBudget();
+  applyRetention();
+  onUndoableChange();
+}
+
+void MainWindow::applyRetention()
+{
+  if (!_active_streamer_plugin)
+  {
+    return;
+  }
+  _active_streamer_plugin->setRetentionRules(_retention_rules);
+  _mapped_plot_data.setMemoryBudget(_memory_budget);
+}
+
+void MainWindow::updateFieldDemand()
+{
+  if (!_field_demand)
+  {
+    return;
+  }
+  std::unordered_set<std::string> names;
+  forEachWidget([&names](PlotWidget* plot) {
+    for (const PlotData* source : plot->dataSources())
+    {
+      names.insert(source->plotName());
+    }
+  });
+  for (auto& [id, function] : _transform_functions)
+  {
+    for (const PlotData* source : function->dataSources())
+    {
+      names.insert(source->plotName());
+    }
+  }
+  for (auto& name : _curvelist_widget->getSelectedNames())
+  {
+    names.insert(std::move(name));
+  }
+  // the elements of an array are taken from the ArraySeries
+  std::vector<std::string> array_names;
+  for (const auto& name : names)
+  {
+    std::string array_name;
+    size_t index = 0;
+    if (SplitArrayElementName(name, array_name, index) &&
+        _mapped_plot_data.arrays.count(array_name) > 0)
+    {
+      array_names.push_back(std::move(array_name));
+    }
+  }
+  names.insert(array_names.begin(), array_names.end());
+  _field_demand->setRequested(std::move(names));
+}
+
+void MainWindow::startRecording()
+{
+  if (!_active_streamer_plugin || _recorder)
+  {
+    return;
+  }
+  QSettings settings;
+  QString directory_path =
+      settings.value("MainWindow.lastRecordingDirectory", QDir::currentPath()).toString();
+  QString filename = QFileDialog::getSaveFileName(this, tr("Record streaming to MCAP"),
+                                                  directory_path, "MCAP files (*.mcap)");
+  if (filename.isEmpty())
+  {
+    QSignalBlocker block(_record_action);
+    _record_action->setChecked(false);
+    return;
+  }
+  if (QFileInfo(filename).suffix().isEmpty())
+  {
+    filename.append(".mcap");
+  }
+  settings.setValue("MainWindow.lastRecordingDirectory", QFileInfo(filename).absolutePath());
+
+  McapRecorder::Options options;
+  options.compression =
+      settings.value("Preferences::mcap_record_compression", "zstd").toString().toStdString();
+  const int max_pending_mb = settings.value("Preferences::mcap_record_max_pending_mb", 256).toInt();
+  options.max_pending_bytes = size_t(std::max(1, max_pending_mb)) * 1024 * 1024;
+
+  auto recorder = std::make_shared<McapRecorder>();
+  std::string error;
+  if (!recorder->open(filename.toStdString(), options, error))
+  {
+    QMessageBox::warning(this, tr("Record streaming to MCAP"),
+                         tr("Can't create the file %1:\n\n%2")
+                             .arg(filename)
+                             .arg(QString::fromStdString(error)));
+    QSignalBlocker block(_record_action);
+    _record_action->setChecked(false);
+    return;
+  }
+  _recorder = recorder;
+  _active_streamer_plugin->setRecorder(_recorder);
+}
+
+void MainWindow::stopRecording()
+{
+  if (_active_streamer_plugin)
+  {
+    _active_streamer_plugin->setRecorder(nullptr);
+  }
+  if (_recorder)
+  {
+    // the streamer doesn't use it anymore: the remaining messages can be written
+    _recorder->close();
+    const auto written = static_cast<qulonglong>(_recorder->writtenMessages());
+    const auto dropped = static_cast<qulonglong>(_recorder->droppedMessages());
+    _recorder.reset();
+    if (dropped > 0)
+    {
+      // the recording is incomplete: the user must know it
+      QMessageBox::warning(this, tr("Record streaming to MCAP"),
+                           tr("The recording is incomplete: %1 messages were written, but %2 "
+                              "were dropped, because the disk could not keep up with the "
+                              "stream.")
+                               .arg(written)
+                               .arg(dropped));
+    }
+    else
+    {
+      showToast(tr("Recording saved: %1 messages").arg(written));
+    }
+  }
+  QSignalBlocker block(_record_action);
+  _record_action->setChecked(false);
+}
+
 void MainWindow::on_actionExit_triggered()
 {
   this->close();
@@ -2761,6 +3046,11 @@ void MainWindow::on_actionClearBuffer_triggered()
     it.second.clear();
   }
 
+  for (auto& it : _mapped_plot_data.arrays)
+  {
+    it.second.clear();
+  }
+
   for (auto& it : _transform_functions)
   {
     it.second->reset();
@@ -2789,6 +3079,7 @@ void MainWindow::on_deleteSerieFromGroup(std::string group_name)
   AddFromGroup(_mapped_plot_data.numeric);
   AddFromGroup(_mapped_plot_data.strings);
   AddFromGroup(_mapped_plot_data.user_defined);
+  AddFromGroup(_mapped_plot_data.arrays);
 
   onDeleteMultipleCurves(names);
 }
@@ -2855,7 +3146,7 @@ void MainWindow::on_buttonTimeTracker_pressed()
 
 void MainWindow::closeEvent(QCloseEvent* event)
 {
-  _replot_timer->stop();
+  _replot_scheduler->cancel();
   _publish_timer->stop();
 
   if (_active_streamer_plugin)
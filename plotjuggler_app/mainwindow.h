@@ -33,6 +33,9 @@
 #include "transforms/function_editor.h"
 #include "plugin_manager.h"
 #include "toast_manager.h"
+#include "replot_scheduler.h"
+#include "streaming_metrics_panel.h"
+#include "mcap_recorder.h"
 
 #include "ui_mainwindow.h"
 
@@ -78,6 +81,8 @@ public slots:
 
   void on_streamingSpinBox_valueChanged(int value);
 
+  void on_buttonStreamingRetention_clicked();
+
   void on_comboStreaming_currentIndexChanged(const QString& current_text);
 
   void on_splitterMoved(int, int);
@@ -90,6 +95,8 @@ public slots:
 
   void onPlotTabAdded(PlotDocker* docker);
 
+  void onPlotTabChanged();
+
   void onPlotZoomChanged(PlotWidget* modified_plot, QRectF new_range);
 
   void on_tabbedAreaDestroyed(QObject* object);
@@ -157,8 +164,21 @@ private:
 
   MonitoredValue _time_offset;
 
-  QTimer* _replot_timer;
+  ReplotScheduler* _replot_scheduler;
+
+  StreamingMetricsPanel* _metrics_panel;
   int _curvelist_resync_counter = 0;
+
+  // limits of the samples kept while streaming, see RetentionDialog
+  RetentionRules _retention_rules;
+  size_t _memory_budget = 0;
+  int _memory_budget_counter = 0;
+
+  // "lazy fields" mode of the streamer: the series needed by the widgets, see FieldDemand
+  FieldDemand::Ptr _field_demand;
+
+  QAction* _record_action;
+  std::shared_ptr<McapRecorder> _recorder;
   QTimer* _publish_timer;
   PJ::DelayedCallback _tracker_delay;
 
@@ -226,6 +246,16 @@ private:
 
   bool isStreamingActive() const;
 
+  // send the retention rules and the memory budget to the active streamer
+  void applyRetention();
+
+  // request to the parsers of the streamer the series plotted, used by a transform or selected
+  void updateFieldDemand();
+
+  // save the raw messages of the active streamer into a MCAP file
+  void startRecording();
+  void stopRecording();
+
   void closeEvent(QCloseEvent* event);
 
   void loadPluginState(const QDomElement& root);
@@ -233,6 +263,13 @@ private:
 
   std::tuple<double, double, int> calculateVisibleRangeX();
 
+  // zoom out only the widgets that satisfy the predicate (and the ones linked to them)
+  void linkedZoomOut(const std::function<bool(const PlotWidget*)>& predicate);
+
+  // update the curves of the widgets, skipping the ones that are hidden or not changed,
+  // unless update_all is true. Return the updated widgets.
+  std::set<const PlotWidget*> updateWidgetCurves(bool update_all);
+
   void deleteAllData();
 
   void updateRecentDataMenu(QStringList new_filenames);
@@ -0,0 +1,284 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "mcap_recorder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// the application doesn't link the MCAP plugin: it needs its own copy of the library
+#define MCAP_IMPLEMENTATION
+#include <mcap/writer.hpp>
+
+namespace
+{
+// a batch is passed to the writer thread when it is larger or older than this
+constexpr size_t BATCH_BYTES = 1024 * 1024;
+constexpr double BATCH_PERIOD = 0.1;
+
+// batches kept to reuse their memory
+constexpr size_t MAX_RECYCLED_BATCHES = 4;
+
+uint64_t ToNanoseconds(double seconds)
+{
+  if (!std::isfinite(seconds) || seconds <= 0)
+  {
+    return 0;
+  }
+  return static_cast<uint64_t>(seconds * 1e9);
+}
+}  // namespace
+
+struct McapRecorder::Pimpl
+{
+  mcap::McapWriter writer;
+  // MCAP channel of each topic_id
+  std::vector<mcap::ChannelId> channels;
+};
+
+void McapRecorder::Batch::clear()
+{
+  topics.clear();
+  records.clear();
+  bytes.clear();
+  created = 0;
+}
+
+McapRecorder::McapRecorder() : _p(new Pimpl)
+{
+}
+
+McapRecorder::~McapRecorder()
+{
+  close();
+}
+
+bool McapRecorder::open(const std::string& filename, const Options& options,
+                        std::string& error)
+{
+  close();
+
+  mcap::McapWriterOptions writer_options("");
+  writer_options.chunkSize = options.chunk_size;
+  if (options.compression == "lz4")
+  {
+    writer_options.compression = mcap::Compression::Lz4;
+  }
+  else if (options.compression == "none")
+  {
+    writer_options.compression = mcap::Compression::None;
+  }
+  else
+  {
+    writer_options.compression = mcap::Compression::Zstd;
+  }
+
+  const auto status = _p->writer.open(filename, writer_options);
+  if (!status.ok())
+  {
+    error = status.message;
+    return false;
+  }
+
+  _options = options;
+  _current.clear();
+  _next_topic_id = 0;
+  _p->channels.clear();
+  _pending.clear();
+  _pending_bytes = 0;
+  _stop = false;
+  _written = 0;
+  _dropped = 0;
+  _open = true;
+  _thread = std::thread(&McapRecorder::writerLoop, this);
+  return true;
+}
+
+void McapRecorder::close()
+{
+  if (!_open)
+  {
+    return;
+  }
+  {
+    std::unique_lock lock(_mutex);
+    if (!_current.topics.empty() || !_current.records.empty())
+    {
+      _pending_bytes += _current.bytes.size();
+      _pending.push_back(std::move(_current));
+      _current = {};
+    }
+    _stop = true;
+  }
+  _cv.notify_one();
+  _thread.join();
+  _p->writer.close();
+  _open = false;
+}
+
+bool McapRecorder::isOpen() const
+{
+  return _open;
+}
+
+uint32_t McapRecorder::addTopic(const std::string& topic, const PJ::MessageSchema& schema)
+{
+  // the definitions of the topics are never dropped, even when the messages are
+  const uint32_t id = _next_topic_id++;
+  _current.topics.push_back({ id, topic, schema });
+  return id;
+}
+
+bool McapRecorder::record(uint32_t topic_id, const PJ::MessageRef& msg, double receive_time,
+                          double timestamp)
+{
+  if (!_open)
+  {
+    return false;
+  }
+  if (_current.records.empty())
+  {
+    _current.created = receive_time;
+  }
+
+  // _pending_bytes is read without the lock: the limit is approximate
+  if (_pending_bytes + _current.bytes.size() + msg.size() > _options.max_pending_bytes)
+  {
+    _dropped++;
+    tryHandOver();
+    return false;
+  }
+
+  Record record;
+  record.topic_id = topic_id;
+  record.log_time = ToNanoseconds(receive_time);
+  record.publish_time = ToNanoseconds(timestamp);
+  record.offset = _current.bytes.size();
+  record.size = msg.size();
+  _current.records.push_back(record);
+  _current.bytes.insert(_current.bytes.end(), msg.data(), msg.data() + msg.size());
+
+  if (_current.bytes.size() >= BATCH_BYTES || receive_time - _current.created >= BATCH_PERIOD)
+  {
+    tryHandOver();
+  }
+  return true;
+}
+
+bool McapRecorder::tryHandOver()
+{
+  if (_current.topics.empty() && _current.records.empty())
+  {
+    return true;
+  }
+  // if the writer thread holds the lock, try again with the next message
+  std::unique_lock lock(_mutex, std::try_to_lock);
+  if (!lock.owns_lock())
+  {
+    return false;
+  }
+  _pending_bytes += _current.bytes.size();
+  _pending.push_back(std::move(_current));
+  if (_recycled.empty())
+  {
+    _current = {};
+  }
+  else
+  {
+    _current = std::move(_recycled.back());
+    _recycled.pop_back();
+  }
+  lock.unlock();
+  _cv.notify_one();
+  return true;
+}
+
+void McapRecorder::writerLoop()
+{
+  std::vector<Batch> batches;
+  while (true)
+  {
+    bool stop = false;
+    {
+      std::unique_lock lock(_mutex);
+      // give back the memory of the batches written in the previous iteration
+      for (auto& batch : batches)
+      {
+        _pending_bytes -= batch.bytes.size();
+        if (_recycled.size() < MAX_RECYCLED_BATCHES)
+        {
+          batch.clear();
+          _recycled.push_back(std::move(batch));
+        }
+      }
+      batches.clear();
+
+      _cv.wait(lock, [this]() { return _stop || !_pending.empty(); });
+      std::swap(batches, _pending);
+      stop = _stop;
+    }
+
+    for (const auto& batch : batches)
+    {
+      writeBatch(batch);
+    }
+
+    if (stop)
+    {
+      std::unique_lock lock(_mutex);
+      if (_pending.empty())
+      {
+        _pending_bytes = 0;
+        return;
+      }
+    }
+  }
+}
+
+void McapRecorder::writeBatch(const Batch& batch)
+{
+  auto& writer = _p->writer;
+
+  for (const auto& topic : batch.topics)
+  {
+    const auto& schema = topic.schema;
+    // the MCAP loader needs a schema, even if the encoding has no definition
+    const std::string& schema_name = schema.name.empty() ? topic.name : schema.name;
+    const std::string& schema_encoding =
+        schema.schema_encoding.empty() ? schema.encoding : schema.schema_encoding;
+    mcap::Schema mcap_schema(schema_name, schema_encoding, schema.definition);
+    writer.addSchema(mcap_schema);
+
+    mcap::Channel channel(topic.name, schema.encoding, mcap_schema.id);
+    writer.addChannel(channel);
+
+    if (_p->channels.size() <= topic.id)
+    {
+      _p->channels.resize(topic.id + 1);
+    }
+    _p->channels[topic.id] = channel.id;
+  }
+
+  mcap::Message message;
+  for (const auto& record : batch.records)
+  {
+    message.channelId = _p->channels[record.topic_id];
+    message.sequence = 0;
+    message.logTime = record.log_time;
+    message.publishTime = record.publish_time;
+    message.dataSize = record.size;
+    message.data = reinterpret_cast<const std::byte*>(batch.bytes.data() + record.offset);
+    if (writer.write(message).ok())
+    {
+      _written++;
+    }
+    else
+    {
+      _dropped++;
+    }
+  }
+}
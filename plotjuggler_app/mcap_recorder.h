@@ -0,0 +1,129 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef MCAP_RECORDER_H
+#define MCAP_RECORDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "PlotJuggler/message_recorder.h"
+
+/**
+ * Saves the raw messages received by a DataStreamer into a MCAP file, that can be
+ * loaded later with the MCAP plugin.
+ *
+ * The messages are copied into a batch by the receive thread, that passes it to a
+ * writer thread every few milliseconds. The writer thread compresses and writes them.
+ * The memory used by the batches waiting to be written is limited: when it is full,
+ * the new messages are dropped, the receive thread is never blocked.
+ */
+class McapRecorder : public PJ::MessageRecorder
+{
+public:
+  struct Options
+  {
+    /// "zstd", "lz4" or "none".
+    std::string compression = "zstd";
+    /// Size of the uncompressed MCAP chunks, in bytes.
+    uint64_t chunk_size = 4 * 1024 * 1024;
+    /// Messages waiting to be written, in bytes. When exceeded, the new messages are dropped.
+    size_t max_pending_bytes = 256 * 1024 * 1024;
+  };
+
+  McapRecorder();
+
+  ~McapRecorder() override;
+
+  /// Returns false (and a description in error) if the file can't be created.
+  bool open(const std::string& filename, const Options& options, std::string& error);
+
+  /// Write the remaining messages and close the file. Call it after the recorder
+  /// was removed from the DataStreamer (DataStreamer::setRecorder(nullptr)).
+  void close();
+
+  bool isOpen() const;
+
+  uint32_t addTopic(const std::string& topic, const PJ::MessageSchema& schema) override;
+
+  bool record(uint32_t topic_id, const PJ::MessageRef& msg, double receive_time,
+              double timestamp) override;
+
+  uint64_t writtenMessages() const
+  {
+    return _written;
+  }
+
+  uint64_t droppedMessages() const
+  {
+    return _dropped;
+  }
+
+private:
+  struct Topic
+  {
+    uint32_t id;
+    std::string name;
+    PJ::MessageSchema schema;
+  };
+
+  struct Record
+  {
+    uint32_t topic_id;
+    uint64_t log_time;
+    uint64_t publish_time;
+    size_t offset;
+    size_t size;
+  };
+
+  // the messages and the topics added since the previous batch
+  struct Batch
+  {
+    std::vector<Topic> topics;
+    std::vector<Record> records;
+    std::vector<uint8_t> bytes;
+    double created = 0;
+
+    void clear();
+  };
+
+  // pass _current to the writer thread. Returns false if it is busy
+  bool tryHandOver();
+
+  void writerLoop();
+
+  void writeBatch(const Batch& batch);
+
+  struct Pimpl;
+  std::unique_ptr<Pimpl> _p;
+
+  Options _options;
+
+  // accessed only by the receive thread
+  Batch _current;
+  uint32_t _next_topic_id = 0;
+
+  // protected by _mutex
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::vector<Batch> _pending;
+  std::vector<Batch> _recycled;
+  bool _stop = false;
+
+  // bytes of _pending and of the batches being written. Modified with _mutex locked
+  std::atomic<size_t> _pending_bytes = 0;
+
+  std::thread _thread;
+  std::atomic_bool _open = false;
+  std::atomic<uint64_t> _written = 0;
+  std::atomic<uint64_t> _dropped = 0;
+};
+
+#endif  // MCAP_RECORDER_H
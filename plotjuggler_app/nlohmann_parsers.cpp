@@ -6,113 +6,414 @@
 
 #include "nlohmann_parsers.h"
 
-#include "fmt/format.h"
+#include <unordered_map>
+#include <vector>
 
-bool NlohmannParser::parseMessageImpl(double& timestamp)
+/*
+ * SAX handler of nlohmann::json (see nlohmann::json::sax_parse()) that pushes the values
+ * into the series while the message is decoded.
+ *
+ * The series of each path, such as "topic/pose/x" or "topic/ranges[3]", is stored in a
+ * tree of KeyNode, built while the first messages are parsed: the names are not formatted
+ * again and the series are not searched by name at each message. The fields of an object
+ * usually come in the same order, so the next field is first compared with the one that
+ * followed the previous field.
+ *
+ * A batch (an array at the root) is parsed element by element, as separate messages.
+ * The samples are pushed only when the whole input was parsed, as it happens building the
+ * DOM: a malformed message doesn't store anything, and the timestamp field may come after
+ * the other fields.
+ */
+class NlohmannParser::Flattener
 {
-  // Support batched messages: if the top-level value is an array,
-  // treat each element as a separate data point with its own timestamp.
-  // This allows senders to batch multiple samples into a single message,
-  // reducing per-message overhead for high-rate data sources.
-  if (_json.is_array())
+public:
+  using json = nlohmann::json;
+
+  explicit Flattener(NlohmannParser& parser) : _parser(parser), _root(parser._topic_name)
+  {
+  }
+
+  bool parse(const MessageRef msg, json::input_format_t format, double& timestamp)
+  {
+    _frames.clear();
+    _array_values.clear();
+    _samples.clear();
+    _arrays.clear();
+    _pending_array_values.clear();
+    _messages.clear();
+    _use_stamp = _parser._use_message_stamp && !_parser._stamp_fieldname.empty();
+    _stamp_disabled = false;
+    _timestamp = timestamp;
+
+    if (!json::sax_parse(msg.data(), msg.data() + msg.size(), this, format))
+    {
+      return false;
+    }
+    commit();
+    timestamp = _timestamp;
+    return true;
+  }
+
+  //--------- SAX interface ----------
+  bool null()
+  {
+    return otherValue();
+  }
+
+  bool boolean(bool value)
+  {
+    return numericValue(value ? 1.0 : 0.0, false);
+  }
+
+  bool number_integer(json::number_integer_t value)
+  {
+    return numericValue(static_cast<double>(value), true);
+  }
+
+  bool number_unsigned(json::number_unsigned_t value)
+  {
+    return numericValue(static_cast<double>(value), true);
+  }
+
+  bool number_float(json::number_float_t value, const json::string_t&)
+  {
+    return numericValue(static_cast<double>(value), true);
+  }
+
+  bool string(json::string_t&)
+  {
+    return otherValue();
+  }
+
+  bool binary(json::binary_t&)
+  {
+    return otherValue();
+  }
+
+  bool start_object(std::size_t)
+  {
+    if (_frames.empty())
+    {
+      beginMessage();
+      _frames.push_back({ &_root, false });
+      return true;
+    }
+    _frames.push_back({ valueNode(), false });
+    return true;
+  }
+
+  bool key(json::string_t& name)
+  {
+    Frame& frame = _frames.back();
+    frame.field = field(frame.node, name);
+    _stamp_key = (_frames.size() == 1 && _message_stamp && name == _parser._stamp_fieldname);
+    return true;
+  }
+
+  bool end_object()
+  {
+    _frames.pop_back();
+    if (_frames.empty())
+    {
+      endMessage();
+    }
+    return true;
+  }
+
+  bool start_array(std::size_t)
   {
-    nlohmann::json array = std::move(_json);
-    for (auto& element : array)
+    // an array at the root is a batch: each element is a message
+    if (!_frames.empty())
     {
-      _json = std::move(element);
-      parseMessageImpl(timestamp);
+      _frames.push_back({ valueNode(), true });
     }
     return true;
   }
 
-  if (_use_message_stamp && _stamp_fieldname.empty() == false)
+  bool end_array()
   {
-    auto ts = _json.find(_stamp_fieldname);
-    if (ts != _json.end() && ts.value().is_number())
+    if (_frames.empty())
     {
-      timestamp = ts.value().get<double>();
+      return true;  // end of a batch
+    }
+    Frame& frame = _frames.back();
+    // a large array of numbers is stored as a single ArraySeries
+    if (frame.numbers_only && frame.size > _parser.maxArraySize() && !_parser.clampLargeArray())
+    {
+      _arrays.push_back({ frame.node, _pending_array_values.size(), _array_values.size() });
+      _pending_array_values.insert(_pending_array_values.end(), _array_values.begin(),
+                                   _array_values.end());
+      _array_values.clear();
     }
     else
     {
-      _use_message_stamp = false;
+      explodeArray(frame);
     }
+    _frames.pop_back();
+    return true;
   }
 
-  std::function<void(const std::string&, const nlohmann::json&)> flatten;
+  template <typename Exception>
+  bool parse_error(std::size_t, const std::string&, const Exception& ex)
+  {
+    throw ex;
+  }
 
-  flatten = [&](const std::string& prefix, const nlohmann::json& value) {
-    if (value.empty())
+private:
+  // series of a path of the message
+  struct KeyNode
+  {
+    explicit KeyNode(std::string series_name) : name(std::move(series_name))
     {
-      return;
     }
 
-    switch (value.type())
+    std::string name;
+    SeriesId id;
+
+    // fields of the object, in the order they were found the first time
+    std::vector<std::pair<std::string, std::unique_ptr<KeyNode>>> fields;
+    std::unordered_map<std::string, size_t> field_index;
+    size_t next_field = 0;
+
+    // elements of the array
+    std::vector<std::unique_ptr<KeyNode>> elements;
+  };
+
+  struct Frame
+  {
+    KeyNode* node;
+    bool is_array;
+    // object: node of the current field
+    KeyNode* field = nullptr;
+    // array: number of elements so far. While they are all numbers, their values are
+    // kept in _array_values, because the array may be stored as an ArraySeries.
+    size_t size = 0;
+    bool numbers_only = true;
+  };
+
+  struct Sample
+  {
+    KeyNode* node;
+    double value;
+  };
+
+  struct ArraySample
+  {
+    KeyNode* node;
+    size_t offset;  // in _pending_array_values
+    size_t size;
+  };
+
+  // samples of a message: the ones in _samples and _arrays before these positions
+  struct Message
+  {
+    size_t samples_end;
+    size_t arrays_end;
+    double timestamp;
+  };
+
+  NlohmannParser& _parser;
+  KeyNode _root;
+
+  std::vector<Frame> _frames;
+  std::vector<double> _array_values;
+
+  std::vector<Sample> _samples;
+  std::vector<ArraySample> _arrays;
+  std::vector<double> _pending_array_values;
+  std::vector<Message> _messages;
+
+  // the timestamp field is used. _use_message_stamp is changed only if the input is valid
+  bool _use_stamp = false;
+  bool _stamp_disabled = false;
+  // the timestamp field is still expected in the current message
+  bool _message_stamp = false;
+  // the next value is the timestamp field
+  bool _stamp_key = false;
+  bool _stamp_found = false;
+  double _timestamp = 0;
+
+  KeyNode* field(KeyNode* node, const std::string& key)
+  {
+    auto& fields = node->fields;
+    size_t pos = node->next_field < fields.size() ? node->next_field : 0;
+    if (pos >= fields.size() || fields[pos].first != key)
     {
-      case nlohmann::detail::value_t::array: {
-        // iterate array and use index as reference string
-        for (std::size_t i = 0; i < value.size(); ++i)
-        {
-          flatten(fmt::format("{}[{}]", prefix, i), value[i]);
-        }
-        break;
+      auto it = node->field_index.find(key);
+      if (it != node->field_index.end())
+      {
+        pos = it->second;
       }
-
-      case nlohmann::detail::value_t::object: {
-        // iterate object and use keys as reference string
-        for (const auto& element : value.items())
-        {
-          flatten(fmt::format("{}/{}", prefix, element.key()), element.value());
-        }
-        break;
+      else
+      {
+        pos = fields.size();
+        fields.emplace_back(key, std::make_unique<KeyNode>(node->name + "/" + key));
+        node->field_index.emplace(key, pos);
       }
+    }
+    node->next_field = pos + 1;
+    return fields[pos].second.get();
+  }
 
-      default: {
-        double numeric_value = 0;
-        if (value.is_boolean())
-        {
-          numeric_value = value.get<bool>();
-        }
-        else if (value.is_number())
-        {
-          numeric_value = value.get<double>();
-        }
-        else
+  KeyNode* element(KeyNode* node, size_t index)
+  {
+    auto& elements = node->elements;
+    while (elements.size() <= index)
+    {
+      elements.push_back(std::make_unique<KeyNode>(ArrayElementName(node->name, elements.size())));
+    }
+    return elements[index].get();
+  }
+
+  // from now on, push the elements of the array one by one
+  void explodeArray(Frame& frame)
+  {
+    if (!frame.numbers_only)
+    {
+      return;
+    }
+    frame.numbers_only = false;
+    for (size_t i = 0; i < _array_values.size(); i++)
+    {
+      _samples.push_back({ element(frame.node, i), _array_values[i] });
+    }
+    _array_values.clear();
+  }
+
+  // node of the value that starts in the current frame
+  KeyNode* valueNode()
+  {
+    Frame& frame = _frames.back();
+    if (frame.is_array)
+    {
+      explodeArray(frame);
+      return element(frame.node, frame.size++);
+    }
+    _stamp_key = false;
+    return frame.field;
+  }
+
+  bool numericValue(double value, bool is_number)
+  {
+    if (_frames.empty())
+    {
+      // a message that is just a value
+      beginMessage();
+      _samples.push_back({ &_root, value });
+      endMessage();
+      return true;
+    }
+    Frame& frame = _frames.back();
+    if (frame.is_array && frame.numbers_only)
+    {
+      _array_values.push_back(value);
+      frame.size++;
+      return true;
+    }
+    if (_stamp_key && is_number)
+    {
+      _stamp_found = true;
+      _timestamp = value;
+    }
+    _samples.push_back({ valueNode(), value });
+    return true;
+  }
+
+  // strings, null and binary values are skipped
+  bool otherValue()
+  {
+    if (_frames.empty())
+    {
+      beginMessage();
+      endMessage();
+      return true;
+    }
+    valueNode();
+    return true;
+  }
+
+  void beginMessage()
+  {
+    _message_stamp = _use_stamp;
+    _stamp_key = false;
+    _stamp_found = false;
+  }
+
+  void endMessage()
+  {
+    if (_message_stamp && !_stamp_found)
+    {
+      _use_stamp = false;
+      _stamp_disabled = true;
+    }
+    _messages.push_back({ _samples.size(), _arrays.size(), _timestamp });
+  }
+
+  void commit()
+  {
+    if (_stamp_disabled)
+    {
+      _parser._use_message_stamp = false;
+    }
+    size_t sample_index = 0;
+    size_t array_index = 0;
+    for (const auto& message : _messages)
+    {
+      for (; sample_index < message.samples_end; sample_index++)
+      {
+        const Sample& sample = _samples[sample_index];
+        PlotData* series = _parser._plot_data.series(sample.node->id);
+        if (!series)
         {
-          return;
+          sample.node->id = _parser.registerSeries(sample.node->name);
+          series = _parser._plot_data.series(sample.node->id);
         }
+        series->pushBack({ message.timestamp, sample.value });
+      }
+      for (; array_index < message.arrays_end; array_index++)
+      {
+        const ArraySample& array = _arrays[array_index];
+        const double* values = _pending_array_values.data() + array.offset;
+        _parser.getArraySeries(array.node->name)
+            .pushBack(message.timestamp, Span<const double>(values, array.size));
+      }
+    }
+  }
+};
 
-        auto plot_data = &(getSeries(prefix));
-        plot_data->pushBack({ timestamp, numeric_value });
+NlohmannParser::NlohmannParser(const std::string& topic_name, PlotDataMapRef& data,
+                               bool use_msg_stamp, const std::string& stamp_fieldname)
+  : MessageParser(topic_name, data)
+  , _use_message_stamp(use_msg_stamp)
+  , _stamp_fieldname(stamp_fieldname)
+  , _flattener(std::make_unique<Flattener>(*this))
+{
+}
 
-        break;
-      }
-    }  // end switch
-  };
+NlohmannParser::~NlohmannParser() = default;
 
-  flatten(_topic_name, _json);
-  return true;
+bool NlohmannParser::parseMessageImpl(const MessageRef msg, nlohmann::json::input_format_t format,
+                                      double& timestamp)
+{
+  return _flattener->parse(msg, format, timestamp);
 }
 
 bool MessagePack_Parser::parseMessage(const MessageRef msg, double& timestamp)
 {
-  _json = nlohmann::json::from_msgpack(msg.data(), msg.data() + msg.size());
-  return parseMessageImpl(timestamp);
+  return parseMessageImpl(msg, nlohmann::json::input_format_t::msgpack, timestamp);
 }
 
 bool JSON_Parser::parseMessage(const MessageRef msg, double& timestamp)
 {
-  _json = nlohmann::json::parse(msg.data(), msg.data() + msg.size());
-  return parseMessageImpl(timestamp);
+  return parseMessageImpl(msg, nlohmann::json::input_format_t::json, timestamp);
 }
 
 bool CBOR_Parser::parseMessage(const MessageRef msg, double& timestamp)
 {
-  _json = nlohmann::json::from_cbor(msg.data(), msg.data() + msg.size());
-  return parseMessageImpl(timestamp);
+  return parseMessageImpl(msg, nlohmann::json::input_format_t::cbor, timestamp);
 }
 
 bool BSON_Parser::parseMessage(const MessageRef msg, double& timestamp)
 {
-  _json = nlohmann::json::from_bson(msg.data(), msg.data() + msg.size());
-  return parseMessageImpl(timestamp);
+  return parseMessageImpl(msg, nlohmann::json::input_format_t::bson, timestamp);
 }
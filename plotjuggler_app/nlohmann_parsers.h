@@ -8,6 +8,7 @@
 #define NLOHMANN_PARSERS_H
 
 #include "nlohmann/json.hpp"
+#include <memory>
 #include "PlotJuggler/messageparser_base.h"
 #include <QDebug>
 #include <QSettings>
@@ -18,19 +19,22 @@ class NlohmannParser : public MessageParser
 {
 public:
   NlohmannParser(const std::string& topic_name, PlotDataMapRef& data, bool use_msg_stamp,
-                 const std::string& stamp_fieldname)
-    : MessageParser(topic_name, data)
-    , _use_message_stamp(use_msg_stamp)
-    , _stamp_fieldname(stamp_fieldname)
-  {
-  }
+                 const std::string& stamp_fieldname);
+
+  ~NlohmannParser() override;
 
 protected:
-  bool parseMessageImpl(double& timestamp);
+  /// Flatten the message as it is decoded (SAX interface of nlohmann::json):
+  /// the DOM is never built.
+  bool parseMessageImpl(const MessageRef msg, nlohmann::json::input_format_t format,
+                        double& timestamp);
 
-  nlohmann::json _json;
   bool _use_message_stamp;
   std::string _stamp_fieldname;
+
+private:
+  class Flattener;
+  std::unique_ptr<Flattener> _flattener;
 };
 
 class JSON_Parser : public NlohmannParser
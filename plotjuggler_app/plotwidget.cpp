@@ -405,7 +405,7 @@ PlotWidgetBase::CurveInfo* PlotWidget::addCurve(const std::string& name, QColor
 
   if (info && info->curve)
   {
-    if (auto timeseries = dynamic_cast<QwtTimeseries*>(info->curve->data()))
+    if (auto timeseries = dynamic_cast<QwtTimeseries*>(UnwrapSeries(info->curve->data())))
     {
       timeseries->setTimeOffset(_time_offset);
     }
@@ -428,7 +428,7 @@ void PlotWidget::onDataSourceRemoved(const std::string& src_name)
 
   for (auto it = curveList().begin(); it != curveList().end();)
   {
-    PointSeriesXY* curve_xy = dynamic_cast<PointSeriesXY*>(it->curve->data());
+    PointSeriesXY* curve_xy = dynamic_cast<PointSeriesXY*>(UnwrapSeries(it->curve->data()));
     bool remove_curve_xy = curve_xy && (curve_xy->dataX()->plotName() == src_name ||
                                         curve_xy->dataY()->plotName() == src_name);
 
@@ -490,7 +490,8 @@ void PlotWidget::onDragEnterEvent(QDragEnterEvent* event)
     {
       _dragging.curves.push_back(curve_name);
     }
-    if (_mapped_data.numeric.count(name) == 0 && _mapped_data.scatter_xy.count(name) == 0)
+    // the series of an element of an array is created when it is dragged
+    if (!_mapped_data.materializeArrayElement(name) && _mapped_data.scatter_xy.count(name) == 0)
     {
       event->ignore();
       return;
@@ -694,7 +695,7 @@ QDomElement PlotWidget::xmlSaveState(QDomDocument& doc) const
 
     if (isXYPlot())
     {
-      if (auto xy = dynamic_cast<PointSeriesXY*>(curve->data()))
+      if (auto xy = dynamic_cast<PointSeriesXY*>(UnwrapSeries(curve->data())))
       {
         curve_el.setAttribute("curve_x", QString::fromStdString(xy->dataX()->plotName()));
         curve_el.setAttribute("curve_y", QString::fromStdString(xy->dataY()->plotName()));
@@ -702,7 +703,7 @@ QDomElement PlotWidget::xmlSaveState(QDomDocument& doc) const
     }
     else
     {
-      auto ts = dynamic_cast<TransformedTimeseries*>(curve->data());
+      auto ts = dynamic_cast<TransformedTimeseries*>(UnwrapSeries(curve->data()));
       if (ts && ts->transform())
       {
         QDomElement transform_el = doc.createElement("transform");
@@ -816,7 +817,7 @@ bool PlotWidget::xmlLoadState(QDomElement& plot_widget, bool autozoom)
     //-----------------
     if (is_timeseries || is_scatter_xy)
     {
-      if ((is_timeseries && _mapped_data.numeric.count(curve_name_std) == 0) ||
+      if ((is_timeseries && !_mapped_data.materializeArrayElement(curve_name_std)) ||
           (!is_timeseries && _mapped_data.scatter_xy.count(curve_name_std) == 0))
       {
         missing_curves.append(curve_name);
@@ -831,7 +832,7 @@ bool PlotWidget::xmlLoadState(QDomElement& plot_widget, bool autozoom)
         auto& curve = curve_info->curve;
         added_curve_names.insert(curve_name_std);
 
-        auto ts = dynamic_cast<TransformedTimeseries*>(curve->data());
+        auto ts = dynamic_cast<TransformedTimeseries*>(UnwrapSeries(curve->data()));
         QDomElement transform_el = curve_element.firstChildElement("transform");
         if (ts && transform_el.isNull() == false)
         {
@@ -857,8 +858,8 @@ bool PlotWidget::xmlLoadState(QDomElement& plot_widget, bool autozoom)
     {
       std::string curve_x = curve_element.attribute("curve_x").toStdString();
       std::string curve_y = curve_element.attribute("curve_y").toStdString();
-      if (_mapped_data.numeric.find(curve_x) == _mapped_data.numeric.end() ||
-          _mapped_data.numeric.find(curve_y) == _mapped_data.numeric.end())
+      if (!_mapped_data.materializeArrayElement(curve_x) ||
+          !_mapped_data.materializeArrayElement(curve_y))
       {
         missing_curves.append(curve_name);
       }
@@ -1051,7 +1052,7 @@ void PlotWidget::reloadPlotData()
     auto data_it = _mapped_data.numeric.find(curve_name);
     if (data_it != _mapped_data.numeric.end())
     {
-      if (auto ts = dynamic_cast<TransformedTimeseries*>(it.curve->data()))
+      if (auto ts = dynamic_cast<TransformedTimeseries*>(UnwrapSeries(it.curve->data())))
       {
         ts->updateCache(true);
       }
@@ -1100,7 +1101,7 @@ void PlotWidget::setTrackerPosition(double abs_time)
   {
     for (auto& it : curveList())
     {
-      if (auto series = dynamic_cast<QwtTimeseries*>(it.curve->data()))
+      if (auto series = dynamic_cast<QwtTimeseries*>(UnwrapSeries(it.curve->data())))
       {
         auto pointXY = series->sampleFromTime(abs_time);
         if (pointXY)
@@ -1133,7 +1134,7 @@ void PlotWidget::on_changeTimeOffset(double offset)
   {
     for (auto& it : curveList())
     {
-      if (auto series = dynamic_cast<QwtTimeseries*>(it.curve->data()))
+      if (auto series = dynamic_cast<QwtTimeseries*>(UnwrapSeries(it.curve->data())))
       {
         series->setTimeOffset(_time_offset);
       }
@@ -1204,12 +1205,64 @@ void PlotWidget::updateCurves(bool reset_older_data)
 {
   for (auto& it : curveList())
   {
-    auto series = dynamic_cast<QwtSeriesWrapper*>(it.curve->data());
+    auto series = dynamic_cast<QwtSeriesWrapper*>(UnwrapSeries(it.curve->data()));
     series->updateCache(reset_older_data);
   }
   updateMaximumZoomArea();
 
   updateStatistics(true);
+  _updated_source_state = currentSourceState();
+}
+
+bool PlotWidget::curvesChanged() const
+{
+  return currentSourceState() != _updated_source_state;
+}
+
+std::vector<const PlotData*> PlotWidget::dataSources() const
+{
+  std::vector<const PlotData*> sources;
+  for (const auto& it : curveList())
+  {
+    auto series = UnwrapSeries(it.curve->data());
+    if (auto ts = dynamic_cast<const TransformedTimeseries*>(series))
+    {
+      sources.push_back(ts->sourceData());
+    }
+    else if (auto xy = dynamic_cast<const PointSeriesXY*>(series))
+    {
+      sources.push_back(xy->dataX());
+      sources.push_back(xy->dataY());
+    }
+  }
+  return sources;
+}
+
+std::vector<PlotWidget::SourceState> PlotWidget::currentSourceState() const
+{
+  std::vector<SourceState> state;
+  // the revision changes with any modification, including the values overwritten in place
+  auto addSource = [&state](const PlotData* data) { state.push_back({ data, data->revision() }); };
+
+  for (const auto& it : curveList())
+  {
+    auto series = UnwrapSeries(it.curve->data());
+    if (auto ts = dynamic_cast<const TransformedTimeseries*>(series))
+    {
+      addSource(ts->sourceData());
+    }
+    else if (auto xy = dynamic_cast<const PointSeriesXY*>(series))
+    {
+      addSource(xy->dataX());
+      addSource(xy->dataY());
+    }
+    else
+    {
+      // unknown kind of series: never compares equal, it is always updated
+      state.push_back({ nullptr, 0 });
+    }
+  }
+  return state;
 }
 
 void PlotWidget::updateStatistics(bool forceUpdate)
@@ -85,6 +85,12 @@ public:
 
   void changeDots(bool force_dots);
 
+  /// Series read by the curves: the source of each timeseries, and both sources of an XY curve.
+  std::vector<const PlotData*> dataSources() const;
+
+  /// True if the series displayed by the curves changed after the last call of updateCurves().
+  bool curvesChanged() const;
+
 protected:
   PlotDataMapRef& _mapped_data;
 
@@ -245,6 +251,22 @@ private:
 
   bool _context_menu_enabled;
 
+  // series displayed and their revision, when updateCurves() was called
+  struct SourceState
+  {
+    const PlotData* data;
+    uint64_t revision;
+
+    bool operator==(const SourceState& other) const
+    {
+      return data && data == other.data && revision == other.revision;
+    }
+  };
+
+  std::vector<SourceState> currentSourceState() const;
+
+  std::vector<SourceState> _updated_source_state;
+
   // void updateMaximumZoomArea();
   void rescaleEqualAxisScaling();
 
@@ -124,7 +124,7 @@ void DialogTransformEditor::on_listCurves_itemSelectionChanged()
   auto curve_info = _plotwidget->curveFromTitle(curve_name);
 
   int transform_row = 0;
-  if (auto ts = dynamic_cast<TransformedTimeseries*>(curve_info->curve->data()))
+  if (auto ts = dynamic_cast<TransformedTimeseries*>(UnwrapSeries(curve_info->curve->data())))
   {
     if (ts->transform())
     {
@@ -199,7 +199,7 @@ void DialogTransformEditor::on_listTransforms_itemSelectionChanged()
     QString curve_name = row_widget->text();
     auto curve_info = _plotwidget->curveFromTitle(curve_name);
     auto qwt_curve = curve_info->curve;
-    ts = dynamic_cast<TransformedTimeseries*>(curve_info->curve->data());
+    ts = dynamic_cast<TransformedTimeseries*>(UnwrapSeries(curve_info->curve->data()));
 
     auto src_name = QString::fromStdString(curve_info->src_name);
     bool has_default_title =
@@ -273,7 +273,8 @@ void DialogTransformEditor::on_listTransforms_itemSelectionChanged()
               auto row_widget = dynamic_cast<RowWidget*>(ui->listCurves->itemWidget(item));
               QString curve_name = row_widget->text();
               auto curve_info = _plotwidget->curveFromTitle(curve_name);
-              auto* item_ts = dynamic_cast<TransformedTimeseries*>(curve_info->curve->data());
+              auto* item_ts =
+                  dynamic_cast<TransformedTimeseries*>(UnwrapSeries(curve_info->curve->data()));
 
               if (item_ts != ts)
               {
@@ -337,7 +338,7 @@ void DialogTransformEditor::on_lineEditAlias_editingFinished()
   QString curve_name = row_widget->text();
 
   auto curve_it = _plotwidget->curveFromTitle(curve_name);
-  auto ts = dynamic_cast<TransformedTimeseries*>(curve_it->curve->data());
+  auto ts = dynamic_cast<TransformedTimeseries*>(UnwrapSeries(curve_it->curve->data()));
 
   curve_it->curve->setTitle(ui->lineEditAlias->text());
 
@@ -5,6 +5,7 @@
  */
 
 #include "point_series_xy.h"
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 
@@ -27,11 +28,11 @@ std::optional<QPointF> PointSeriesXY::sampleFromTime(double t)
   }
 
   int index = _y_axis->getIndexFromX(t);
-  if (index < 0)
+  if (index < int(_y_first_index) || size_t(index) - _y_first_index >= _cached_curve.size())
   {
     return {};
   }
-  const auto& p = _cached_curve.at(size_t(index));
+  const auto& p = _cached_curve.at(size_t(index) - _y_first_index);
   return QPointF(p.x, p.y);
 }
 
@@ -43,6 +44,7 @@ RangeOpt PointSeriesXY::getVisualizationRangeY(Range)
 void PointSeriesXY::updateCache(bool reset_old_data)
 {
   _cached_curve.clear();
+  _y_first_index = 0;
 
   if (_x_axis == nullptr)
   {
@@ -56,6 +58,22 @@ void PointSeriesXY::updateCache(bool reset_old_data)
     return;
   }
 
+  std::ptrdiff_t offset = 0;
+  if (_x_axis->alignedWith(*_y_axis, offset))
+  {
+    // same time column: the samples are aligned by index, x doesn't need to be compared
+    const size_t first = (offset < 0) ? size_t(-offset) : 0;
+    const std::ptrdiff_t y_end = std::ptrdiff_t(_y_axis->size()) - offset;
+    const size_t last = std::min(_x_axis->size(), size_t(std::max<std::ptrdiff_t>(0, y_end)));
+    _y_first_index = size_t(std::ptrdiff_t(first) + offset);
+    for (size_t i = first; i < last; i++)
+    {
+      const size_t y_index = size_t(std::ptrdiff_t(i) + offset);
+      _cached_curve.pushBack({ _x_axis->at(i).y, _y_axis->at(y_index).y });
+    }
+    return;
+  }
+
   const double EPS = std::numeric_limits<double>::epsilon();
 
   for (size_t i = 0; i < data_size; i++)
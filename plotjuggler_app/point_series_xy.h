@@ -48,6 +48,8 @@ protected:
   const PlotData* _x_axis;
   const PlotData* _y_axis;
   PlotDataXY _cached_curve;
+  // index in _y_axis of the first sample of _cached_curve
+  size_t _y_first_index = 0;
 };
 
 #endif  // POINT_SERIES_H
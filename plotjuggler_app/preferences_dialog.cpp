@@ -35,6 +35,9 @@ PreferencesDialog::PreferencesDialog(QWidget* parent)
   bool use_opengl = settings.value("Preferences::use_opengl", true).toBool();
   ui->checkBoxOpenGL->setChecked(use_opengl);
 
+  bool threaded_rendering = settings.value("Preferences::threaded_rendering", false).toBool();
+  ui->checkBoxThreadedRendering->setChecked(threaded_rendering);
+
   int precision = settings.value("Preferences::precision", 3).toInt();
   ui->comboBoxPrecision->setCurrentIndex(precision - 1);
 
@@ -70,6 +73,12 @@ PreferencesDialog::PreferencesDialog(QWidget* parent)
   bool truncation_check = settings.value("Preferences::truncation_check", true).toBool();
   ui->checkBoxTruncation->setChecked(truncation_check);
 
+  bool lazy_fields = settings.value("Preferences::lazy_fields", false).toBool();
+  ui->checkBoxLazyFields->setChecked(lazy_fields);
+  ui->spinBoxBackfill->setValue(settings.value("Preferences::lazy_fields_backfill", 0).toInt());
+  ui->spinBoxBackfill->setEnabled(lazy_fields);
+  connect(ui->checkBoxLazyFields, &QCheckBox::toggled, ui->spinBoxBackfill, &QSpinBox::setEnabled);
+
   // Plugins
   ui->pushButtonAdd->setIcon(LoadSvg(":/resources/svg/add_tab.svg", theme));
   ui->pushButtonRemove->setIcon(LoadSvg(":/resources/svg/trash.svg", theme));
@@ -111,6 +120,8 @@ void PreferencesDialog::on_buttonBox_accepted()
   settings.setValue("Preferences::precision", ui->comboBoxPrecision->currentIndex() + 1);
   settings.setValue("Preferences::use_separator", ui->checkBoxSeparator->isChecked());
   settings.setValue("Preferences::use_opengl", ui->checkBoxOpenGL->isChecked());
+  settings.setValue("Preferences::threaded_rendering",
+                    ui->checkBoxThreadedRendering->isChecked());
   settings.setValue("Preferences::no_splash", ui->checkBoxSkipSplash->isChecked());
   settings.setValue("Preferences::autozoom_visibility",
                     ui->checkBoxAutoZoomVisibility->isChecked());
@@ -118,6 +129,8 @@ void PreferencesDialog::on_buttonBox_accepted()
   settings.setValue("Preferences::autozoom_filter_applied",
                     ui->checkBoxAutoZoomFilter->isChecked());
   settings.setValue("Preferences::truncation_check", ui->checkBoxTruncation->isChecked());
+  settings.setValue("Preferences::lazy_fields", ui->checkBoxLazyFields->isChecked());
+  settings.setValue("Preferences::lazy_fields_backfill", ui->spinBoxBackfill->value());
   settings.setValue("Preferences::export_plot_size",
                     QSize{ ui->spinBoxExportX->value(), ui->spinBoxExportY->value() });
   settings.setValue("Preferences::swap_pan_zoom", ui->checkBoxSwapPanZoom->isChecked());
@@ -0,0 +1,101 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "replot_scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+ReplotScheduler::ReplotScheduler(QObject* parent) : QObject(parent), _timer(new QTimer(this))
+{
+  _timer->setSingleShot(true);
+  connect(_timer, &QTimer::timeout, this, &ReplotScheduler::onTimeout);
+}
+
+void ReplotScheduler::setFrameBudget(int milliseconds)
+{
+  _budget_ms = std::max(1, milliseconds);
+}
+
+void ReplotScheduler::requestReplot()
+{
+  if (_frame_running)
+  {
+    // scheduled when the current frame is completed
+    _pending_request = true;
+    return;
+  }
+  if (_timer->isActive())
+  {
+    return;
+  }
+  int delay = _interval_ms;
+  if (_since_last_frame.isValid())
+  {
+    delay = std::max(0, _interval_ms - static_cast<int>(_since_last_frame.elapsed()));
+  }
+  _timer->start(delay);
+}
+
+void ReplotScheduler::cancel()
+{
+  _timer->stop();
+  _pending_request = false;
+}
+
+void ReplotScheduler::reset()
+{
+  cancel();
+  _interval_ms = MIN_INTERVAL_MS;
+  _average_frame_ms = 0.0;
+  _since_last_frame.invalidate();
+}
+
+void ReplotScheduler::onTimeout()
+{
+  _frame_running = true;
+  _pending_request = false;
+  _since_last_frame.start();
+  _frame_timer.start();
+
+  emit replotRequested();
+
+  // The widgets are painted later, when the event loop processes the update requests.
+  // A zero timer is triggered after them, including their cost in the frame time.
+  QTimer::singleShot(0, this, &ReplotScheduler::onFrameCompleted);
+}
+
+void ReplotScheduler::onFrameCompleted()
+{
+  _frame_running = false;
+  updateInterval(static_cast<double>(_frame_timer.nsecsElapsed()) * 1e-6);
+
+  if (_pending_request)
+  {
+    _pending_request = false;
+    requestReplot();
+  }
+}
+
+void ReplotScheduler::updateInterval(double frame_ms)
+{
+  if (_average_frame_ms <= 0.0)
+  {
+    _average_frame_ms = frame_ms;
+  }
+  else
+  {
+    // react quickly to slower frames, recover slowly
+    const double alpha = (frame_ms > _average_frame_ms) ? 0.5 : 0.1;
+    _average_frame_ms += alpha * (frame_ms - _average_frame_ms);
+  }
+
+  // at the fastest rate, a frame that uses the entire budget leaves the remaining part of
+  // the interval to the event loop. Slower frames get a proportionally longer interval.
+  const double interval = MIN_INTERVAL_MS * _average_frame_ms / _budget_ms;
+  _interval_ms =
+      std::clamp(static_cast<int>(std::ceil(interval)), int(MIN_INTERVAL_MS), int(MAX_INTERVAL_MS));
+}
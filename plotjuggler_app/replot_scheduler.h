@@ -0,0 +1,84 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef REPLOT_SCHEDULER_H
+#define REPLOT_SCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+/**
+ * Decides when the plots are refreshed while streaming.
+ *
+ * A frame is requested every time new data is received; replotRequested() is emitted at most
+ * once per interval. The interval adapts to the duration of the previous frames, measured
+ * until the event loop processed the resulting paint events: when a frame takes longer than
+ * the budget, the refresh rate is lowered, so that the event loop never backs up.
+ */
+class ReplotScheduler : public QObject
+{
+  Q_OBJECT
+
+public:
+  // fastest refresh rate, 25 Hz
+  static constexpr int MIN_INTERVAL_MS = 40;
+  // slowest refresh rate, reached when the frames are very expensive
+  static constexpr int MAX_INTERVAL_MS = 1000;
+
+  explicit ReplotScheduler(QObject* parent = nullptr);
+
+  /// Maximum duration of a frame before the refresh rate is lowered.
+  void setFrameBudget(int milliseconds);
+
+  int frameBudget() const
+  {
+    return _budget_ms;
+  }
+
+  /// Current interval between two frames, in milliseconds.
+  int interval() const
+  {
+    return _interval_ms;
+  }
+
+  /// Average duration of the last frames, in milliseconds.
+  double averageFrameTime() const
+  {
+    return _average_frame_ms;
+  }
+
+  /// Schedule a frame, unless one is already scheduled or running.
+  void requestReplot();
+
+  /// Discard the scheduled frame, if any (the plots were refreshed by someone else).
+  void cancel();
+
+  /// Forget the timing of the previous frames.
+  void reset();
+
+signals:
+  void replotRequested();
+
+private:
+  void onTimeout();
+
+  void onFrameCompleted();
+
+  void updateInterval(double frame_ms);
+
+  QTimer* _timer;
+  QElapsedTimer _frame_timer;
+  QElapsedTimer _since_last_frame;
+
+  int _budget_ms = 20;
+  int _interval_ms = MIN_INTERVAL_MS;
+  double _average_frame_ms = 0.0;
+  bool _frame_running = false;
+  bool _pending_request = false;
+};
+
+#endif  // REPLOT_SCHEDULER_H
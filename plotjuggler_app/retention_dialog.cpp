@@ -0,0 +1,213 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "retention_dialog.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+namespace
+{
+enum Column
+{
+  PREFIX = 0,
+  MAX_SECONDS,
+  MAX_SAMPLES,
+  MAX_MEGABYTES,
+  COLUMN_COUNT
+};
+
+constexpr double MEGABYTE = 1024.0 * 1024.0;
+
+// an empty cell means "no limit"
+QString LimitText(double value, bool limited)
+{
+  return limited ? QString::number(value) : QString();
+}
+
+double CellNumber(const QTableWidget* table, int row, int column)
+{
+  const auto item = table->item(row, column);
+  bool ok = false;
+  const double value = item ? item->text().trimmed().toDouble(&ok) : 0.0;
+  return (ok && value > 0) ? value : 0.0;
+}
+}  // namespace
+
+RetentionDialog::RetentionDialog(const PJ::RetentionRules& rules, size_t memory_budget,
+                                 QWidget* parent)
+  : QDialog(parent)
+  , _table(new QTableWidget(0, COLUMN_COUNT, this))
+  , _budget_spin(new QSpinBox(this))
+{
+  setWindowTitle(tr("Streaming buffer limits"));
+
+  _table->setHorizontalHeaderLabels(
+      { tr("Series prefix"), tr("Max seconds"), tr("Max samples"), tr("Max MB") });
+  _table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+  _table->horizontalHeader()->setSectionResizeMode(PREFIX, QHeaderView::Stretch);
+  _table->verticalHeader()->setVisible(false);
+  _table->setSelectionBehavior(QAbstractItemView::SelectRows);
+  for (const auto& rule : rules)
+  {
+    addRow(rule);
+  }
+
+  auto add_button = new QPushButton(tr("Add"), this);
+  auto remove_button = new QPushButton(tr("Remove"), this);
+  connect(add_button, &QPushButton::clicked, this, [this]() {
+    addRow({});
+    _table->editItem(_table->item(_table->rowCount() - 1, PREFIX));
+  });
+  connect(remove_button, &QPushButton::clicked, this, [this]() {
+    std::vector<int> rows;
+    for (const auto& index : _table->selectionModel()->selectedRows())
+    {
+      rows.push_back(index.row());
+    }
+    // from the last one, to keep the indices of the others valid
+    std::sort(rows.rbegin(), rows.rend());
+    for (int row : rows)
+    {
+      _table->removeRow(row);
+    }
+  });
+  auto rule_buttons = new QHBoxLayout();
+  rule_buttons->addWidget(add_button);
+  rule_buttons->addWidget(remove_button);
+  rule_buttons->addStretch();
+
+  _budget_spin->setRange(0, 1024 * 1024);
+  _budget_spin->setSuffix(" MB");
+  _budget_spin->setSpecialValueText(tr("no limit"));
+  _budget_spin->setValue(static_cast<int>(double(memory_budget) / MEGABYTE));
+  _budget_spin->setToolTip(tr("When exceeded, the oldest samples of the series that were not "
+                              "displayed for the longest time are removed"));
+  auto budget_form = new QFormLayout();
+  budget_form->addRow(tr("Memory budget of all the series:"), _budget_spin);
+
+  auto help = new QLabel(tr("The limits are applied to the series whose name starts with the "
+                            "prefix (the longest matching prefix wins), in addition to the "
+                            "buffer size. Leave a cell empty for no limit."),
+                         this);
+  help->setWordWrap(true);
+
+  auto button_box = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+  connect(button_box, &QDialogButtonBox::accepted, this, &QDialog::accept);
+  connect(button_box, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+  auto layout = new QVBoxLayout(this);
+  layout->addWidget(help);
+  layout->addWidget(_table);
+  layout->addLayout(rule_buttons);
+  layout->addLayout(budget_form);
+  layout->addWidget(button_box);
+  resize(560, 360);
+}
+
+void RetentionDialog::addRow(const PJ::RetentionRule& rule)
+{
+  const auto& policy = rule.policy;
+  const bool limited_seconds = policy.max_seconds < std::numeric_limits<double>::max();
+  const int row = _table->rowCount();
+  _table->insertRow(row);
+  _table->setItem(row, PREFIX, new QTableWidgetItem(QString::fromStdString(rule.prefix)));
+  _table->setItem(row, MAX_SECONDS,
+                  new QTableWidgetItem(LimitText(policy.max_seconds, limited_seconds)));
+  _table->setItem(row, MAX_SAMPLES,
+                  new QTableWidgetItem(LimitText(policy.max_samples, policy.max_samples > 0)));
+  const double megabytes = policy.max_bytes / MEGABYTE;
+  _table->setItem(row, MAX_MEGABYTES,
+                  new QTableWidgetItem(LimitText(megabytes, policy.max_bytes > 0)));
+}
+
+PJ::RetentionRules RetentionDialog::rules() const
+{
+  PJ::RetentionRules rules;
+  for (int row = 0; row < _table->rowCount(); row++)
+  {
+    const auto prefix_item = _table->item(row, PREFIX);
+    PJ::RetentionRule rule;
+    rule.prefix = prefix_item ? prefix_item->text().trimmed().toStdString() : std::string();
+    if (double seconds = CellNumber(_table, row, MAX_SECONDS); seconds > 0)
+    {
+      rule.policy.max_seconds = seconds;
+    }
+    rule.policy.max_samples = static_cast<size_t>(CellNumber(_table, row, MAX_SAMPLES));
+    const double megabytes = CellNumber(_table, row, MAX_MEGABYTES);
+    rule.policy.max_bytes = static_cast<size_t>(megabytes * MEGABYTE);
+    // rows without any limit are ignored
+    if (rule.policy.isLimited())
+    {
+      rules.push_back(rule);
+    }
+  }
+  return rules;
+}
+
+size_t RetentionDialog::memoryBudget() const
+{
+  return static_cast<size_t>(_budget_spin->value() * MEGABYTE);
+}
+
+QDomElement RetentionDialog::xmlSaveState(QDomDocument& doc, const PJ::RetentionRules& rules,
+                                          size_t memory_budget)
+{
+  QDomElement element = doc.createElement("streaming_retention");
+  element.setAttribute("memory_budget", QString::number(memory_budget));
+  for (const auto& rule : rules)
+  {
+    QDomElement rule_elem = doc.createElement("rule");
+    rule_elem.setAttribute("prefix", QString::fromStdString(rule.prefix));
+    if (rule.policy.max_seconds < std::numeric_limits<double>::max())
+    {
+      rule_elem.setAttribute("max_seconds", rule.policy.max_seconds);
+    }
+    if (rule.policy.max_samples > 0)
+    {
+      rule_elem.setAttribute("max_samples", QString::number(rule.policy.max_samples));
+    }
+    if (rule.policy.max_bytes > 0)
+    {
+      rule_elem.setAttribute("max_bytes", QString::number(rule.policy.max_bytes));
+    }
+    element.appendChild(rule_elem);
+  }
+  return element;
+}
+
+bool RetentionDialog::xmlLoadState(const QDomElement& element, PJ::RetentionRules& rules,
+                                   size_t& memory_budget)
+{
+  if (element.isNull())
+  {
+    return false;
+  }
+  memory_budget = element.attribute("memory_budget", "0").toULongLong();
+  rules.clear();
+  for (auto rule_elem = element.firstChildElement("rule"); !rule_elem.isNull();
+       rule_elem = rule_elem.nextSiblingElement("rule"))
+  {
+    PJ::RetentionRule rule;
+    rule.prefix = rule_elem.attribute("prefix").toStdString();
+    if (rule_elem.hasAttribute("max_seconds"))
+    {
+      rule.policy.max_seconds = rule_elem.attribute("max_seconds").toDouble();
+    }
+    rule.policy.max_samples = rule_elem.attribute("max_samples", "0").toULongLong();
+    rule.policy.max_bytes = rule_elem.attribute("max_bytes", "0").toULongLong();
+    rules.push_back(rule);
+  }
+  return true;
+}
@@ -0,0 +1,48 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RETENTION_DIALOG_H
+#define RETENTION_DIALOG_H
+
+#include <QDialog>
+#include <QDomDocument>
+#include <QSpinBox>
+#include <QTableWidget>
+#include "PlotJuggler/retention_policy.h"
+
+/**
+ * Editor of the limits of the samples kept while streaming: a policy for the series
+ * whose name starts with a given prefix (for instance a topic) and a memory budget
+ * shared by all the series.
+ */
+class RetentionDialog : public QDialog
+{
+  Q_OBJECT
+
+public:
+  RetentionDialog(const PJ::RetentionRules& rules, size_t memory_budget,
+                  QWidget* parent = nullptr);
+
+  PJ::RetentionRules rules() const;
+
+  /// In bytes, 0 means no limit.
+  size_t memoryBudget() const;
+
+  static QDomElement xmlSaveState(QDomDocument& doc, const PJ::RetentionRules& rules,
+                                  size_t memory_budget);
+
+  /// Returns false if the element is null: rules and budget are left unchanged.
+  static bool xmlLoadState(const QDomElement& element, PJ::RetentionRules& rules,
+                           size_t& memory_budget);
+
+private:
+  void addRow(const PJ::RetentionRule& rule);
+
+  QTableWidget* _table;
+  QSpinBox* _budget_spin;
+};
+
+#endif  // RETENTION_DIALOG_H
@@ -36,6 +36,27 @@ bool StatisticsDialog::calcVisibleRange()
   return (ui->rangeComboBox->currentIndex() == 0);
 }
 
+// index of the first sample with x not lower than (or greater than, if "strict") the value
+static size_t LowerBoundIndex(const QwtSeriesData<QPointF>* ts, double value, bool strict)
+{
+  size_t lo = 0;
+  size_t hi = ts->size();
+  while (lo < hi)
+  {
+    const size_t mid = (lo + hi) / 2;
+    const double x = ts->sample(mid).x();
+    if (x < value || (strict && x == value))
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
 void StatisticsDialog::update(PJ::Range range)
 {
   std::map<QString, Statistics> statistics;
@@ -45,43 +66,75 @@ void StatisticsDialog::update(PJ::Range range)
     Statistics stat;
     double start_time;
     double end_time;
-    const auto ts = info.curve->data();
-
-    bool first = true;
+    const auto ts = UnwrapSeries(info.curve->data());
+    const auto series = dynamic_cast<QwtSeriesWrapper*>(ts);
 
-    for (size_t i = 0; i < ts->size(); i++)
+    // Timeseries are sorted by time: the visible interval is found with a binary search,
+    // min, max and the sums of y are provided by the index of the series in O(log N),
+    // without visiting the samples.
+    if (series && !_parent->isXYPlot())
     {
-      const auto p = ts->sample(i);
+      size_t first_index = 0;
+      size_t end_index = ts->size();
       if (calcVisibleRange())
       {
-        if (p.x() < range.min)
-        {
-          continue;
-        }
-        if (p.x() > range.max)
-        {
-          break;
-        }
+        first_index = LowerBoundIndex(ts, range.min, false);
+        end_index = LowerBoundIndex(ts, range.max, true);
       }
-      stat.count++;
-      if (first)
+      std::optional<PJ::MinMaxIndex::Node> summary;
+      if (end_index > first_index)
       {
-        start_time = p.x();
-        end_time = p.x();
-        stat.min = p.y();
-        stat.max = p.y();
-        first = false;
+        summary = series->plotData()->summaryY(first_index, end_index - 1);
       }
-      else
+      if (summary)
+      {
+        stat.count = end_index - first_index;
+        stat.min = summary->min;
+        stat.max = summary->max;
+        stat.mean_tot = summary->sum;
+        stat.square_tot = summary->sum_squares;
+        stat.abs_tot = summary->sum_abs;
+        start_time = ts->sample(first_index).x();
+        end_time = ts->sample(end_index - 1).x();
+      }
+    }
+    else
+    {
+      bool first = true;
+      for (size_t i = 0; i < ts->size(); i++)
       {
-        start_time = std::min(start_time, p.x());
-        end_time = std::max(end_time, p.x());
-        stat.min = std::min(stat.min, p.y());
-        stat.max = std::max(stat.max, p.y());
+        const auto p = ts->sample(i);
+        if (calcVisibleRange())
+        {
+          if (p.x() < range.min)
+          {
+            continue;
+          }
+          if (p.x() > range.max)
+          {
+            break;
+          }
+        }
+        stat.count++;
+        if (first)
+        {
+          start_time = p.x();
+          end_time = p.x();
+          stat.min = p.y();
+          stat.max = p.y();
+          first = false;
+        }
+        else
+        {
+          start_time = std::min(start_time, p.x());
+          end_time = std::max(end_time, p.x());
+          stat.min = std::min(stat.min, p.y());
+          stat.max = std::max(stat.max, p.y());
+        }
+        stat.mean_tot += p.y();
+        stat.square_tot += p.y() * p.y();
+        stat.abs_tot += std::fabs(p.y());
       }
-      stat.mean_tot += p.y();
-      stat.square_tot += p.y() * p.y();
-      stat.abs_tot += std::fabs(p.y());
     }
 
     if (stat.count > 0)
@@ -0,0 +1,259 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "streaming_metrics_panel.h"
+
+#include <QFile>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSettings>
+#include <QTextStream>
+#include <QVBoxLayout>
+
+namespace
+{
+const QStringList COLUMNS = { "Category", "Name",     "Msg/s",    "Bytes/s",  "Count",
+                              "Dropped",  "p50 (us)", "p99 (us)", "Max (us)" };
+
+// the percentiles are upper limits of the buckets of the histogram
+QString PercentileText(qint64 value)
+{
+  return QString("< %1").arg(value);
+}
+}  // namespace
+
+StreamingMetricsPanel::StreamingMetricsPanel(QWidget* parent)
+  : QWidget(parent), _table(new QTableWidget(this)), _timer(new QTimer(this))
+{
+  _table->setColumnCount(COLUMNS.size());
+  _table->setHorizontalHeaderLabels(COLUMNS);
+  _table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+  _table->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+  _table->verticalHeader()->setVisible(false);
+  _table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  _table->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+  auto export_button = new QPushButton(tr("Export CSV"), this);
+  auto reset_button = new QPushButton(tr("Reset"), this);
+  reset_button->setToolTip(tr("Zero the counters of the streamer"));
+
+  auto buttons = new QHBoxLayout();
+  buttons->addStretch();
+  buttons->addWidget(reset_button);
+  buttons->addWidget(export_button);
+
+  auto layout = new QVBoxLayout(this);
+  layout->setContentsMargins(2, 2, 2, 2);
+  layout->addWidget(_table);
+  layout->addLayout(buttons);
+
+  connect(export_button, &QPushButton::clicked, this, &StreamingMetricsPanel::onExport);
+  connect(reset_button, &QPushButton::clicked, this, &StreamingMetricsPanel::onReset);
+
+  _timer->setInterval(1000);
+  connect(_timer, &QTimer::timeout, this, &StreamingMetricsPanel::refresh);
+}
+
+void StreamingMetricsPanel::setStreamer(PJ::DataStreamerPtr streamer)
+{
+  _streamer = std::move(streamer);
+  _previous.clear();
+  _since_refresh.invalidate();
+  refresh();
+}
+
+void StreamingMetricsPanel::setPlotsProvider(std::function<void(const PlotVisitor&)> provider)
+{
+  _plots_provider = std::move(provider);
+}
+
+StreamingMetricsPanel::Row StreamingMetricsPanel::latencyRow(const QString& category,
+                                                             const QString& name,
+                                                             const PJ::LatencyHistogram& latency)
+{
+  Row row;
+  row.category = category;
+  row.name = name;
+  row.count = static_cast<qint64>(latency.count());
+  if (row.count > 0)
+  {
+    row.p50 = static_cast<qint64>(latency.percentile(0.5));
+    row.p99 = static_cast<qint64>(latency.percentile(0.99));
+    row.max = static_cast<qint64>(latency.maxMicroseconds());
+  }
+  return row;
+}
+
+void StreamingMetricsPanel::refresh()
+{
+  std::vector<Row> rows;
+  if (_streamer)
+  {
+    const double elapsed_sec =
+        _since_refresh.isValid() ? static_cast<double>(_since_refresh.restart()) * 1e-3 : 0.0;
+    if (!_since_refresh.isValid())
+    {
+      _since_refresh.start();
+    }
+
+    const auto& metrics = _streamer->metrics();
+    for (const auto& [topic, counters] : metrics.topics())
+    {
+      const QString name = topic.empty() ? tr("(all)") : QString::fromStdString(topic);
+      Row row = latencyRow("topic", name, counters->parse_latency);
+      const uint64_t messages = counters->messages.load(std::memory_order_relaxed);
+      const uint64_t bytes = counters->bytes.load(std::memory_order_relaxed);
+      row.count = static_cast<qint64>(messages);
+      row.dropped = static_cast<qint64>(counters->dropped.load(std::memory_order_relaxed));
+
+      auto previous = _previous.find(topic);
+      if (elapsed_sec > 0 && previous != _previous.end() && messages >= previous->second.messages)
+      {
+        row.messages_per_sec = double(messages - previous->second.messages) / elapsed_sec;
+        row.bytes_per_sec = double(bytes - previous->second.bytes) / elapsed_sec;
+      }
+      _previous[topic] = { messages, bytes };
+      rows.push_back(row);
+    }
+
+    rows.push_back(latencyRow("stream", tr("lock wait"), metrics.lockWait()));
+    if (_streamer->doubleBuffering())
+    {
+      rows.push_back(latencyRow("stream", tr("handover"), _streamer->publishLatency()));
+    }
+    rows.push_back(latencyRow("stream", tr("merge (MoveData)"), _streamer->consumeLatency()));
+
+    Row queue;
+    queue.category = "stream";
+    queue.name = tr("pending bytes");
+    queue.count = static_cast<qint64>(metrics.pendingBytes());
+    rows.push_back(queue);
+  }
+
+  if (_plots_provider)
+  {
+    _plots_provider([&](const QString& name, const PJ::LatencyHistogram& latency) {
+      rows.push_back(latencyRow("replot", name, latency));
+    });
+  }
+  showRows(rows);
+}
+
+void StreamingMetricsPanel::showRows(const std::vector<Row>& rows)
+{
+  _table->setRowCount(static_cast<int>(rows.size()));
+  for (int r = 0; r < static_cast<int>(rows.size()); r++)
+  {
+    const Row& row = rows[r];
+    auto number = [](double value, int precision) {
+      return (value < 0) ? QString() : QString::number(value, 'f', precision);
+    };
+    const QStringList cells = { row.category,
+                                row.name,
+                                number(row.messages_per_sec, 1),
+                                number(row.bytes_per_sec, 0),
+                                number(row.count, 0),
+                                number(row.dropped, 0),
+                                row.p50 < 0 ? QString() : PercentileText(row.p50),
+                                row.p99 < 0 ? QString() : PercentileText(row.p99),
+                                number(row.max, 0) };
+    for (int c = 0; c < cells.size(); c++)
+    {
+      auto item = _table->item(r, c);
+      if (!item)
+      {
+        item = new QTableWidgetItem();
+        if (c >= 2)
+        {
+          item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        _table->setItem(r, c, item);
+      }
+      item->setText(cells[c]);
+    }
+  }
+}
+
+bool StreamingMetricsPanel::exportCsv(const QString& filename) const
+{
+  QFile file(filename);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+  {
+    return false;
+  }
+  QTextStream out(&file);
+  out << COLUMNS.join(',') << "\n";
+  for (int r = 0; r < _table->rowCount(); r++)
+  {
+    QStringList cells;
+    for (int c = 0; c < _table->columnCount(); c++)
+    {
+      const auto item = _table->item(r, c);
+      QString text = item ? item->text() : QString();
+      // numbers only: the percentiles are shown as upper limits
+      text.remove("< ");
+      if (text.contains(',') || text.contains('"'))
+      {
+        text = "\"" + text.replace("\"", "\"\"") + "\"";
+      }
+      cells.push_back(text);
+    }
+    out << cells.join(',') << "\n";
+  }
+  return true;
+}
+
+void StreamingMetricsPanel::onExport()
+{
+  QSettings settings;
+  QString directory = settings.value("StreamingMetricsPanel.exportDirectory").toString();
+  QString filename = QFileDialog::getSaveFileName(this, tr("Export streaming metrics"), directory,
+                                                  tr("CSV files (*.csv)"));
+  if (filename.isEmpty())
+  {
+    return;
+  }
+  if (!filename.endsWith(".csv"))
+  {
+    filename += ".csv";
+  }
+  refresh();
+  if (!exportCsv(filename))
+  {
+    QMessageBox::warning(this, tr("Export streaming metrics"),
+                         tr("Can't write the file %1").arg(filename));
+    return;
+  }
+  settings.setValue("StreamingMetricsPanel.exportDirectory", QFileInfo(filename).absolutePath());
+}
+
+void StreamingMetricsPanel::onReset()
+{
+  if (_streamer)
+  {
+    _streamer->metrics().reset();
+  }
+  _previous.clear();
+  _since_refresh.invalidate();
+  refresh();
+}
+
+void StreamingMetricsPanel::showEvent(QShowEvent* event)
+{
+  QWidget::showEvent(event);
+  refresh();
+  _timer->start();
+}
+
+void StreamingMetricsPanel::hideEvent(QHideEvent* event)
+{
+  QWidget::hideEvent(event);
+  _timer->stop();
+}
@@ -0,0 +1,91 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef STREAMING_METRICS_PANEL_H
+#define STREAMING_METRICS_PANEL_H
+
+#include <functional>
+#include <map>
+#include <vector>
+#include <QElapsedTimer>
+#include <QTableWidget>
+#include <QTimer>
+#include <QWidget>
+#include "PlotJuggler/datastreamer_base.h"
+
+/**
+ * Table with the metrics of the active streamer, refreshed once per second while visible:
+ * rate of the messages of each topic, time spent parsing them, waiting for the mutex,
+ * merging the data into the main application and painting each plot.
+ */
+class StreamingMetricsPanel : public QWidget
+{
+  Q_OBJECT
+
+public:
+  // name of a plot and time spent painting it
+  using PlotVisitor = std::function<void(const QString&, const PJ::LatencyHistogram&)>;
+
+  explicit StreamingMetricsPanel(QWidget* parent = nullptr);
+
+  /// Streamer whose metrics are shown. They are kept after it is stopped.
+  void setStreamer(PJ::DataStreamerPtr streamer);
+
+  /// Function that calls the visitor for each plot.
+  void setPlotsProvider(std::function<void(const PlotVisitor&)> provider);
+
+  /// Write the current content of the table. Returns false if the file can't be written.
+  bool exportCsv(const QString& filename) const;
+
+public slots:
+  void refresh();
+
+protected:
+  void showEvent(QShowEvent* event) override;
+
+  void hideEvent(QHideEvent* event) override;
+
+private:
+  struct Row
+  {
+    QString category;
+    QString name;
+    // negative when not applicable
+    double messages_per_sec = -1;
+    double bytes_per_sec = -1;
+    qint64 count = -1;
+    qint64 dropped = -1;
+    // percentiles and maximum of the durations, in microseconds
+    qint64 p50 = -1;
+    qint64 p99 = -1;
+    qint64 max = -1;
+  };
+
+  static Row latencyRow(const QString& category, const QString& name,
+                        const PJ::LatencyHistogram& latency);
+
+  void showRows(const std::vector<Row>& rows);
+
+  void onExport();
+
+  void onReset();
+
+  QTableWidget* _table;
+  QTimer* _timer;
+  PJ::DataStreamerPtr _streamer;
+  std::function<void(const PlotVisitor&)> _plots_provider;
+
+  // counters of the previous refresh, to compute the rates
+  struct Counters
+  {
+    uint64_t messages = 0;
+    uint64_t bytes = 0;
+  };
+  std::map<std::string, Counters> _previous;
+  QElapsedTimer _since_refresh;
+};
+
+#endif  // STREAMING_METRICS_PANEL_H
@@ -85,6 +85,7 @@ TabbedPlotWidget::TabbedPlotWidget(QString name, QMainWindow* mainwindow,
   connect(this, &TabbedPlotWidget::destroyed, main_window, &MainWindow::on_tabbedAreaDestroyed);
   connect(this, &TabbedPlotWidget::tabAdded, main_window, &MainWindow::onPlotTabAdded);
   connect(this, &TabbedPlotWidget::undoableChange, main_window, &MainWindow::onUndoableChange);
+  connect(_tabWidget, &QTabWidget::currentChanged, main_window, &MainWindow::onPlotTabChanged);
 
   // TODO connect(_tabWidget, &TabWidget::movingPlotWidgetToTab, this,
   // &TabbedPlotWidget::onMoveWidgetIntoNewTab);
@@ -0,0 +1,515 @@
+#include "nlohmann_parsers.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+using Format = json::input_format_t;
+
+namespace
+{
+// samples stored by a parser, by series name
+struct Flattened
+{
+  std::map<std::string, std::vector<std::pair<double, double>>> numeric;
+  std::map<std::string, std::vector<std::pair<double, std::vector<float>>>> arrays;
+};
+
+/*
+ * The flattener used before NlohmannParser::Flattener, that builds the DOM of the
+ * message first. NlohmannParser must store exactly the same samples.
+ */
+class DomFlattener
+{
+public:
+  DomFlattener(std::string topic, bool use_stamp, std::string stamp_fieldname,
+               unsigned max_array_size)
+    : _topic(std::move(topic))
+    , _use_message_stamp(use_stamp)
+    , _stamp_fieldname(std::move(stamp_fieldname))
+    , _max_array_size(max_array_size)
+  {
+  }
+
+  bool parse(const std::vector<uint8_t>& msg, Format format, double& timestamp)
+  {
+    json value;
+    switch (format)
+    {
+      case Format::json:
+        value = json::parse(msg.begin(), msg.end());
+        break;
+      case Format::msgpack:
+        value = json::from_msgpack(msg.begin(), msg.end());
+        break;
+      default:
+        value = json::from_cbor(msg.begin(), msg.end());
+        break;
+    }
+    flattenMessage(value, timestamp);
+    return true;
+  }
+
+  const Flattened& output() const
+  {
+    return _output;
+  }
+
+private:
+  std::string _topic;
+  bool _use_message_stamp;
+  std::string _stamp_fieldname;
+  unsigned _max_array_size;
+  Flattened _output;
+
+  static bool IsNumericArray(const json& array)
+  {
+    for (const auto& element : array)
+    {
+      if (!element.is_number() && !element.is_boolean())
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void flattenMessage(json& message, double& timestamp)
+  {
+    // a batch: each element is a message
+    if (message.is_array())
+    {
+      json array = std::move(message);
+      for (auto& element : array)
+      {
+        flattenMessage(element, timestamp);
+      }
+      return;
+    }
+
+    if (_use_message_stamp && !_stamp_fieldname.empty())
+    {
+      auto ts = message.find(_stamp_fieldname);
+      if (ts != message.end() && ts.value().is_number())
+      {
+        timestamp = ts.value().get<double>();
+      }
+      else
+      {
+        _use_message_stamp = false;
+      }
+    }
+    flatten(_topic, message, timestamp);
+  }
+
+  void flatten(const std::string& prefix, const json& value, double timestamp)
+  {
+    if (value.empty())
+    {
+      return;
+    }
+    if (value.is_array())
+    {
+      if (value.size() > _max_array_size && IsNumericArray(value))
+      {
+        std::vector<float> values;
+        for (const auto& element : value)
+        {
+          values.push_back(element.is_boolean() ? element.get<bool>() : element.get<double>());
+        }
+        _output.arrays[prefix].push_back({ timestamp, values });
+        return;
+      }
+      for (size_t i = 0; i < value.size(); i++)
+      {
+        flatten(prefix + "[" + std::to_string(i) + "]", value[i], timestamp);
+      }
+    }
+    else if (value.is_object())
+    {
+      for (const auto& element : value.items())
+      {
+        flatten(prefix + "/" + element.key(), element.value(), timestamp);
+      }
+    }
+    else if (value.is_boolean() || value.is_number())
+    {
+      const double number = value.is_boolean() ? value.get<bool>() : value.get<double>();
+      _output.numeric[prefix].push_back({ timestamp, number });
+    }
+  }
+};
+
+Flattened Collect(const PlotDataMapRef& data)
+{
+  Flattened out;
+  for (const auto& [name, series] : data.numeric)
+  {
+    for (size_t i = 0; i < series.size(); i++)
+    {
+      out.numeric[name].push_back({ series[i].x, series[i].y });
+    }
+  }
+  for (const auto& [name, series] : data.arrays)
+  {
+    for (size_t i = 0; i < series.size(); i++)
+    {
+      const auto& array = series[i].y;
+      std::vector<float> values;
+      for (size_t j = 0; j < array.size(); j++)
+      {
+        values.push_back(array[j]);
+      }
+      out.arrays[name].push_back({ series[i].x, values });
+    }
+  }
+  return out;
+}
+
+std::vector<uint8_t> Serialize(const json& value, Format format)
+{
+  switch (format)
+  {
+    case Format::json: {
+      const std::string text = value.dump();
+      return std::vector<uint8_t>(text.begin(), text.end());
+    }
+    case Format::msgpack:
+      return json::to_msgpack(value);
+    default:
+      return json::to_cbor(value);
+  }
+}
+
+const char* FormatName(Format format)
+{
+  switch (format)
+  {
+    case Format::json:
+      return "json";
+    case Format::msgpack:
+      return "msgpack";
+    default:
+      return "cbor";
+  }
+}
+
+// parses the same messages with NlohmannParser and DomFlattener
+class Parity
+{
+public:
+  static constexpr unsigned MAX_ARRAY_SIZE = 8;
+
+  Parity(Format format, bool use_stamp, bool clamp_large_arrays = false)
+    : _format(format)
+    , _reference("topic", use_stamp, "t", clamp_large_arrays ? ~0u : MAX_ARRAY_SIZE)
+  {
+    switch (format)
+    {
+      case Format::json:
+        _parser = std::make_unique<JSON_Parser>("topic", _data, use_stamp, "t");
+        break;
+      case Format::msgpack:
+        _parser = std::make_unique<MessagePack_Parser>("topic", _data, use_stamp, "t");
+        break;
+      default:
+        _parser = std::make_unique<CBOR_Parser>("topic", _data, use_stamp, "t");
+        break;
+    }
+    _parser->setLargeArraysPolicy(clamp_large_arrays, MAX_ARRAY_SIZE);
+  }
+
+  void parse(const json& message, double timestamp)
+  {
+    parseRaw(Serialize(message, _format), timestamp);
+  }
+
+  void parseRaw(const std::vector<uint8_t>& msg, double timestamp)
+  {
+    SCOPED_TRACE(FormatName(_format));
+    double reference_timestamp = timestamp;
+    bool reference_ok = false;
+    try
+    {
+      reference_ok = _reference.parse(msg, _format, reference_timestamp);
+    }
+    catch (std::exception&)
+    {
+      EXPECT_ANY_THROW(_parser->parseMessage(MessageRef(msg), timestamp));
+      return;
+    }
+    EXPECT_EQ(_parser->parseMessage(MessageRef(msg), timestamp), reference_ok);
+    EXPECT_EQ(timestamp, reference_timestamp);
+  }
+
+  void expectSameSamples()
+  {
+    SCOPED_TRACE(FormatName(_format));
+    // the series keep their samples sorted by time
+    Flattened reference = _reference.output();
+    SortByTime(reference.numeric);
+    SortByTime(reference.arrays);
+
+    const Flattened flattened = Collect(_data);
+    EXPECT_EQ(flattened.numeric, reference.numeric);
+    EXPECT_EQ(flattened.arrays, reference.arrays);
+  }
+
+  const PlotDataMapRef& data() const
+  {
+    return _data;
+  }
+
+private:
+  template <typename SeriesMap>
+  static void SortByTime(SeriesMap& series_map)
+  {
+    for (auto& [name, samples] : series_map)
+    {
+      std::stable_sort(samples.begin(), samples.end(),
+                       [](const auto& a, const auto& b) { return a.first < b.first; });
+    }
+  }
+
+  Format _format;
+  PlotDataMapRef _data;
+  std::unique_ptr<NlohmannParser> _parser;
+  DomFlattener _reference;
+};
+
+const Format FORMATS[] = { Format::json, Format::msgpack, Format::cbor };
+
+json RandomValue(std::mt19937& rng, int depth)
+{
+  std::uniform_int_distribution<int> kind(0, depth > 2 ? 5 : 8);
+  switch (kind(rng))
+  {
+    case 0:
+      return std::uniform_int_distribution<int>(-1000, 1000)(rng);
+    case 1:
+    case 2:
+      return std::uniform_real_distribution<double>(-1e6, 1e6)(rng);
+    case 3:
+      return bool(rng() % 2);
+    case 4:
+      return nullptr;
+    case 5:
+      return "text";
+    case 6: {
+      // numbers only (also longer than MAX_ARRAY_SIZE) or mixed values
+      json array = json::array();
+      const bool numbers_only = rng() % 2;
+      const size_t size = rng() % (2 * Parity::MAX_ARRAY_SIZE);
+      for (size_t i = 0; i < size; i++)
+      {
+        array.push_back(numbers_only ? json(double(rng() % 100)) : RandomValue(rng, depth + 1));
+      }
+      return array;
+    }
+    default: {
+      json object = json::object();
+      const size_t size = rng() % 5;
+      for (size_t i = 0; i < size; i++)
+      {
+        object["field_" + std::to_string(rng() % 8)] = RandomValue(rng, depth + 1);
+      }
+      return object;
+    }
+  }
+}
+
+json RandomMessage(std::mt19937& rng)
+{
+  json message = json::object();
+  const size_t size = 1 + rng() % 6;
+  for (size_t i = 0; i < size; i++)
+  {
+    message["field_" + std::to_string(rng() % 8)] = RandomValue(rng, 0);
+  }
+  // the timestamp is almost always there
+  if (rng() % 50 != 0)
+  {
+    message["t"] = double(rng() % 100000) * 0.001;
+  }
+  return message;
+}
+}  // namespace
+
+TEST(NlohmannParser, Message)
+{
+  const json message = {
+    { "position", { { "x", 1.5 }, { "y", -2 }, { "valid", true } } },
+    { "name", "robot" },
+    { "nothing", nullptr },
+    { "empty", json::object() },
+    { "no_values", json::array() },
+    { "mixed", { 1, "two", 3.5, false, nullptr, { { "a", 4 } }, { 5, 6 } } },
+  };
+  for (Format format : FORMATS)
+  {
+    Parity parity(format, false);
+    parity.parse(message, 1.0);
+    parity.parse(message, 2.0);
+    parity.parse(42, 3.0);
+    parity.expectSameSamples();
+    EXPECT_EQ(parity.data().numeric.at("topic/position/x").size(), 2u);
+  }
+}
+
+TEST(NlohmannParser, Batch)
+{
+  const json batch = json::array({
+      { { "t", 1.0 }, { "a", 1 }, { "b", { 1, 2 } } },
+      { { "t", 2.0 }, { "a", 2 } },
+      json::array({ { { "t", 3.0 }, { "a", 3 } }, { { "t", 4.0 }, { "a", 4 } } }),
+      json::array(),
+  });
+  for (Format format : FORMATS)
+  {
+    Parity parity(format, true);
+    parity.parse(batch, 0.0);
+    parity.parse({ { "t", 5.0 }, { "a", 5 } }, 0.0);
+    parity.expectSameSamples();
+    EXPECT_EQ(parity.data().numeric.at("topic/a").size(), 5u);
+    EXPECT_EQ(parity.data().numeric.at("topic/a")[3].x, 4.0);
+  }
+}
+
+TEST(NlohmannParser, NestedRootArrays)
+{
+  const json batch = json::array({ json::array({ 1, 2 }), 3, json::array({ json::array({ 4 }) }),
+                                   { { "a", 5 } }, "text" });
+  for (Format format : FORMATS)
+  {
+    Parity parity(format, false);
+    parity.parse(batch, 1.0);
+    parity.expectSameSamples();
+    EXPECT_EQ(parity.data().numeric.at("topic").size(), 4u);
+  }
+}
+
+TEST(NlohmannParser, StampAfterTheOtherFields)
+{
+  for (Format format : FORMATS)
+  {
+    Parity parity(format, true);
+    // the keys of the DOM are sorted: "t" is the last one also in MessagePack and CBOR
+    const std::string text = R"({"a": 1, "b": {"t": 7, "c": [1, 2]}, "t": 5.5})";
+    if (format == Format::json)
+    {
+      parity.parseRaw(std::vector<uint8_t>(text.begin(), text.end()), 0.0);
+    }
+    else
+    {
+      parity.parse(json::parse(text), 0.0);
+    }
+    parity.parse({ { "a", 2 }, { "t", 6.5 } }, 0.0);
+    parity.expectSameSamples();
+    EXPECT_EQ(parity.data().numeric.at("topic/a")[0].x, 5.5);
+    EXPECT_EQ(parity.data().numeric.at("topic/a")[1].x, 6.5);
+  }
+}
+
+TEST(NlohmannParser, StampDisabledInTheBatch)
+{
+  const json batch = json::array({
+      { { "t", 1.0 }, { "a", 1 } },
+      { { "a", 2 } },
+      { { "t", 3.0 }, { "a", 3 } },
+  });
+  for (Format format : FORMATS)
+  {
+    Parity parity(format, true);
+    parity.parse(batch, 10.0);
+    // the timestamp field is not used anymore
+    parity.parse({ { "t", 4.0 }, { "a", 4 } }, 20.0);
+    parity.parse({ { "t", "not a number" }, { "a", 5 } }, 30.0);
+    parity.expectSameSamples();
+    EXPECT_EQ(parity.data().numeric.at("topic/a")[2].x, 1.0);
+    EXPECT_EQ(parity.data().numeric.at("topic/a")[3].x, 20.0);
+  }
+}
+
+TEST(NlohmannParser, MalformedMessageStoresNothing)
+{
+  const json message = json::array({
+      { { "t", 1.0 }, { "a", 1 }, { "b", { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 } } },
+      { { "t", 2.0 }, { "a", 2 }, { "c", 3 } },
+  });
+  for (Format format : FORMATS)
+  {
+    Parity parity(format, true);
+    const auto bytes = Serialize(message, format);
+    for (size_t size = 1; size < bytes.size(); size += 3)
+    {
+      parity.parseRaw(std::vector<uint8_t>(bytes.begin(), bytes.begin() + size), 0.0);
+    }
+    EXPECT_TRUE(parity.data().numeric.empty());
+    EXPECT_TRUE(parity.data().arrays.empty());
+    parity.expectSameSamples();
+
+    // and the timestamp field is still used
+    parity.parse(message, 0.0);
+    parity.expectSameSamples();
+    EXPECT_EQ(parity.data().numeric.at("topic/c")[0].x, 2.0);
+  }
+}
+
+TEST(NlohmannParser, LargeNumericArrays)
+{
+  const json message = {
+    { "ranges", { 1, 2.5, 3, true, 5, 6, 7, 8, 9 } },
+    { "small", { 1, 2, 3, 4, 5, 6, 7, 8 } },
+    { "mixed", { 1, 2, 3, 4, 5, 6, 7, 8, "nine" } },
+    { "nested", { { 1, 2 }, 3, 4, 5, 6, 7, 8, 9 } },
+    { "inner", { { "values", { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 } } } },
+  };
+  for (bool clamp : { false, true })
+  {
+    for (Format format : FORMATS)
+    {
+      Parity parity(format, false, clamp);
+      parity.parse(message, 1.0);
+      parity.parse(message, 2.0);
+      parity.expectSameSamples();
+      EXPECT_EQ(parity.data().arrays.count("topic/ranges"), clamp ? 0u : 1u);
+      EXPECT_EQ(parity.data().arrays.count("topic/inner/values"), clamp ? 0u : 1u);
+      EXPECT_EQ(parity.data().numeric.count("topic/small[7]"), 1u);
+      EXPECT_EQ(parity.data().numeric.count("topic/mixed[7]"), 1u);
+      EXPECT_EQ(parity.data().numeric.count("topic/nested[0][1]"), 1u);
+    }
+  }
+}
+
+TEST(NlohmannParser, RandomMessages)
+{
+  std::mt19937 rng(1234);
+  for (Format format : FORMATS)
+  {
+    for (bool use_stamp : { false, true })
+    {
+      Parity parity(format, use_stamp);
+      for (int i = 0; i < 300; i++)
+      {
+        if (i % 10 == 0)
+        {
+          json batch = json::array();
+          const size_t size = rng() % 4;
+          for (size_t j = 0; j < size; j++)
+          {
+            batch.push_back(RandomMessage(rng));
+          }
+          parity.parse(batch, i);
+        }
+        else
+        {
+          parity.parse(RandomMessage(rng), i);
+        }
+      }
+      parity.expectSameSamples();
+    }
+  }
+}
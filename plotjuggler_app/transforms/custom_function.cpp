@@ -1,6 +1,7 @@
 #include "custom_function.h"
 
 #include <limits>
+#include <optional>
 #include <QFile>
 #include <QMessageBox>
 #include <QElapsedTimer>
@@ -57,7 +58,7 @@ void CustomFunction::calculateAndAdd(PlotDataMapRef& src_data)
   {
     if (newly_added)
     {
-      plotData()->numeric.erase(dst_data_it);
+      plotData()->erase(_plot_name);
     }
     std::rethrow_exception(std::current_exception());
   }
@@ -72,53 +73,70 @@ void CustomFunction::calculate()
 {
   auto dst_data = _dst_vector.front();
 
-  // Find main source — numeric or string
-  const PlotData* numeric_main = nullptr;
-  const StringSeries* string_main = nullptr;
-
-  auto num_it = plotData()->numeric.find(_linked_plot_name);
-  if (num_it != plotData()->numeric.end())
-  {
-    numeric_main = &num_it->second;
-  }
-  else
-  {
-    auto str_it = plotData()->strings.find(_linked_plot_name);
+  // Find a source by name — numeric, string or array. The element of an array, as
+  // "scan/ranges[3]", is created if needed.
+  auto FindSource = [this](const std::string& name) -> std::optional<MixedSource> {
+    if (const PlotData* numeric = plotData()->materializeArrayElement(name))
+    {
+      return MixedSource(numeric);
+    }
+    auto str_it = plotData()->strings.find(name);
     if (str_it != plotData()->strings.end())
     {
-      string_main = &str_it->second;
+      return MixedSource(&str_it->second);
     }
-  }
+    auto array_it = plotData()->arrays.find(name);
+    if (array_it != plotData()->arrays.end())
+    {
+      return MixedSource(&array_it->second);
+    }
+    return std::nullopt;
+  };
 
-  if (!numeric_main && !string_main)
+  const auto main_found = FindSource(_linked_plot_name);
+  if (!main_found)
   {
     return;  // source not found, keep output empty
   }
+  const MixedSource& main_src = *main_found;
 
-  const MixedSource main_src = numeric_main ? MixedSource(numeric_main) : MixedSource(string_main);
-
-  // Build additional sources — any mix of numeric and string
+  // Build additional sources — any mix of numeric, string and array
   std::vector<MixedSource> additional_src;
   for (const auto& channel : _used_channels)
   {
-    auto num_add = plotData()->numeric.find(channel);
-    if (num_add != plotData()->numeric.end())
+    auto source = FindSource(channel);
+    if (!source)
     {
-      additional_src.emplace_back(&num_add->second);
-      continue;
+      throw std::runtime_error("Invalid channel name: " + channel);
     }
-    auto str_add = plotData()->strings.find(channel);
-    if (str_add != plotData()->strings.end())
+    additional_src.push_back(*source);
+  }
+
+  auto MainX = [&main_src](size_t i) {
+    if (main_src.is_array)
     {
-      additional_src.emplace_back(&str_add->second);
-      continue;
+      return main_src.array->at(i).x;
     }
-    throw std::runtime_error("Invalid channel name: " + channel);
-  }
+    return main_src.is_string ? main_src.str->at(i).x : main_src.numeric->at(i).x;
+  };
 
-  const size_t main_size = main_src.is_string ? main_src.str->size() : main_src.numeric->size();
-  const double max_range =
-      main_src.is_string ? main_src.str->maximumRangeX() : main_src.numeric->maximumRangeX();
+  size_t main_size = 0;
+  double max_range = 0;
+  if (main_src.is_array)
+  {
+    main_size = main_src.array->size();
+    max_range = main_src.array->maximumRangeX();
+  }
+  else if (main_src.is_string)
+  {
+    main_size = main_src.str->size();
+    max_range = main_src.str->maximumRangeX();
+  }
+  else
+  {
+    main_size = main_src.numeric->size();
+    max_range = main_src.numeric->maximumRangeX();
+  }
 
   dst_data->setMaximumRangeX(max_range);
 
@@ -131,7 +149,7 @@ void CustomFunction::calculate()
   std::vector<PlotData::Point> points;
   for (size_t i = 0; i < main_size; ++i)
   {
-    const double t = main_src.is_string ? main_src.str->at(i).x : main_src.numeric->at(i).x;
+    const double t = MainX(i);
     if (t > last_updated_stamp)
     {
       points.clear();
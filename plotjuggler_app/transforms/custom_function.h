@@ -8,6 +8,7 @@
 #include <QDomDocument>
 #include <QString>
 #include "PlotJuggler/plotdata.h"
+#include "PlotJuggler/series_cursor.h"
 #include "PlotJuggler/transform_function.h"
 
 using namespace PJ;
@@ -19,15 +20,38 @@ typedef std::shared_ptr<CustomFunction> CustomPlotPtr;
 struct MixedSource
 {
   bool is_string;
+  bool is_array = false;
   const PlotData* numeric = nullptr;
   const StringSeries* str = nullptr;
+  const ArraySeries* array = nullptr;
 
-  explicit MixedSource(const PlotData* p) : is_string(false), numeric(p)
+  explicit MixedSource(const PlotData* p) : is_string(false), numeric(p), numeric_cursor(p)
   {
   }
-  explicit MixedSource(const StringSeries* s) : is_string(true), str(s)
+  explicit MixedSource(const StringSeries* s) : is_string(true), str(s), str_cursor(s)
   {
   }
+  // the whole array is passed to the function, as a table (Lua) or a list (Python)
+  explicit MixedSource(const ArraySeries* a)
+    : is_string(false), is_array(true), array(a), array_cursor(a)
+  {
+  }
+
+  // Index of the sample closest to "time", or -1 if empty.
+  // The points of the main source are visited in order: the cursor makes it O(1) amortized.
+  int indexFromX(double time) const
+  {
+    if (is_array)
+    {
+      return array_cursor.indexFromX(time);
+    }
+    return is_string ? str_cursor.indexFromX(time) : numeric_cursor.indexFromX(time);
+  }
+
+private:
+  mutable SeriesCursor<double> numeric_cursor;
+  mutable SeriesCursor<StringDictIndex> str_cursor;
+  mutable SeriesCursor<ArrayRef> array_cursor;
 };
 
 struct SnippetData
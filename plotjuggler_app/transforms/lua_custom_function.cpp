@@ -108,7 +108,16 @@ void LuaCustomFunction::calculatePoints(const MixedSource& main_src,
   args.reserve(2 + additional_src.size());
 
   double time;
-  if (main_src.is_string)
+  if (main_src.is_array)
+  {
+    const auto& p = main_src.array->at(point_index);
+    time = p.x;
+    auto values = p.y.values();
+    std::vector<float> val(values.begin(), values.end());
+    args.push_back(sol::make_object(_lua_engine, time));
+    args.push_back(sol::make_object(_lua_engine, sol::as_table(std::move(val))));
+  }
+  else if (main_src.is_string)
   {
     time = main_src.str->at(point_index).x;
     std::string val(main_src.str->getString(main_src.str->at(point_index).y));
@@ -125,16 +134,27 @@ void LuaCustomFunction::calculatePoints(const MixedSource& main_src,
 
   for (const auto& src : additional_src)
   {
-    if (src.is_string)
+    if (src.is_array)
+    {
+      int idx = src.indexFromX(time);
+      std::vector<float> val;
+      if (idx != -1)
+      {
+        auto values = src.array->at(idx).y.values();
+        val.assign(values.begin(), values.end());
+      }
+      args.push_back(sol::make_object(_lua_engine, sol::as_table(std::move(val))));
+    }
+    else if (src.is_string)
     {
-      int idx = src.str->getIndexFromX(time);
+      int idx = src.indexFromX(time);
       std::string val =
           (idx != -1) ? std::string(src.str->getString(src.str->at(idx).y)) : std::string();
       args.push_back(sol::make_object(_lua_engine, val));
     }
     else
     {
-      int idx = src.numeric->getIndexFromX(time);
+      int idx = src.indexFromX(time);
       double val = (idx != -1) ? src.numeric->at(idx).y : std::numeric_limits<double>::quiet_NaN();
       args.push_back(sol::make_object(_lua_engine, val));
     }
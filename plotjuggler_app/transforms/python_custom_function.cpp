@@ -529,6 +529,17 @@ void PythonCustomFunction::parsePythonResult(PyObject* result, double time,
                            "or an array of two-sized arrays (time, value)");
 }
 
+// New reference to a list with the values of the array.
+static PyObject* ArrayToList(const ArrayRef& array)
+{
+  PyObject* list = PyList_New((Py_ssize_t)array.size());
+  for (size_t i = 0; i < array.size(); i++)
+  {
+    PyList_SET_ITEM(list, (Py_ssize_t)i, PyFloat_FromDouble(array[i]));
+  }
+  return list;
+}
+
 void PythonCustomFunction::calculatePoints(const MixedSource& main_src,
                                            const std::vector<MixedSource>& additional_src,
                                            size_t point_index, std::vector<PlotData::Point>& points)
@@ -551,7 +562,14 @@ void PythonCustomFunction::calculatePoints(const MixedSource& main_src,
   double time;
   PyObject* args = PyTuple_New(2 + (int)additional_src.size());
 
-  if (main_src.is_string)
+  if (main_src.is_array)
+  {
+    const auto& p = main_src.array->at(point_index);
+    time = p.x;
+    PyTuple_SetItem(args, 0, PyFloat_FromDouble(time));
+    PyTuple_SetItem(args, 1, ArrayToList(p.y));
+  }
+  else if (main_src.is_string)
   {
     time = main_src.str->at(point_index).x;
     std::string val(main_src.str->getString(main_src.str->at(point_index).y));
@@ -569,16 +587,21 @@ void PythonCustomFunction::calculatePoints(const MixedSource& main_src,
   for (int i = 0; i < (int)additional_src.size(); i++)
   {
     const auto& src = additional_src[i];
-    if (src.is_string)
+    if (src.is_array)
+    {
+      int idx = src.indexFromX(time);
+      PyTuple_SetItem(args, 2 + i, ArrayToList(idx != -1 ? src.array->at(idx).y : ArrayRef()));
+    }
+    else if (src.is_string)
     {
-      int idx = src.str->getIndexFromX(time);
+      int idx = src.indexFromX(time);
       std::string val =
           (idx != -1) ? std::string(src.str->getString(src.str->at(idx).y)) : std::string();
       PyTuple_SetItem(args, 2 + i, PyUnicode_FromStringAndSize(val.data(), (Py_ssize_t)val.size()));
     }
     else
     {
-      int idx = src.numeric->getIndexFromX(time);
+      int idx = src.indexFromX(time);
       double val = (idx != -1) ? src.numeric->at(idx).y : std::numeric_limits<double>::quiet_NaN();
       PyTuple_SetItem(args, 2 + i, PyFloat_FromDouble(val));
     }
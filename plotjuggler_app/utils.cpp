@@ -16,6 +16,7 @@ void MergeData(TimeseriesBase<Value>& src_plot, TimeseriesBase<Value>& dst_plot)
   static_assert(!std::is_same_v<Value, StringDictIndex>,
                 "Use the MergeData(StringSeries&, StringSeries&) overload for StringSeries");
 
+  src_plot.flushLateSamples();
   if (src_plot.size() == 0)
   {
     return;
@@ -30,27 +31,28 @@ void MergeData(TimeseriesBase<Value>& src_plot, TimeseriesBase<Value>& dst_plot)
   if (dst_plot.size() == src_plot.size() && isEqual(dst_plot.back().x, src_plot.back().x) &&
       isEqual(dst_plot.front().x, src_plot.front().x))
   {
-    bool need_sorting = false;
+    std::vector<double> new_x;
+    std::vector<Value> new_y;
+    // read through const references: only y is written, explicitly
+    const auto& src_const = src_plot;
+    const auto& dst_const = dst_plot;
     for (size_t i = 0; i < src_plot.size(); i++)
     {
-      auto& src_point = src_plot[i];
-      auto& dst_point = dst_plot[i];
-      if (isEqual(src_point.x, dst_point.x))
+      const auto& src_point = src_const[i];
+      if (isEqual(src_point.x, dst_const[i].x))
       {
         // update only
-        dst_point.y = src_point.y;
+        dst_plot.setY(i, src_point.y);
       }
       else
       {
-        dst_plot.pushUnsorted(std::move(src_point));
-        need_sorting = true;
+        new_x.push_back(src_point.x);
+        new_y.push_back(src_point.y);
       }
     }
     src_plot.clear();
-    if (need_sorting)
-    {
-      dst_plot.sort();
-    }
+    // sorted, merged from the oldest one
+    dst_plot.pushBackBatch(new_x, new_y);
     return;
   }
 
@@ -59,7 +61,7 @@ void MergeData(TimeseriesBase<Value>& src_plot, TimeseriesBase<Value>& dst_plot)
   {
     for (size_t i = 0; i < src_plot.size(); i++)
     {
-      dst_plot.pushBack(std::move(src_plot.at(i)));
+      dst_plot.pushBack(std::as_const(src_plot).at(i));
     }
     src_plot.clear();
     return;
@@ -71,18 +73,27 @@ void MergeData(TimeseriesBase<Value>& src_plot, TimeseriesBase<Value>& dst_plot)
     dst_plot.swapData(src_plot);
     for (size_t i = 0; i < src_plot.size(); i++)
     {
-      dst_plot.pushBack(std::move(src_plot.at(i)));
+      dst_plot.pushBack(std::as_const(src_plot).at(i));
     }
     src_plot.clear();
     return;
   }
-  // LAST CASE: merging
-  for (size_t i = 0; i < src_plot.size(); i++)
+  // LAST CASE: merging. The samples of src_plot are sorted: they are merged in place,
+  // together with the late samples pending in dst_plot, rewriting only the samples of
+  // dst_plot newer than the first of them
+  std::vector<double> xs;
+  std::vector<Value> ys;
+  xs.reserve(src_plot.size());
+  ys.reserve(src_plot.size());
+  for (size_t c = 0; c < src_plot.chunkCount(); c++)
   {
-    dst_plot.pushUnsorted(std::move(src_plot.at(i)));
+    const auto chunk_x = src_plot.chunkX(c);
+    const auto chunk_y = src_plot.chunkY(c);
+    xs.insert(xs.end(), chunk_x.begin(), chunk_x.end());
+    ys.insert(ys.end(), chunk_y.begin(), chunk_y.end());
   }
-  dst_plot.sort();
   src_plot.clear();
+  dst_plot.pushBackBatch(xs, ys);
 }
 
 void MergeData(PlotDataXY& src_plot, PlotDataXY& dst_plot)
@@ -92,7 +103,7 @@ void MergeData(PlotDataXY& src_plot, PlotDataXY& dst_plot)
     dst_plot.swapData(src_plot);
     return;
   }
-  for (const auto& p : src_plot)
+  for (const auto& p : std::as_const(src_plot))
   {
     dst_plot.pushBack(p);
   }
@@ -101,6 +112,7 @@ void MergeData(PlotDataXY& src_plot, PlotDataXY& dst_plot)
 
 void MergeData(StringSeries& src_plot, StringSeries& dst_plot)
 {
+  src_plot.flushLateSamples();
   if (src_plot.size() == 0)
   {
     return;
@@ -112,91 +124,157 @@ void MergeData(StringSeries& src_plot, StringSeries& dst_plot)
   }
   for (size_t i = 0; i < src_plot.size(); i++)
   {
-    auto& pt = src_plot.at(i);
+    const auto& pt = std::as_const(src_plot).at(i);
     auto str = src_plot.getString(pt.y);
     dst_plot.pushBack({ pt.x, str });
   }
   src_plot.clear();
 }
 
+void MergeData(ArraySeries& src_plot, ArraySeries& dst_plot)
+{
+  // the elements listed so far must stay listed
+  dst_plot.expandWidth(src_plot.width());
+  MergeData<ArrayRef>(src_plot, dst_plot);
+}
+
 MoveDataRet MoveData(PlotDataMapRef& source, PlotDataMapRef& destination, bool remove_older)
 {
   MoveDataRet ret;
 
-  auto moveDataImpl = [&](auto& source_series, auto& destination_series) {
-    for (auto& [source_ID, source_plot] : source_series)
+  auto moveSeries = [&](const std::string& source_ID, auto& source_plot,
+                        auto& destination_series) {
+    const std::string& plot_name = source_plot.plotName();
+
+    auto dest_plot_it = destination_series.find(source_ID);
+    if (dest_plot_it == destination_series.end())
     {
-      const std::string& plot_name = source_plot.plotName();
+      ret.added_curves.push_back(source_ID);
 
-      auto dest_plot_it = destination_series.find(source_ID);
-      if (dest_plot_it == destination_series.end())
+      PlotGroup::Ptr group;
+      if (source_plot.group())
       {
-        ret.added_curves.push_back(source_ID);
-
-        PlotGroup::Ptr group;
-        if (source_plot.group())
-        {
-          destination.getOrCreateGroup(source_plot.group()->name());
-        }
-        dest_plot_it = destination_series
-                           .emplace(std::piecewise_construct, std::forward_as_tuple(source_ID),
-                                    std::forward_as_tuple(plot_name, group))
-                           .first;
-        ret.curves_updated = true;
+        destination.getOrCreateGroup(source_plot.group()->name());
       }
+      dest_plot_it = destination_series
+                         .emplace(std::piecewise_construct, std::forward_as_tuple(source_ID),
+                                  std::forward_as_tuple(plot_name, group))
+                         .first;
+      ret.curves_updated = true;
+    }
 
-      auto& destination_plot = dest_plot_it->second;
-      PlotGroup::Ptr destination_group = destination_plot.group();
+    auto& destination_plot = dest_plot_it->second;
+    PlotGroup::Ptr destination_group = destination_plot.group();
 
-      // copy plot attributes
-      for (const auto& [name, attr] : source_plot.attributes())
+    // copy plot attributes
+    for (const auto& [name, attr] : source_plot.attributes())
+    {
+      if (destination_plot.attribute(name) != attr)
       {
-        if (destination_plot.attribute(name) != attr)
-        {
-          destination_plot.setAttribute(name, attr);
-          ret.curves_updated = true;
-        }
+        destination_plot.setAttribute(name, attr);
+        ret.curves_updated = true;
       }
-      // Copy the group name and attributes
-      if (source_plot.group())
+    }
+    // Copy the group name and attributes
+    if (source_plot.group())
+    {
+      if (!destination_group || destination_group->name() != source_plot.group()->name())
       {
-        if (!destination_group || destination_group->name() != source_plot.group()->name())
-        {
-          destination_group = destination.getOrCreateGroup(source_plot.group()->name());
-          destination_plot.changeGroup(destination_group);
-        }
+        destination_group = destination.getOrCreateGroup(source_plot.group()->name());
+        destination_plot.changeGroup(destination_group);
+      }
 
-        for (const auto& [name, attr] : source_plot.group()->attributes())
+      for (const auto& [name, attr] : source_plot.group()->attributes())
+      {
+        if (destination_group->attribute(name) != attr)
         {
-          if (destination_group->attribute(name) != attr)
-          {
-            destination_group->setAttribute(name, attr);
-            ret.curves_updated = true;
-          }
+          destination_group->setAttribute(name, attr);
+          ret.curves_updated = true;
         }
       }
+    }
 
-      if (remove_older)
-      {
-        destination_plot.clear();
-      }
+    if (remove_older)
+    {
+      destination_plot.clear();
+    }
 
-      if constexpr (std::is_same_v<PlotData, decltype(source_plot)> ||
-                    std::is_same_v<StringSeries, decltype(source_plot)> ||
-                    std::is_same_v<PlotDataAny, decltype(source_plot)>)
+    using SeriesType = std::remove_reference_t<decltype(source_plot)>;
+    if constexpr (std::is_same_v<PlotData, SeriesType> ||
+                  std::is_same_v<StringSeries, SeriesType> ||
+                  std::is_same_v<PlotDataAny, SeriesType> ||
+                  std::is_same_v<ArraySeries, SeriesType>)
+    {
+      double max_range_x = source_plot.maximumRangeX();
+      destination_plot.setMaximumRangeX(max_range_x);
+      if (destination_plot.retentionPolicy() != source_plot.retentionPolicy())
       {
-        double max_range_x = source_plot.maximumRangeX();
-        destination_plot.setMaximumRangeX(max_range_x);
+        destination_plot.setRetentionPolicy(source_plot.retentionPolicy());
       }
-      MergeData(source_plot, destination_plot);
+    }
+    MergeData(source_plot, destination_plot);
+  };
+
+  auto moveDataImpl = [&](auto& source_series, auto& destination_series) {
+    for (auto& [source_ID, source_plot] : source_series)
+    {
+      moveSeries(source_ID, source_plot, destination_series);
+    }
+  };
+
+  // visit only the series that changed since the previous call
+  auto moveChangedImpl = [&](const std::string& source_ID, auto& source_series,
+                             auto& destination_series) {
+    auto it = source_series.find(source_ID);
+    if (it != source_series.end())
+    {
+      moveSeries(source_ID, it->second, destination_series);
     }
   };
 
   //--------------------------------------------
+  if (source.dirtySet() && !remove_older)
+  {
+    const DirtySet::Changes changes = source.dirtySet()->drain();
+    for (const auto& name : changes.series)
+    {
+      moveChangedImpl(name, source.numeric, destination.numeric);
+      moveChangedImpl(name, source.strings, destination.strings);
+      moveChangedImpl(name, source.scatter_xy, destination.scatter_xy);
+      moveChangedImpl(name, source.user_defined, destination.user_defined);
+      moveChangedImpl(name, source.arrays, destination.arrays);
+    }
+    // groups whose attributes changed, without new samples in their series
+    for (const auto& name : changes.groups)
+    {
+      auto source_group = source.groups.find(name);
+      auto destination_group = destination.groups.find(name);
+      if (source_group == source.groups.end() || destination_group == destination.groups.end())
+      {
+        continue;
+      }
+      for (const auto& [attr_name, attr] : source_group->second->attributes())
+      {
+        if (destination_group->second->attribute(attr_name) != attr)
+        {
+          destination_group->second->setAttribute(attr_name, attr);
+          ret.curves_updated = true;
+        }
+      }
+    }
+    return ret;
+  }
+
+  if (source.dirtySet())
+  {
+    // all the series are visited anyway
+    source.dirtySet()->drain();
+  }
   moveDataImpl(source.numeric, destination.numeric);
   moveDataImpl(source.strings, destination.strings);
   moveDataImpl(source.scatter_xy, destination.scatter_xy);
   moveDataImpl(source.user_defined, destination.user_defined);
+  moveDataImpl(source.arrays, destination.arrays);
 
   return ret;
 }
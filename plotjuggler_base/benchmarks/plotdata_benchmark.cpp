@@ -0,0 +1,125 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+#include <limits>
+#include <random>
+
+#include "PlotJuggler/plotdata.h"
+
+using namespace PJ;
+
+// Streaming buffer: each new sample evicts the oldest one, then the range is requested,
+// as done by the GUI at each replot. The cost per sample should not depend on the
+// length of the buffer, when range tracking is enabled.
+static void StreamingRange(benchmark::State& state, bool tracking)
+{
+  const size_t buffer_size = static_cast<size_t>(state.range(0));
+  const double period = 0.001;
+
+  PlotData data("benchmark", {});
+  data.setMaximumRangeX(static_cast<double>(buffer_size - 1) * period);
+  data.setRangeTracking(tracking);
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> noise(-1.0, 1.0);
+
+  // a slow drift: the oldest sample is often the min or the max of the buffer
+  double t = 0;
+  auto nextPoint = [&]() {
+    t += period;
+    return PlotData::Point(t, t + noise(rng));
+  };
+
+  for (size_t i = 0; i < buffer_size; i++)
+  {
+    data.pushBack(nextPoint());
+  }
+
+  for (auto _ : state)
+  {
+    data.pushBack(nextPoint());
+    benchmark::DoNotOptimize(data.rangeX());
+    benchmark::DoNotOptimize(data.rangeY());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_StreamingRange_FullScan(benchmark::State& state)
+{
+  StreamingRange(state, false);
+}
+
+static void BM_StreamingRange_Tracking(benchmark::State& state)
+{
+  StreamingRange(state, true);
+}
+
+BENCHMARK(BM_StreamingRange_FullScan)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+BENCHMARK(BM_StreamingRange_Tracking)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+// Two publishers with the same rate, one of them delayed: every other sample is late.
+// The data is read (and the late samples merged) every 30 samples, as the GUI does.
+static void LateSamples(benchmark::State& state, double reorder_window)
+{
+  const double delay = static_cast<double>(state.range(0)) * 0.001;
+  const double period = 0.001;
+
+  for (auto _ : state)
+  {
+    PlotData data("benchmark", {});
+    data.setReorderWindow(reorder_window);
+    for (int i = 0; i < 100000; i++)
+    {
+      const double t = i * period;
+      data.pushBack({ t, 1.0 });
+      data.pushBack({ t - delay, 2.0 });
+      if (i % 30 == 0)
+      {
+        data.flushLateSamples();
+      }
+    }
+    data.flushLateSamples();
+    benchmark::DoNotOptimize(data.size());
+  }
+  state.SetItemsProcessed(state.iterations() * 200000);
+}
+
+static void BM_LateSamples_Insert(benchmark::State& state)
+{
+  LateSamples(state, 0.0);
+}
+
+static void BM_LateSamples_ReorderWindow(benchmark::State& state)
+{
+  LateSamples(state, std::numeric_limits<double>::max());
+}
+
+BENCHMARK(BM_LateSamples_Insert)->RangeMultiplier(10)->Range(10, 10000);
+BENCHMARK(BM_LateSamples_ReorderWindow)->RangeMultiplier(10)->Range(10, 10000);
+
+// A reader takes a snapshot of a series that keeps receiving samples, as done
+// by a thread that needs a consistent view of the data.
+static void BM_Snapshot(benchmark::State& state)
+{
+  const int size = static_cast<int>(state.range(0));
+  PlotData data("benchmark", {});
+  for (int i = 0; i < size; i++)
+  {
+    data.pushBack({ i * 0.001, 1.0 });
+  }
+  int count = size;
+  for (auto _ : state)
+  {
+    PlotData snapshot("snapshot", {});
+    snapshot.clonePoints(data);
+    data.pushBack({ count * 0.001, 1.0 });
+    count++;
+    benchmark::DoNotOptimize(snapshot.size());
+  }
+}
+
+BENCHMARK(BM_Snapshot)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
@@ -0,0 +1,250 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_ARRAYSERIES_H
+#define PJ_ARRAYSERIES_H
+
+#include "PlotJuggler/timeseries.h"
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace PJ
+{
+/**
+ * @brief Value of a sample of ArraySeries: a contiguous array of floats.
+ *
+ * The floats are stored in a block of ArrayArena shared with other samples; copying an
+ * ArrayRef doesn't copy them, and the block is released when no sample refers to it anymore.
+ * Once written, the values are never modified: they can be read by another thread,
+ * for instance after PlotDataMapRef::snapshot().
+ */
+class ArrayRef
+{
+public:
+  ArrayRef() = default;
+
+  ArrayRef(std::shared_ptr<const float> data, uint32_t size) : _data(std::move(data)), _size(size)
+  {
+  }
+
+  Span<const float> values() const
+  {
+    return { _data.get(), _size };
+  }
+
+  size_t size() const
+  {
+    return _size;
+  }
+
+  bool empty() const
+  {
+    return _size == 0;
+  }
+
+  float operator[](size_t index) const
+  {
+    return _data.get()[index];
+  }
+
+private:
+  // aliasing pointer: it points to the first value and owns the whole block
+  std::shared_ptr<const float> _data;
+  uint32_t _size = 0;
+};
+
+/**
+ * @brief Allocator of the values of ArraySeries: arrays are appended one after the other
+ * in large blocks, instead of allocating each of them separately.
+ */
+class ArrayArena
+{
+public:
+  /// Floats of a block. Larger arrays get a block of their own.
+  static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+  /// Reserve "count" floats. They must be written through "data" before sharing the ArrayRef.
+  ArrayRef allocate(size_t count, float*& data)
+  {
+    if (count > _capacity - _used)
+    {
+      // a large array would waste the rest of a new block
+      const size_t capacity = (count > BLOCK_SIZE / 4) ? count : BLOCK_SIZE;
+      std::shared_ptr<float[]> block(new float[capacity]);
+      if (count > BLOCK_SIZE / 4)
+      {
+        data = block.get();
+        return { std::shared_ptr<const float>(block, block.get()), static_cast<uint32_t>(count) };
+      }
+      _block = std::move(block);
+      _capacity = capacity;
+      _used = 0;
+    }
+    data = _block.get() + _used;
+    _used += count;
+    return { std::shared_ptr<const float>(_block, data), static_cast<uint32_t>(count) };
+  }
+
+private:
+  std::shared_ptr<float[]> _block;
+  size_t _capacity = 0;
+  size_t _used = 0;
+};
+
+/**
+ * @brief Timeseries whose samples are arrays of numbers, for instance the ranges of a
+ * LaserScan or a spectrum. Large arrays are stored this way by the parsers, instead of
+ * creating a numeric series for each element.
+ *
+ * The numeric series of a single element, named as ArrayElementName(), is created only when
+ * needed, see PlotDataMapRef::materializeArrayElement().
+ */
+class ArraySeries : public TimeseriesBase<ArrayRef>
+{
+public:
+  using TimeseriesBase<ArrayRef>::_points;
+  using TimeseriesBase<ArrayRef>::pushBack;
+
+  ArraySeries(const std::string& name, PlotGroup::Ptr group)
+    : TimeseriesBase<ArrayRef>(name, group)
+  {
+  }
+
+  ArraySeries(const ArraySeries& other) = delete;
+  ArraySeries(ArraySeries&& other) = default;
+
+  ArraySeries& operator=(const ArraySeries& other) = delete;
+  ArraySeries& operator=(ArraySeries&& other) = default;
+
+  /// Copy the values into the arena and append the sample. T is any numeric type.
+  template <typename T>
+  void pushBack(double timestamp, Span<const T> values)
+  {
+    float* data = nullptr;
+    ArrayRef array = _arena.allocate(values.size(), data);
+    std::copy(values.begin(), values.end(), data);
+    pushBack(Point(timestamp, std::move(array)));
+  }
+
+  void pushBack(Point&& p) override
+  {
+    _width = std::max(_width, p.y.size());
+    TimeseriesBase<ArrayRef>::pushBack(std::move(p));
+  }
+
+  void pushBack(const Point& p) override
+  {
+    auto temp = p;
+    pushBack(std::move(temp));
+  }
+
+  /// Size of the largest array stored so far, even if it was removed:
+  /// the number of elements that are listed.
+  size_t width() const
+  {
+    return _width;
+  }
+
+  void expandWidth(size_t width)
+  {
+    _width = std::max(_width, width);
+  }
+
+  /// Element "index" of the sample "sample_index", if the array is large enough.
+  std::optional<float> element(size_t sample_index, size_t index) const
+  {
+    const ArraySeries& self = *this;
+    const auto& array = self.at(sample_index).y;
+    if (index >= array.size())
+    {
+      return std::nullopt;
+    }
+    return array[index];
+  }
+
+  /// Append to "out" the element "index" of the samples starting from "first_sample".
+  /// Samples without that element are skipped.
+  template <typename Series>
+  void appendElement(size_t index, size_t first_sample, Series& out) const
+  {
+    const ArraySeries& self = *this;
+    for (size_t i = first_sample; i < self.size(); i++)
+    {
+      const auto& p = self.at(i);
+      if (index < p.y.size())
+      {
+        out.pushBack({ p.x, static_cast<double>(p.y[index]) });
+      }
+    }
+  }
+
+  /// Memory used by the samples, including the values of the arrays. O(N).
+  size_t memoryUsage() const
+  {
+    size_t bytes = _points.memoryUsage();
+    const ArraySeries& self = *this;
+    for (size_t i = 0; i < self.size(); i++)
+    {
+      bytes += self.at(i).y.size() * sizeof(float);
+    }
+    return bytes;
+  }
+
+  void clonePoints(const ArraySeries& other)
+  {
+    expandWidth(other._width);
+    PlotDataBase<double, ArrayRef>::clonePoints(other);
+  }
+
+  void swapData(ArraySeries& other)
+  {
+    TimeseriesBase<ArrayRef>::swapData(other);
+    std::swap(_width, other._width);
+  }
+
+private:
+  ArrayArena _arena;
+  size_t _width = 0;
+};
+
+/// Name of the numeric series of an element of an array, for instance "scan/ranges[3]".
+inline std::string ArrayElementName(const std::string& array_name, size_t index)
+{
+  return array_name + "[" + std::to_string(index) + "]";
+}
+
+/// Inverse of ArrayElementName(). False if "name" doesn't end with an index.
+inline bool SplitArrayElementName(const std::string& name, std::string& array_name,
+                                  size_t& index)
+{
+  if (name.size() < 3 || name.back() != ']')
+  {
+    return false;
+  }
+  const size_t open = name.rfind('[');
+  if (open == std::string::npos || open == 0 || open + 1 >= name.size() - 1)
+  {
+    return false;
+  }
+  size_t value = 0;
+  for (size_t i = open + 1; i < name.size() - 1; i++)
+  {
+    if (name[i] < '0' || name[i] > '9')
+    {
+      return false;
+    }
+    value = value * 10 + static_cast<size_t>(name[i] - '0');
+  }
+  array_name = name.substr(0, open);
+  index = value;
+  return true;
+}
+
+}  // namespace PJ
+
+#endif  // PJ_ARRAYSERIES_H
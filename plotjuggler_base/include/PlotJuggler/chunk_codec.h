@@ -0,0 +1,347 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_CHUNK_CODEC_H
+#define PJ_CHUNK_CODEC_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "PlotJuggler/contrib/span.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace PJ
+{
+/**
+ * @brief Lossless compression of a sequence of samples (x, y) of type double,
+ * inspired by Gorilla (Pelkonen et al., "Gorilla: A Fast, Scalable, In-Memory
+ * Time Series Database", VLDB 2015).
+ *
+ * - x is stored as delta-of-delta of its 64-bit representation: when the
+ *   sampling period is regular, a sample needs only one or a few bits.
+ * - y is XOR-ed with the previous value and only the bits that changed are
+ *   stored: a repeated value needs a single bit, values with few significant
+ *   digits (integers, values that were originally float) need a few bits.
+ */
+class ChunkCodec
+{
+public:
+  static void encode(nonstd::span<const double> x, nonstd::span<const double> y,
+                     std::vector<uint64_t>& out)
+  {
+    BitWriter writer(out);
+    TimestampState state_x;
+    ValueState state_y;
+    for (size_t i = 0; i < x.size(); i++)
+    {
+      writeTimestamp(writer, state_x, toBits(x[i]), i == 0);
+      writeValue(writer, state_y, toBits(y[i]), i == 0);
+    }
+    out.shrink_to_fit();
+  }
+
+  /// "x" and "y" must have space for "count" values
+  static void decode(const std::vector<uint64_t>& in, size_t count, double* x, double* y)
+  {
+    BitReader reader(in);
+    TimestampState state_x;
+    ValueState state_y;
+    for (size_t i = 0; i < count; i++)
+    {
+      x[i] = fromBits(readTimestamp(reader, state_x, i == 0));
+      y[i] = fromBits(readValue(reader, state_y, i == 0));
+    }
+  }
+
+  /// Same as encode(), for the y values only (the x values are stored elsewhere)
+  static void encodeValues(nonstd::span<const double> y, std::vector<uint64_t>& out)
+  {
+    BitWriter writer(out);
+    ValueState state_y;
+    for (size_t i = 0; i < y.size(); i++)
+    {
+      writeValue(writer, state_y, toBits(y[i]), i == 0);
+    }
+    out.shrink_to_fit();
+  }
+
+  /// "y" must have space for "count" values
+  static void decodeValues(const std::vector<uint64_t>& in, size_t count, double* y)
+  {
+    BitReader reader(in);
+    ValueState state_y;
+    for (size_t i = 0; i < count; i++)
+    {
+      y[i] = fromBits(readValue(reader, state_y, i == 0));
+    }
+  }
+
+private:
+  class BitWriter
+  {
+  public:
+    BitWriter(std::vector<uint64_t>& words) : _words(words)
+    {
+      _words.clear();
+    }
+
+    // append the "bits" least significant bits of value. bits must be in [1, 64]
+    void write(uint64_t value, unsigned bits)
+    {
+      if (bits < 64)
+      {
+        value &= (uint64_t(1) << bits) - 1;
+      }
+      const unsigned offset = _bit_count & 63;
+      if (offset == 0)
+      {
+        _words.push_back(value);
+      }
+      else
+      {
+        _words.back() |= value << offset;
+        if (offset + bits > 64)
+        {
+          _words.push_back(value >> (64 - offset));
+        }
+      }
+      _bit_count += bits;
+    }
+
+  private:
+    std::vector<uint64_t>& _words;
+    size_t _bit_count = 0;
+  };
+
+  class BitReader
+  {
+  public:
+    BitReader(const std::vector<uint64_t>& words) : _words(words)
+    {
+    }
+
+    uint64_t read(unsigned bits)
+    {
+      const size_t word = _bit_pos >> 6;
+      const unsigned offset = _bit_pos & 63;
+      uint64_t value = _words[word] >> offset;
+      if (offset + bits > 64)
+      {
+        value |= _words[word + 1] << (64 - offset);
+      }
+      if (bits < 64)
+      {
+        value &= (uint64_t(1) << bits) - 1;
+      }
+      _bit_pos += bits;
+      return value;
+    }
+
+  private:
+    const std::vector<uint64_t>& _words;
+    size_t _bit_pos = 0;
+  };
+
+  struct TimestampState
+  {
+    uint64_t prev = 0;
+    uint64_t prev_delta = 0;
+  };
+
+  struct ValueState
+  {
+    uint64_t prev = 0;
+    unsigned prev_leading = 64;
+    unsigned prev_trailing = 0;
+  };
+
+  //----- x: delta of delta, zigzag encoded -----
+  static void writeTimestamp(BitWriter& writer, TimestampState& state, uint64_t curr, bool first)
+  {
+    if (first)
+    {
+      writer.write(curr, 64);
+      state.prev = curr;
+      return;
+    }
+    const uint64_t delta = curr - state.prev;
+    const uint64_t dod = zigzag(static_cast<int64_t>(delta - state.prev_delta));
+    if (dod == 0)
+    {
+      writer.write(0b0, 1);
+    }
+    else if (dod < (uint64_t(1) << 7))
+    {
+      writer.write(0b01, 2);
+      writer.write(dod, 7);
+    }
+    else if (dod < (uint64_t(1) << 16))
+    {
+      writer.write(0b011, 3);
+      writer.write(dod, 16);
+    }
+    else if (dod < (uint64_t(1) << 36))
+    {
+      writer.write(0b0111, 4);
+      writer.write(dod, 36);
+    }
+    else
+    {
+      writer.write(0b1111, 4);
+      writer.write(dod, 64);
+    }
+    state.prev_delta = delta;
+    state.prev = curr;
+  }
+
+  static uint64_t readTimestamp(BitReader& reader, TimestampState& state, bool first)
+  {
+    if (first)
+    {
+      state.prev = reader.read(64);
+      return state.prev;
+    }
+    uint64_t dod = 0;
+    if (reader.read(1) != 0)
+    {
+      if (reader.read(1) == 0)
+      {
+        dod = reader.read(7);
+      }
+      else if (reader.read(1) == 0)
+      {
+        dod = reader.read(16);
+      }
+      else
+      {
+        dod = reader.read(reader.read(1) == 0 ? 36 : 64);
+      }
+    }
+    state.prev_delta += static_cast<uint64_t>(unzigzag(dod));
+    state.prev += state.prev_delta;
+    return state.prev;
+  }
+
+  //----- y: XOR with the previous value -----
+  static void writeValue(BitWriter& writer, ValueState& state, uint64_t curr, bool first)
+  {
+    if (first)
+    {
+      writer.write(curr, 64);
+      state.prev = curr;
+      return;
+    }
+    const uint64_t xor_y = curr ^ state.prev;
+    state.prev = curr;
+    if (xor_y == 0)
+    {
+      writer.write(0b0, 1);
+      return;
+    }
+    const unsigned leading = std::min(31u, countLeadingZeros(xor_y));
+    const unsigned trailing = countTrailingZeros(xor_y);
+    if (state.prev_leading < 64 && leading >= state.prev_leading &&
+        trailing >= state.prev_trailing)
+    {
+      // the meaningful bits fit in the same window of the previous value
+      writer.write(0b01, 2);
+      writer.write(xor_y >> state.prev_trailing, 64 - state.prev_leading - state.prev_trailing);
+    }
+    else
+    {
+      const unsigned length = 64 - leading - trailing;
+      writer.write(0b11, 2);
+      writer.write(leading, 5);
+      writer.write(length - 1, 6);
+      writer.write(xor_y >> trailing, length);
+      state.prev_leading = leading;
+      state.prev_trailing = trailing;
+    }
+  }
+
+  static uint64_t readValue(BitReader& reader, ValueState& state, bool first)
+  {
+    if (first)
+    {
+      state.prev = reader.read(64);
+      return state.prev;
+    }
+    if (reader.read(1) != 0)
+    {
+      if (reader.read(1) == 0)
+      {
+        state.prev ^= reader.read(64 - state.prev_leading - state.prev_trailing)
+                      << state.prev_trailing;
+      }
+      else
+      {
+        const unsigned leading = static_cast<unsigned>(reader.read(5));
+        const unsigned length = static_cast<unsigned>(reader.read(6)) + 1;
+        state.prev_trailing = 64 - leading - length;
+        state.prev_leading = leading;
+        state.prev ^= reader.read(length) << state.prev_trailing;
+      }
+    }
+    return state.prev;
+  }
+
+  static uint64_t toBits(double value)
+  {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  static double fromBits(uint64_t bits)
+  {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  static uint64_t zigzag(int64_t value)
+  {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+  }
+
+  static int64_t unzigzag(uint64_t value)
+  {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+
+  // value must not be zero
+  static unsigned countLeadingZeros(uint64_t value)
+  {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_clzll(value));
+#endif
+  }
+
+  // value must not be zero
+  static unsigned countTrailingZeros(uint64_t value)
+  {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+  }
+};
+
+}  // namespace PJ
+
+#endif  // PJ_CHUNK_CODEC_H
@@ -7,11 +7,19 @@
 #ifndef DATA_STREAMER_TEMPLATE_H
 #define DATA_STREAMER_TEMPLATE_H
 
+#include <atomic>
+#include <functional>
 #include <mutex>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include "PlotJuggler/plotdata.h"
+#include "PlotJuggler/latency_histogram.h"
+#include "PlotJuggler/stream_metrics.h"
 #include "PlotJuggler/pj_plugin.h"
 #include "PlotJuggler/messageparser_base.h"
+#include "PlotJuggler/message_recorder.h"
 
 namespace PJ
 {
@@ -21,12 +29,21 @@ namespace PJ
  * Important. To avoid problems with thread safety, ANY update to
  * dataMap(), which share its elements with the main application, must be protected
  * using the mutex().
+ *
+ * Alternatively, with setDoubleBuffering(), the main application never locks the mutex():
+ * the thread that receives the data writes into dataMap() and hands the new samples
+ * over with publishData(), that never waits for the main application.
  */
 class DataStreamer : public PlotJugglerPlugin
 {
   Q_OBJECT
 public:
-  DataStreamer() = default;
+  DataStreamer()
+  {
+    // the main application moves only the series that changed
+    _data_map.enableDirtyTracking();
+    _handoff.enableDirtyTracking();
+  }
 
   virtual ~DataStreamer() = default;
 
@@ -66,6 +83,61 @@ public:
 
   void setMaximumRangeX(double range);
 
+  /**
+   * @brief Give a copy of each message parsed by parseMessageWithMetrics() to the recorder,
+   * or stop doing it if nullptr. The topic and the schema are those of the parser.
+   */
+  void setRecorder(MessageRecorder::Ptr recorder);
+
+  /**
+   * @brief Enable the "lazy fields" mode (see FieldDemand) in the parsers used by
+   * parseMessageWithMetrics(), or disable it if nullptr.
+   */
+  void setFieldDemand(FieldDemand::Ptr demand);
+
+  /// See PlotDataMapRef::setRetentionRules(). The policies are moved with the samples
+  /// into the map of the main application.
+  void setRetentionRules(const RetentionRules& rules);
+
+  /**
+   * @brief Used by the main application to take the data received since the previous call.
+   *
+   * By default, mutex() is locked and "consume" is called with dataMap().
+   * With double buffering, "consume" is called with the data handed over by publishData(),
+   * if any, and the mutex is not locked. Returns false if "consume" was not called.
+   * "consume" is expected to move the samples out of the map.
+   */
+  bool consumeData(const std::function<void(PlotDataMapRef&)>& consume);
+
+  bool doubleBuffering() const
+  {
+    return _double_buffering;
+  }
+
+  /// Time spent by publishData(): the only time the receiving thread spends for the handover.
+  const LatencyHistogram& publishLatency() const
+  {
+    return _publish_latency;
+  }
+
+  /// Time spent by the main application in consumeData(). Without double buffering,
+  /// the receiving thread can be blocked for the same time, because the mutex is locked.
+  const LatencyHistogram& consumeLatency() const
+  {
+    return _consume_latency;
+  }
+
+  /// Metrics of the data received, updated by parseMessageWithMetrics() and lockMutex().
+  StreamMetrics& metrics()
+  {
+    return _metrics;
+  }
+
+  const StreamMetrics& metrics() const
+  {
+    return _metrics;
+  }
+
   PlotDataMapRef& dataMap()
   {
     return _data_map;
@@ -100,9 +172,86 @@ signals:
   // PJ modifies the "notifications" button to indicate whether there are any
   void notificationsChanged(int active_notification_count);
 
+protected:
+  /**
+   * @brief Enable double buffering (see publishData()). Must be called before
+   * the data is received, typically in start().
+   */
+  void setDoubleBuffering(bool enable)
+  {
+    _double_buffering = enable;
+  }
+
+  /**
+   * @brief With double buffering, hand the samples written so far in dataMap() over to the
+   * main application. If it didn't take the previous ones yet, nothing happens: the samples
+   * will be handed over by a later call. In both cases, it never waits.
+   *
+   * It must be called with the same synchronization used for the writes into dataMap(),
+   * typically after each message. It must also be called when no message arrives for a while
+   * (see hasPendingData()), otherwise the last samples would never be handed over.
+   *
+   * @return true if some data was handed over: dataReceived() should be emitted.
+   */
+  bool publishData();
+
+  /**
+   * @brief With double buffering, true if some data written into dataMap() was not
+   * handed over yet, or the main application did not take the last data handed over.
+   * Must be called with the same synchronization used for the writes into dataMap().
+   */
+  bool hasPendingData() const;
+
+  /// Lock mutex(), recording the time spent waiting in metrics().lockWait().
+  std::unique_lock<std::mutex> lockMutex();
+
+  /**
+   * @brief Same as parser.parseMessage(), but the message is also counted in the metrics
+   * of the topic of the parser, with its size and the time spent parsing it.
+   * A message that the parser does not accept (it returns false or throws) is counted
+   * as dropped; the exception is propagated.
+   */
+  bool parseMessageWithMetrics(MessageParser& parser, const MessageRef& msg, double& timestamp);
+
+  /**
+   * @brief Same as factory.createParser(), but the schema is also stored in the parser
+   * (see MessageParser::schema()), to record the messages.
+   * If schema.encoding is empty, it is the first encoding of the factory.
+   */
+  MessageParserPtr createParser(ParserFactoryPlugin& factory, const std::string& topic_name,
+                                MessageSchema schema = {});
+
 private:
   std::mutex _mutex;
   PlotDataMapRef _data_map;
+
+  // double buffering: _data_map is written by the receiving thread, _handoff is the copy
+  // taken by the main application. _handoff_state tells which thread owns _handoff
+  enum HandoffState
+  {
+    HANDOFF_FREE,
+    HANDOFF_READY,
+    HANDOFF_CONSUMING
+  };
+  bool _double_buffering = false;
+  PlotDataMapRef _handoff;
+  std::atomic<int> _handoff_state = HANDOFF_FREE;
+  // series that could not be handed over by the last publishData()
+  std::vector<std::string> _handoff_retry;
+
+  LatencyHistogram _publish_latency;
+  LatencyHistogram _consume_latency;
+  StreamMetrics _metrics;
+
+  FieldDemand::Ptr _field_demand;
+
+  MessageRecorder::Ptr _recorder;
+  // id given by _recorder to each topic
+  std::unordered_map<std::string, uint32_t> _recorded_topics;
+
+  void recordMessage(const MessageParser& parser, const MessageRef& msg, double receive_time,
+                     double timestamp);
+
   QAction* _start_streamer;
   ParserFactories* _parser_factories = nullptr;
 };
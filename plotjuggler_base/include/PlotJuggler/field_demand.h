@@ -0,0 +1,81 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_FIELD_DEMAND_H
+#define PJ_FIELD_DEMAND_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace PJ
+{
+/**
+ * @brief The series whose samples must be stored, in "lazy fields" mode
+ * (see DataStreamer::setFieldDemand()): usually the ones that are plotted, used by a
+ * transform or selected by the user.
+ *
+ * The parsers that support this mode (see MessageParser::supportsLazyFields()) still create
+ * all the series, so that the full list of fields is shown, but leave the others empty.
+ *
+ * Written by the main application, read by the thread that receives the data.
+ */
+class FieldDemand
+{
+public:
+  using Ptr = std::shared_ptr<FieldDemand>;
+
+  /// Replace the requested series. generation() changes only if they are different.
+  void setRequested(std::unordered_set<std::string> names)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (names != _requested)
+    {
+      _requested = std::move(names);
+      _generation.fetch_add(1, std::memory_order_release);
+    }
+  }
+
+  std::unordered_set<std::string> requested() const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _requested;
+  }
+
+  /// Incremented every time the requested series change.
+  uint64_t generation() const
+  {
+    return _generation.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Number of raw messages kept by each parser. When a series is requested for
+   * the first time, it is filled with the samples of those messages, instead of starting
+   * empty. 0 (default) to disable.
+   */
+  void setBackfillMessages(size_t count)
+  {
+    _backfill_messages.store(count, std::memory_order_relaxed);
+  }
+
+  size_t backfillMessages() const
+  {
+    return _backfill_messages.load(std::memory_order_relaxed);
+  }
+
+private:
+  mutable std::mutex _mutex;
+  std::unordered_set<std::string> _requested;
+  std::atomic<uint64_t> _generation = 1;
+  std::atomic<size_t> _backfill_messages = 0;
+};
+
+}  // namespace PJ
+
+#endif  // PJ_FIELD_DEMAND_H
@@ -0,0 +1,107 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_LATENCY_HISTOGRAM_H
+#define PJ_LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace PJ
+{
+/**
+ * @brief Histogram of durations, with buckets that are powers of two of microseconds:
+ * bucket i counts the durations in [2^(i-1), 2^i) us, bucket 0 the ones shorter than 1 us.
+ *
+ * record() can be called by one thread while others read the histogram.
+ */
+class LatencyHistogram
+{
+public:
+  static constexpr size_t BUCKETS = 32;
+
+  void record(std::chrono::nanoseconds duration)
+  {
+    const auto usec = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    size_t bucket = 0;
+    while (bucket + 1 < BUCKETS && (uint64_t(1) << bucket) <= usec)
+    {
+      bucket++;
+    }
+    _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    uint64_t max = _max_usec.load(std::memory_order_relaxed);
+    while (usec > max && !_max_usec.compare_exchange_weak(max, usec, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  void reset()
+  {
+    for (auto& bucket : _buckets)
+    {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    _max_usec.store(0, std::memory_order_relaxed);
+  }
+
+  uint64_t bucket(size_t index) const
+  {
+    return _buckets[index].load(std::memory_order_relaxed);
+  }
+
+  /// Upper limit of the durations counted by the bucket, in microseconds.
+  static uint64_t bucketLimit(size_t index)
+  {
+    return uint64_t(1) << index;
+  }
+
+  uint64_t count() const
+  {
+    uint64_t total = 0;
+    for (const auto& bucket : _buckets)
+    {
+      total += bucket.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  uint64_t maxMicroseconds() const
+  {
+    return _max_usec.load(std::memory_order_relaxed);
+  }
+
+  /// Upper limit of the bucket that contains the given percentile (in [0, 1]), in microseconds.
+  uint64_t percentile(double ratio) const
+  {
+    const uint64_t total = count();
+    if (total == 0)
+    {
+      return 0;
+    }
+    const auto target = static_cast<uint64_t>(ratio * static_cast<double>(total - 1)) + 1;
+    uint64_t cumulated = 0;
+    for (size_t i = 0; i < BUCKETS; i++)
+    {
+      cumulated += bucket(i);
+      if (cumulated >= target)
+      {
+        return bucketLimit(i);
+      }
+    }
+    return bucketLimit(BUCKETS - 1);
+  }
+
+private:
+  std::array<std::atomic<uint64_t>, BUCKETS> _buckets = {};
+  std::atomic<uint64_t> _max_usec = 0;
+};
+
+}  // namespace PJ
+
+#endif  // PJ_LATENCY_HISTOGRAM_H
@@ -0,0 +1,49 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_MESSAGE_RECORDER_H
+#define PJ_MESSAGE_RECORDER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "PlotJuggler/messageparser_base.h"
+
+namespace PJ
+{
+/**
+ * @brief Receives a copy of the raw messages of a DataStreamer, before they are parsed,
+ * for instance to save them in a file (see DataStreamer::setRecorder()).
+ *
+ * Its methods are called by the thread that receives the data, with DataStreamer::mutex()
+ * locked: they must never block. When the recorder can't keep up, it should drop
+ * the messages instead.
+ */
+class MessageRecorder
+{
+public:
+  using Ptr = std::shared_ptr<MessageRecorder>;
+
+  virtual ~MessageRecorder() = default;
+
+  /// Called once per topic, before its first message. Returns the id to pass to record().
+  virtual uint32_t addTopic(const std::string& topic, const MessageSchema& schema) = 0;
+
+  /**
+   * @brief Copy the message: it is not valid after the call.
+   *
+   * @param receive_time  when the message was received, in seconds since epoch.
+   * @param timestamp     the time assigned by the parser (e.g. a timestamp embedded
+   *                      in the message), or receive_time.
+   * @return false if the message was dropped.
+   */
+  virtual bool record(uint32_t topic_id, const MessageRef& msg, double receive_time,
+                      double timestamp) = 0;
+};
+
+}  // namespace PJ
+
+#endif  // PJ_MESSAGE_RECORDER_H
@@ -8,8 +8,11 @@
 
 #include <QtPlugin>
 #include <QApplication>
+#include <deque>
 #include "PlotJuggler/plotdata.h"
+#include "PlotJuggler/field_demand.h"
 #include "PlotJuggler/pj_plugin.h"
+#include "PlotJuggler/stream_metrics.h"
 
 namespace PJ
 {
@@ -66,6 +69,23 @@ private:
   size_t _size = 0;
 };
 
+/**
+ * @brief Encoding and schema of the messages of a topic, as passed to
+ * ParserFactoryPlugin::createParser(). Needed to decode the raw messages later,
+ * for instance when they are recorded (see DataStreamer::setRecorder()).
+ */
+struct MessageSchema
+{
+  /// Encoding of the messages, e.g. "json" or "cdr".
+  std::string encoding;
+  /// Encoding of the definition, e.g. "ros2msg". Same as "encoding", if empty.
+  std::string schema_encoding;
+  /// Name of the type, e.g. "sensor_msgs/msg/Imu". It may be empty.
+  std::string name;
+  /// It may be empty, for self-describing encodings like JSON.
+  std::string definition;
+};
+
 /**
  * @brief The MessageParser is the base class used to parse
  * a message with a specific encoding+schema.
@@ -88,7 +108,8 @@ public:
   // Decide what to do if an array is particularly large (size > max_size):
   //
   // if clamp == true, then keep the first max_size elements,
-  // otherwise, skip the entire array.
+  // otherwise, skip the entire array. Parsers that support it store instead
+  // a numeric array as a single ArraySeries (see getArraySeries()).
   virtual void setLargeArraysPolicy(bool clamp, unsigned max_size)
   {
     _clamp_large_arrays = clamp;
@@ -115,6 +136,61 @@ public:
     _use_embedded_timestamp = enable;
   }
 
+  const std::string& topicName() const
+  {
+    return _topic_name;
+  }
+
+  /// Counters of the messages parsed, updated by DataStreamer::parseMessageWithMetrics().
+  /// nullptr until the first message is parsed that way.
+  const TopicMetrics::Ptr& metrics() const
+  {
+    return _metrics;
+  }
+
+  void setMetrics(TopicMetrics::Ptr metrics)
+  {
+    _metrics = std::move(metrics);
+  }
+
+  /// Encoding and schema of the messages, if known. See DataStreamer::createParser().
+  const MessageSchema& schema() const
+  {
+    return _schema;
+  }
+
+  void setSchema(MessageSchema schema)
+  {
+    _schema = std::move(schema);
+  }
+
+  /**
+   * @brief Enable the "lazy fields" mode (see FieldDemand), or disable it if nullptr.
+   * Set by DataStreamer::parseMessageWithMetrics().
+   */
+  void setFieldDemand(FieldDemand::Ptr demand);
+
+  const FieldDemand::Ptr& fieldDemand() const
+  {
+    return _field_demand;
+  }
+
+  /// True if the parser checks isFieldRequested() before pushing samples into any series.
+  virtual bool supportsLazyFields() const
+  {
+    return false;
+  }
+
+  /**
+   * @brief Take the changes of the FieldDemand. If some series are requested for the
+   * first time, fill them parsing again the messages kept by keepForBackfill().
+   * Called by DataStreamer::parseMessageWithMetrics() before each message.
+   */
+  void updateFieldDemand();
+
+  /// Keep a copy of a message parsed successfully, if the FieldDemand enables the backfill.
+  void keepForBackfill(const MessageRef& msg, double timestamp);
+
 protected:
   PlotDataMapRef& _plot_data;
   std::string _topic_name;
@@ -130,10 +206,69 @@ protected:
     return _plot_data.getOrCreateStringSeries(key, _group);
   }
 
+  /// Series of a large array, named as the field without index (e.g. "scan/ranges").
+  ArraySeries& getArraySeries(const std::string& key)
+  {
+    return _plot_data.getOrCreateArraySeries(key, _group);
+  }
+
+  /**
+   * @brief Handle of the series, to be stored by parsers that push into the same series
+   * at each message. Use _plot_data.series(id) to access it without hashing the name.
+   * The handle expires when the series is removed: register it again in that case.
+   */
+  SeriesId registerSeries(const std::string& key)
+  {
+    return _plot_data.registerSeries(key, _group);
+  }
+
+  SeriesId registerStringSeries(const std::string& key)
+  {
+    return _plot_data.registerStringSeries(key, _group);
+  }
+
+  /// In "lazy fields" mode, true if the samples of the series must be stored.
+  /// Always true otherwise.
+  bool isFieldRequested(const std::string& key) const
+  {
+    if (!_field_demand)
+    {
+      return true;
+    }
+    const auto& fields = _backfilling ? _backfill_fields : _requested_fields;
+    return fields.count(key) > 0;
+  }
+
+  /// Changes when isFieldRequested() may return a different value: its results
+  /// can be cached until then.
+  uint64_t fieldDemandGeneration() const
+  {
+    return _field_demand_generation;
+  }
+
 private:
   bool _clamp_large_arrays = false;
   unsigned _max_array_size = 10000;
   bool _use_embedded_timestamp = false;
+  TopicMetrics::Ptr _metrics;
+  MessageSchema _schema;
+
+  FieldDemand::Ptr _field_demand;
+  // FieldDemand::generation() of _requested_fields
+  uint64_t _requested_generation = 0;
+  std::unordered_set<std::string> _requested_fields;
+  // all the series requested since setFieldDemand(): only the other ones are backfilled
+  std::unordered_set<std::string> _ever_requested_fields;
+  std::unordered_set<std::string> _backfill_fields;
+  bool _backfilling = false;
+  uint64_t _field_demand_generation = 0;
+
+  struct KeptMessage
+  {
+    std::vector<uint8_t> data;
+    double timestamp;
+  };
+  std::deque<KeptMessage> _kept_messages;
 };
 
 using MessageParserPtr = std::shared_ptr<MessageParser>;
@@ -0,0 +1,309 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_MINMAX_INDEX_H
+#define PJ_MINMAX_INDEX_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <vector>
+
+namespace PJ
+{
+/**
+ * @brief Multi-resolution min/max pyramid, used to answer the question
+ * "what is the range of y in the interval of indices [first, last]"
+ * in logarithmic time. Each node also keeps the sums of the values, of their
+ * squares and of their absolute values, so that mean and variance of an
+ * interval are obtained in logarithmic time too.
+ *
+ * A node of level K summarizes a block of FANOUT^(K+1) consecutive samples.
+ * Blocks are aligned to "absolute" positions, i.e. positions that also count
+ * the samples already removed with popFront(). Thanks to this, removing
+ * a sample from the front never shifts the levels.
+ *
+ * The first node of each level may still include samples that were popped,
+ * and the last one may be incomplete; a query uses a node only when its block
+ * is entirely inside the requested interval, so these nodes are never used.
+ */
+class MinMaxIndex
+{
+public:
+  static constexpr size_t FANOUT_SHIFT = 6;
+  static constexpr size_t FANOUT = size_t(1) << FANOUT_SHIFT;
+
+  struct Node
+  {
+    double min;
+    double max;
+    double sum;
+    double sum_squares;
+    double sum_abs;
+
+    static Node Empty()
+    {
+      return { std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(), 0, 0, 0 };
+    }
+
+    static Node FromValue(double y)
+    {
+      return { y, y, y, y * y, std::abs(y) };
+    }
+
+    void add(double y)
+    {
+      min = std::min(min, y);
+      max = std::max(max, y);
+      sum += y;
+      sum_squares += y * y;
+      sum_abs += std::abs(y);
+    }
+
+    void add(const Node& other)
+    {
+      min = std::min(min, other.min);
+      max = std::max(max, other.max);
+      sum += other.sum;
+      sum_squares += other.sum_squares;
+      sum_abs += other.sum_abs;
+    }
+  };
+
+  bool isBuilt() const
+  {
+    return _built;
+  }
+
+  void clear()
+  {
+    _levels.clear();
+    _base = 0;
+    _count = 0;
+    _built = false;
+  }
+
+  /// Build the index from scratch. "points" must provide size() and operator[] returning a Point.
+  template <typename Storage>
+  void build(const Storage& points)
+  {
+    clear();
+    _built = true;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+      pushBack(points[i].y);
+    }
+  }
+
+  /// A sample was appended to the series.
+  void pushBack(double y)
+  {
+    const size_t pos = _base + _count;
+    _count++;
+    if (_levels.empty())
+    {
+      _levels.emplace_back();
+    }
+    for (size_t k = 0; k < _levels.size(); k++)
+    {
+      auto& level = _levels[k];
+      const size_t shift = levelShift(k);
+      if ((pos >> shift) - (_base >> shift) == level.size())
+      {
+        level.push_back(Node::FromValue(y));
+      }
+      else
+      {
+        level.back().add(y);
+      }
+    }
+    // add a new level on top, when the current one has more than one node
+    while (_levels.back().size() > 1)
+    {
+      addLevel();
+    }
+  }
+
+  /// The first sample of the series was removed.
+  void popFront()
+  {
+    if (_count == 0)
+    {
+      return;
+    }
+    const size_t prev_base = _base;
+    _base++;
+    _count--;
+    if (_count == 0)
+    {
+      _levels.clear();
+      _base = 0;
+      return;
+    }
+    for (size_t k = 0; k < _levels.size(); k++)
+    {
+      const size_t shift = levelShift(k);
+      if ((prev_base >> shift) != (_base >> shift))
+      {
+        _levels[k].pop_front();
+      }
+    }
+  }
+
+  /**
+   * @brief Keep only the first "count" samples: the following ones were removed or
+   * modified and will be pushed again. "points" are the samples of the series, that must
+   * be unchanged up to "count". O(FANOUT * number of levels).
+   */
+  template <typename Storage>
+  void truncate(const Storage& points, size_t count)
+  {
+    if (count >= _count)
+    {
+      return;
+    }
+    if (count == 0)
+    {
+      _levels.clear();
+      _base = 0;
+      _count = 0;
+      return;
+    }
+    const size_t end = _base + count;
+    for (size_t k = 0; k < _levels.size(); k++)
+    {
+      const size_t shift = levelShift(k);
+      const size_t first_block = _base >> shift;
+      const size_t last_block = (end - 1) >> shift;
+      auto& level = _levels[k];
+      level.resize(last_block - first_block + 1);
+
+      // the last node may have lost some of its samples: compute it again
+      Node& last = level.back();
+      last = Node::Empty();
+      if (k == 0)
+      {
+        for (size_t pos = std::max(last_block << shift, _base); pos < end; pos++)
+        {
+          last.add(points[pos - _base].y);
+        }
+      }
+      else
+      {
+        const auto& children = _levels[k - 1];
+        const size_t first_child = _base >> levelShift(k - 1);
+        const size_t from = std::max(last_block << FANOUT_SHIFT, first_child);
+        for (size_t child = from; child - first_child < children.size(); child++)
+        {
+          last.add(children[child - first_child]);
+        }
+      }
+    }
+    _count = count;
+  }
+
+  /**
+   * @brief Range and sums of the y values in the interval [first_index, last_index].
+   * Indices are the ones of the series; the caller must check that they are valid.
+   */
+  template <typename Storage>
+  Node query(const Storage& points, size_t first_index, size_t last_index) const
+  {
+    Node out = Node::Empty();
+
+    // half-open interval in absolute positions
+    size_t lo = _base + first_index;
+    size_t hi = _base + last_index + 1;
+
+    auto scanSamples = [&](size_t from, size_t to) {
+      for (size_t pos = from; pos < to; pos++)
+      {
+        out.add(points[pos - _base].y);
+      }
+    };
+
+    auto scanNodes = [&](size_t k, size_t from, size_t to) {
+      const size_t shift = levelShift(k);
+      const size_t first_block = _base >> shift;
+      for (size_t block = (from >> shift); block < (to >> shift); block++)
+      {
+        out.add(_levels[k][block - first_block]);
+      }
+    };
+
+    // Climb the pyramid: at each level, consume the head and the tail of the interval
+    // that are not aligned to the blocks of the next level.
+    // level == -1 means "raw samples".
+    int level = -1;
+    while (lo < hi)
+    {
+      const size_t next = static_cast<size_t>(level + 1);
+      const size_t shift = levelShift(next);
+      const size_t lo_up = ((lo + (size_t(1) << shift) - 1) >> shift) << shift;
+      const size_t hi_down = (hi >> shift) << shift;
+
+      if (next >= _levels.size() || lo_up >= hi_down)
+      {
+        (level < 0) ? scanSamples(lo, hi) : scanNodes(level, lo, hi);
+        break;
+      }
+      if (level < 0)
+      {
+        scanSamples(lo, lo_up);
+        scanSamples(hi_down, hi);
+      }
+      else
+      {
+        scanNodes(level, lo, lo_up);
+        scanNodes(level, hi_down, hi);
+      }
+      lo = lo_up;
+      hi = hi_down;
+      level++;
+    }
+    return out;
+  }
+
+private:
+  std::vector<std::deque<Node>> _levels;
+  size_t _base = 0;
+  size_t _count = 0;
+  bool _built = false;
+
+  static size_t levelShift(size_t level)
+  {
+    return FANOUT_SHIFT * (level + 1);
+  }
+
+  void addLevel()
+  {
+    const size_t k = _levels.size() - 1;
+    const size_t shift = levelShift(k);
+    const size_t first_block = _base >> shift;
+
+    std::deque<Node> parent_level;
+    for (size_t i = 0; i < _levels[k].size(); i++)
+    {
+      const Node& child = _levels[k][i];
+      const size_t parent_index = ((first_block + i) >> FANOUT_SHIFT) - (first_block >> FANOUT_SHIFT);
+      if (parent_index == parent_level.size())
+      {
+        parent_level.push_back(child);
+      }
+      else
+      {
+        parent_level.back().add(child);
+      }
+    }
+    _levels.push_back(std::move(parent_level));
+  }
+};
+
+}  // namespace PJ
+
+#endif  // PJ_MINMAX_INDEX_H
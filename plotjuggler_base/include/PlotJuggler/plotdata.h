@@ -10,8 +10,12 @@
 #include "plotdatabase.h"
 #include "timeseries.h"
 #include "stringseries.h"
+#include "arrayseries.h"
 #include <any>
+#include <cstdint>
+#include <limits>
 #include <unordered_set>
+#include <vector>
 
 namespace PJ
 {
@@ -19,6 +23,46 @@ using PlotDataXY = PlotDataBase<double, double>;
 using PlotData = TimeseriesBase<double>;
 using PlotDataAny = TimeseriesBase<std::any>;
 
+/**
+ * @brief Handle of a series registered in PlotDataMapRef (see registerSeries()).
+ *
+ * Unlike a pointer, it can be kept after the series is removed: it simply
+ * becomes expired, and PlotDataMapRef::series() returns nullptr.
+ */
+struct SeriesId
+{
+  static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+  uint32_t index = INVALID_INDEX;
+  uint32_t generation = 0;
+
+  bool valid() const
+  {
+    return index != INVALID_INDEX;
+  }
+
+  bool operator==(const SeriesId& other) const
+  {
+    return index == other.index && generation == other.generation;
+  }
+
+  bool operator!=(const SeriesId& other) const
+  {
+    return !(*this == other);
+  }
+
+  // useful to store the handle in a QVariant
+  uint64_t toUInt64() const
+  {
+    return (uint64_t(generation) << 32) | index;
+  }
+
+  static SeriesId fromUInt64(uint64_t value)
+  {
+    return { static_cast<uint32_t>(value), static_cast<uint32_t>(value >> 32) };
+  }
+};
+
 /**
  * @brief The PlotDataMapRef is the main data structure used to store all the
  * timeseries in a single place.
@@ -31,6 +75,7 @@ using TimeseriesMap = std::unordered_map<std::string, PlotData>;
 using ScatterXYMap = std::unordered_map<std::string, PlotDataXY>;
 using AnySeriesMap = std::unordered_map<std::string, PlotDataAny>;
 using StringSeriesMap = std::unordered_map<std::string, StringSeries>;
+using ArraySeriesMap = std::unordered_map<std::string, ArraySeries>;
 
 struct PlotDataMapRef
 {
@@ -46,6 +91,10 @@ struct PlotDataMapRef
   /// Series of strings
   StringSeriesMap strings;
 
+  /// Series of arrays of numbers. Their elements are not listed in "numeric",
+  /// unless materialized (see materializeArrayElement()).
+  ArraySeriesMap arrays;
+
   /**
    * @brief Each series can have (optionally) a group.
    * Groups can have their own properties.
@@ -60,6 +109,8 @@ struct PlotDataMapRef
 
   StringSeriesMap::iterator addStringSeries(const std::string& name, PlotGroup::Ptr group = {});
 
+  ArraySeriesMap::iterator addArraySeries(const std::string& name, PlotGroup::Ptr group = {});
+
   PlotDataXY& getOrCreateScatterXY(const std::string& name, PlotGroup::Ptr group = {});
 
   PlotData& getOrCreateNumeric(const std::string& name, PlotGroup::Ptr group = {});
@@ -68,15 +119,178 @@ struct PlotDataMapRef
 
   PlotDataAny& getOrCreateUserDefined(const std::string& name, PlotGroup::Ptr group = {});
 
+  ArraySeries& getOrCreateArraySeries(const std::string& name, PlotGroup::Ptr group = {});
+
   PlotGroup::Ptr getOrCreateGroup(const std::string& name);
 
+  /**
+   * @brief Get or create a numeric series and return its handle.
+   * The name is hashed only here: series(id) is a lookup in an array.
+   */
+  SeriesId registerSeries(const std::string& name, PlotGroup::Ptr group = {});
+
+  /// Same as registerSeries(), for a series of strings.
+  SeriesId registerStringSeries(const std::string& name, PlotGroup::Ptr group = {});
+
+  /// Handle of an existing numeric or string series, or an invalid one if there is no such series.
+  SeriesId findSeriesId(const std::string& name);
+
+  /// nullptr if the handle expired (erase() or clear()) or refers to a series of strings.
+  PlotData* series(SeriesId id) const
+  {
+    const Slot* slot = validSlot(id);
+    return slot ? slot->numeric : nullptr;
+  }
+
+  /// nullptr if the handle expired (erase() or clear()) or refers to a numeric series.
+  StringSeries* stringSeries(SeriesId id) const
+  {
+    const Slot* slot = validSlot(id);
+    return slot ? slot->string : nullptr;
+  }
+
+  /**
+   * @brief All the handles expire. clear() and erase() do it automatically;
+   * call it explicitly after erasing or moving elements of "numeric" or "strings" directly.
+   */
+  void invalidateSeriesIds();
+
+  /**
+   * @brief Get the numeric series of an element of an array, such as "scan/ranges[3]"
+   * (see ArrayElementName()), creating it from the ArraySeries the first time.
+   * The series is then kept updated by updateArrayElements().
+   *
+   * @return the numeric series with that name, if it exists already, or nullptr
+   * if the name doesn't refer to an element of an array.
+   */
+  PlotData* materializeArrayElement(const std::string& name);
+
+  /// Append to the materialized elements the samples added to their arrays since the previous
+  /// call, and forget the ones whose series was removed. O(new samples).
+  void updateArrayElements();
+
   std::unordered_set<std::string> getAllNames() const;
 
   void clear();
 
   void setMaximumRangeX(double range);
 
+  /// See TimeseriesBase::setReorderWindow(). It is applied also to the series
+  /// created later by this class.
+  void setReorderWindow(double window);
+
+  /// See TimeseriesBase::setCompression(). It is applied only to the existing numeric series.
+  void setCompression(bool enable);
+
+  double reorderWindow() const
+  {
+    return _reorder_window;
+  }
+
+  /**
+   * @brief Assign to each timeseries the policy of the rule that matches its name
+   * (see FindRetentionPolicy()). It is applied also to the series created later by this class.
+   */
+  void setRetentionRules(RetentionRules rules);
+
+  const RetentionRules& retentionRules() const
+  {
+    return _retention_rules;
+  }
+
+  /**
+   * @brief Limit of the memory used by the samples of all the timeseries, in bytes.
+   * 0 means no limit. It is enforced only by enforceMemoryBudget().
+   */
+  void setMemoryBudget(size_t bytes)
+  {
+    _memory_budget = bytes;
+  }
+
+  size_t memoryBudget() const
+  {
+    return _memory_budget;
+  }
+
+  /// The series is displayed: enforceMemoryBudget() will trim it after the others.
+  void markViewed(const std::string& name);
+
+  /**
+   * @brief If the samples use more memory than memoryBudget(), remove the oldest samples of the
+   * series that were viewed least recently (see markViewed()), until the budget is respected.
+   * The last samples of each series are kept. O(number of chunks): call it periodically.
+   *
+   * @return the number of samples removed.
+   */
+  size_t enforceMemoryBudget();
+
   bool erase(const std::string& name);
+
+  /**
+   * @brief Copy of all the series and groups, that doesn't share any object with this map,
+   * except the immutable chunks of samples and the dictionaries of the string series
+   * (copy-on-write): O(number of chunks), independent of the number of samples.
+   * The indices of the y values are not copied; a snapshot builds them if needed.
+   * The snapshot can be read by another thread while this map keeps receiving data.
+   * It must be created by the thread that modifies this map.
+   *
+   * The late samples not merged yet (see TimeseriesBase::setReorderWindow()) and the
+   * handles of the series (SeriesId) are not part of the snapshot.
+   */
+  PlotDataMapRef snapshot() const;
+
+  /**
+   * @brief Keep track of the series that received new samples, or whose attributes changed,
+   * and of the groups whose attributes changed (see DirtySet).
+   * Useful to visit only those, when the data is moved periodically to another map.
+   */
+  void enableDirtyTracking();
+
+  /// nullptr, unless enableDirtyTracking() was called.
+  const DirtySet::Ptr& dirtySet() const
+  {
+    return _dirty_set;
+  }
+
+private:
+  double _reorder_window = 0;
+  DirtySet::Ptr _dirty_set;
+  RetentionRules _retention_rules;
+  size_t _memory_budget = 0;
+  uint64_t _view_clock = 0;
+
+  // series are stored in the nodes of an unordered_map, their address is stable
+  struct Slot
+  {
+    PlotData* numeric = nullptr;
+    StringSeries* string = nullptr;
+    uint32_t generation = 0;
+  };
+  std::vector<Slot> _slots;
+  std::vector<uint32_t> _free_slots;
+  std::unordered_map<std::string, SeriesId> _numeric_ids;
+  std::unordered_map<std::string, SeriesId> _string_ids;
+
+  // materialized elements of the arrays: numeric series name -> array and index
+  struct ArrayElement
+  {
+    std::string array_name;
+    size_t index;
+  };
+  std::unordered_map<std::string, ArrayElement> _array_elements;
+
+  const Slot* validSlot(SeriesId id) const
+  {
+    if (id.index >= _slots.size() || _slots[id.index].generation != id.generation)
+    {
+      return nullptr;
+    }
+    return &_slots[id.index];
+  }
+
+  SeriesId addSlot(PlotData* numeric, StringSeries* string);
+
+  void releaseId(std::unordered_map<std::string, SeriesId>& ids, const std::string& name);
 };
 
 template <typename Value>
@@ -9,16 +9,21 @@
 
 #include <memory>
 #include <string>
-#include <deque>
 #include <type_traits>
 #include <cmath>
 #include <cstdlib>
 #include <unordered_map>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include <QVariant>
 #include <QtGlobal>
 
+#include "PlotJuggler/series_storage.h"
+#include "PlotJuggler/minmax_index.h"
+#include "PlotJuggler/sliding_minmax.h"
+
 namespace PJ
 {
 struct Range
@@ -72,6 +77,59 @@ inline bool CheckType(PlotAttribute attr, const QVariant& value)
   return false;
 }
 
+/**
+ * @brief Names of the series and groups modified since the last call to drain().
+ * See PlotDataMapRef::enableDirtyTracking().
+ *
+ * A name is added only once between two calls to drain(): each series or group
+ * remembers the "generation" of the set in which it was added last.
+ */
+class DirtySet
+{
+public:
+  using Ptr = std::shared_ptr<DirtySet>;
+
+  struct Changes
+  {
+    std::vector<std::string> series;
+    std::vector<std::string> groups;
+  };
+
+  void addSeries(const std::string& name, uint64_t& generation)
+  {
+    if (generation != _generation)
+    {
+      generation = _generation;
+      _changes.series.push_back(name);
+    }
+  }
+
+  void addGroup(const std::string& name, uint64_t& generation)
+  {
+    if (generation != _generation)
+    {
+      generation = _generation;
+      _changes.groups.push_back(name);
+    }
+  }
+
+  bool empty() const
+  {
+    return _changes.series.empty() && _changes.groups.empty();
+  }
+
+  /// Return the names collected so far and start a new generation.
+  Changes drain()
+  {
+    _generation++;
+    return std::exchange(_changes, {});
+  }
+
+private:
+  uint64_t _generation = 1;
+  Changes _changes;
+};
+
 /**
  * @brief PlotData may or may not have a group. Think of PlotGroup
  * as a way to say that certain set of series are "siblings".
@@ -82,7 +140,8 @@ class PlotGroup
 public:
   using Ptr = std::shared_ptr<PlotGroup>;
 
-  PlotGroup(const std::string& name) : _name(name)
+  PlotGroup(const std::string& name)
+    : _name(name), _time_column(std::make_shared<TimeColumn>())
   {
   }
 
@@ -104,6 +163,10 @@ public:
   void setAttribute(const PlotAttribute& id, const QVariant& value)
   {
     _attributes[id] = value;
+    if (_dirty_set)
+    {
+      _dirty_set->addGroup(_name, _dirty_generation);
+    }
   }
 
   QVariant attribute(const PlotAttribute& id) const
@@ -112,9 +175,27 @@ public:
     return (it == _attributes.end()) ? QVariant() : it->second;
   }
 
+  /**
+   * @brief Timestamps shared by the timeseries of the group. Series created from the
+   * same message have the same x values: each one stores only its y values.
+   */
+  const TimeColumn::Ptr& timeColumn() const
+  {
+    return _time_column;
+  }
+
+  /// Report the changes of the attributes (done with setAttribute()) to this set.
+  void setDirtySet(DirtySet::Ptr dirty_set)
+  {
+    _dirty_set = std::move(dirty_set);
+  }
+
 private:
   const std::string _name;
   Attributes _attributes;
+  TimeColumn::Ptr _time_column;
+  DirtySet::Ptr _dirty_set;
+  uint64_t _dirty_generation = 0;
 };
 
 // A Generic series of points
@@ -139,10 +220,250 @@ public:
     ASYNC_BUFFER_CAPACITY = 1024
   };
 
-  typedef typename std::deque<Point>::iterator Iterator;
-  typedef typename std::deque<Point>::const_iterator ConstIterator;
+  typedef SeriesStorage<Point> Storage;
+  typedef typename Storage::ConstIterator ConstIterator;
+  typedef typename Storage::Reference PointRef;
+  typedef typename Storage::ConstReference ConstPointRef;
   typedef Value ValueT;
 
+  /**
+   * @brief Returned by the non-const at(), operator[] and Iterator, for the code written
+   * when they returned Point&. It is a copy of the sample: when it is destroyed, x and y
+   * are stored back if they were modified, and the cached ranges are invalidated.
+   *
+   * Deprecated: read the samples with the const accessors and modify them with setY()
+   * or mutableAt().
+   */
+  class PointAccess
+  {
+    // declared first: x and y refer to _point
+    PlotDataBase* _series;
+    size_t _index;
+    Point _original;
+    Point _point;
+
+  public:
+    TypeX& x;
+    Value& y;
+
+    PointAccess(PlotDataBase* series, size_t index)
+      : _series(series)
+      , _index(index)
+      , _original(std::as_const(*series).at(index))
+      , _point(_original)
+      , x(_point.x)
+      , y(_point.y)
+    {
+    }
+
+    PointAccess(const PointAccess& other) = delete;
+
+    PointAccess& operator=(const Point& other)
+    {
+      _point = other;
+      return *this;
+    }
+
+    PointAccess& operator=(const PointAccess& other)
+    {
+      _point = other._point;
+      return *this;
+    }
+
+    operator Point() const
+    {
+      return _point;
+    }
+
+    ~PointAccess()
+    {
+      const bool x_changed = !sameValue(_point.x, _original.x);
+      if (_index >= _series->size() || (!x_changed && sameValue(_point.y, _original.y)))
+      {
+        return;
+      }
+      if (x_changed)
+      {
+        auto point = _series->mutableAt(_index);
+        point.x = std::move(_point.x);
+        point.y = std::move(_point.y);
+        _series->invalidateRanges();
+      }
+      else
+      {
+        _series->setY(_index, std::move(_point.y));
+      }
+    }
+
+  private:
+    template <typename T>
+    static bool sameValue(const T& a, const T& b)
+    {
+      if constexpr (std::is_floating_point_v<T>)
+      {
+        return a == b || (std::isnan(a) && std::isnan(b));
+      }
+      else if constexpr (IsEqualityComparable<T>::value)
+      {
+        return a == b;
+      }
+      else
+      {
+        return false;
+      }
+    }
+
+    template <typename T, typename = void>
+    struct IsEqualityComparable : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct IsEqualityComparable<
+        T, std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>>
+      : std::true_type
+    {
+    };
+  };
+
+  /// Deprecated: see PointAccess. It can be used where a ConstIterator is expected.
+  class Iterator
+  {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = Point;
+    using difference_type = std::ptrdiff_t;
+    using reference = PointAccess;
+
+    struct pointer
+    {
+      PointAccess access;
+
+      PointAccess* operator->()
+      {
+        return &access;
+      }
+    };
+
+    Iterator() = default;
+
+    Iterator(PlotDataBase* owner, size_t index) : _owner(owner), _index(index)
+    {
+    }
+
+    operator ConstIterator() const
+    {
+      return _owner ? ConstIterator(&_owner->_points, _index) : ConstIterator();
+    }
+
+    size_t index() const
+    {
+      return _index;
+    }
+
+    reference operator*() const
+    {
+      return PointAccess(_owner, _index);
+    }
+
+    pointer operator->() const
+    {
+      return pointer{ PointAccess(_owner, _index) };
+    }
+
+    reference operator[](difference_type n) const
+    {
+      return PointAccess(_owner, _index + n);
+    }
+
+    Iterator& operator++()
+    {
+      ++_index;
+      return *this;
+    }
+
+    Iterator operator++(int)
+    {
+      Iterator prev = *this;
+      ++_index;
+      return prev;
+    }
+
+    Iterator& operator--()
+    {
+      --_index;
+      return *this;
+    }
+
+    Iterator operator--(int)
+    {
+      Iterator prev = *this;
+      --_index;
+      return prev;
+    }
+
+    Iterator& operator+=(difference_type n)
+    {
+      _index += n;
+      return *this;
+    }
+
+    Iterator& operator-=(difference_type n)
+    {
+      _index -= n;
+      return *this;
+    }
+
+    Iterator operator+(difference_type n) const
+    {
+      return Iterator(_owner, _index + n);
+    }
+
+    Iterator operator-(difference_type n) const
+    {
+      return Iterator(_owner, _index - n);
+    }
+
+    difference_type operator-(const Iterator& other) const
+    {
+      return difference_type(_index) - difference_type(other._index);
+    }
+
+    bool operator==(const Iterator& other) const
+    {
+      return _index == other._index;
+    }
+
+    bool operator!=(const Iterator& other) const
+    {
+      return _index != other._index;
+    }
+
+    bool operator<(const Iterator& other) const
+    {
+      return _index < other._index;
+    }
+
+    bool operator>(const Iterator& other) const
+    {
+      return _index > other._index;
+    }
+
+    bool operator<=(const Iterator& other) const
+    {
+      return _index <= other._index;
+    }
+
+    bool operator>=(const Iterator& other) const
+    {
+      return _index >= other._index;
+    }
+
+  private:
+    PlotDataBase* _owner = nullptr;
+    size_t _index = 0;
+  };
+
   PlotDataBase(const std::string& name, PlotGroup::Ptr group)
     : _name(name), _range_x_dirty(true), _range_y_dirty(true), _group(group)
   {
@@ -154,6 +475,9 @@ public:
   PlotDataBase& operator=(const PlotDataBase& other) = delete;
   PlotDataBase& operator=(PlotDataBase&& other) = default;
 
+  /// Copy the samples of another series. They are shared with it until either of the two
+  /// is modified (see SeriesStorage): O(number of chunks). The index of the y values is not
+  /// copied: like in any series, it is built when a range query needs it.
   void clonePoints(const PlotDataBase& other)
   {
     _points = other._points;
@@ -161,6 +485,10 @@ public:
     _range_y = other._range_y;
     _range_x_dirty = other._range_x_dirty;
     _range_y_dirty = other._range_y_dirty;
+    _sorted_x = other._sorted_x;
+    _y_index.clear();
+    resetRangeTracking();
+    markChanged();
   }
 
   void clonePoints(PlotDataBase&& other)
@@ -170,6 +498,12 @@ public:
     _range_y = other._range_y;
     _range_x_dirty = other._range_x_dirty;
     _range_y_dirty = other._range_y_dirty;
+    _sorted_x = other._sorted_x;
+    _y_index = std::move(other._y_index);
+    other._y_index.clear();
+    resetRangeTracking();
+    other.resetRangeTracking();
+    markChanged();
   }
 
   /// Swap only the data (points and cached ranges), leaving name, group,
@@ -181,6 +515,21 @@ public:
     std::swap(_range_y, other._range_y);
     std::swap(_range_x_dirty, other._range_x_dirty);
     std::swap(_range_y_dirty, other._range_y_dirty);
+    std::swap(_sorted_x, other._sorted_x);
+    std::swap(_y_index, other._y_index);
+    resetRangeTracking();
+    other.resetRangeTracking();
+    _revision++;
+    other._revision++;
+    // only the side that received samples changed, for the DirtySet
+    if (!_points.empty())
+    {
+      markChanged();
+    }
+    if (!other._points.empty())
+    {
+      other.markChanged();
+    }
   }
 
   virtual ~PlotDataBase() = default;
@@ -195,7 +544,7 @@ public:
     return _group;
   }
 
-  void changeGroup(PlotGroup::Ptr group)
+  virtual void changeGroup(PlotGroup::Ptr group)
   {
     _group = group;
   }
@@ -205,36 +554,119 @@ public:
     return _points.size();
   }
 
+  /// Approximate memory used by the samples, in bytes. O(number of chunks).
+  size_t memoryUsage() const
+  {
+    return _points.memoryUsage();
+  }
+
   virtual bool isTimeseries() const
   {
     return false;
   }
 
-  const Point& at(size_t index) const
+  /**
+   * @brief Incremented every time the samples are modified (added, removed, or changed
+   * with setY() or invalidateRanges()). Used by the views to know if their caches are stale.
+   */
+  uint64_t revision() const
   {
-    return _points[index];
+    return _revision;
   }
 
-  Point& at(size_t index)
+  ConstPointRef at(size_t index) const
   {
     return _points[index];
   }
 
-  const Point& operator[](size_t index) const
+  ConstPointRef operator[](size_t index) const
   {
     return at(index);
   }
 
-  Point& operator[](size_t index)
+  [[deprecated("Use the const at(), setY() or mutableAt()")]] PointAccess at(size_t index)
   {
-    return at(index);
+    return PointAccess(this, index);
+  }
+
+  [[deprecated("Use the const operator[], setY() or mutableAt()")]] PointAccess
+  operator[](size_t index)
+  {
+    return PointAccess(this, index);
+  }
+
+  /**
+   * @brief Mutable access to a sample: invalidateRanges() must be called after modifying it.
+   * A compressed chunk is decoded permanently; to change only y, prefer setY().
+   */
+  PointRef mutableAt(size_t index)
+  {
+    if (_sorted_x)
+    {
+      // x might not be sorted anymore: its range is computed from the samples
+      _sorted_x = false;
+      _range_x_dirty = true;
+      resetRangeTracking();
+    }
+    return _points.mutableAt(index);
+  }
+
+  /// Replace the y value of a sample, invalidating the cached ranges of y.
+  void setY(size_t index, Value y)
+  {
+    _points.setY(index, std::move(y));
+    _range_y_dirty = true;
+    _y_index.clear();
+    if (!_range_tracker_dirty)
+    {
+      resetRangeTracking();
+    }
+    markChanged();
   }
 
   virtual void clear()
   {
     _points.clear();
+    _revision++;
+    _y_index.clear();
     _range_x_dirty = true;
     _range_y_dirty = true;
+    resetRangeTracking();
+  }
+
+  /**
+   * @brief Opt-in: keep the range of x and y updated incrementally, in amortized O(1)
+   * per sample, also when samples are removed with popFront().
+   *
+   * Without it, removing the current min or max from the front forces rangeX()
+   * or rangeY() to scan the entire series again; this is expensive for the
+   * buffers used in streaming, where popFront() is called for each new sample.
+   */
+  void setRangeTracking(bool enable)
+  {
+    if (enable != _range_tracking)
+    {
+      _range_tracking = enable;
+      resetRangeTracking();
+    }
+  }
+
+  bool rangeTracking() const
+  {
+    return _range_tracking;
+  }
+
+  /**
+   * @brief Must be called after modifying the points in place, using mutableAt(),
+   * because the cached ranges and indices can not be updated incrementally.
+   */
+  void invalidateRanges()
+  {
+    _range_x_dirty = true;
+    _range_y_dirty = true;
+    _y_index.clear();
+    resetRangeTracking();
+    markChanged();
   }
 
   const Attributes& attributes() const
@@ -254,6 +686,19 @@ public:
     {
       throw std::runtime_error("PlotDataBase::setAttribute : wrong type");
     }
+    markChanged();
+  }
+
+  /**
+   * @brief Report to this set when new samples are added or the attributes are changed
+   * (with setAttribute()). The series is added to the set immediately, because it is new.
+   * Removing samples is not reported.
+   */
+  void setDirtySet(DirtySet::Ptr dirty_set)
+  {
+    _dirty_set = std::move(dirty_set);
+    _dirty_generation = 0;
+    markChanged();
   }
 
   QVariant attribute(PlotAttribute id) const
@@ -262,12 +707,12 @@ public:
     return (it == _attributes.end()) ? QVariant() : it->second;
   }
 
-  const Point& front() const
+  ConstPointRef front() const
   {
     return _points.front();
   }
 
-  const Point& back() const
+  ConstPointRef back() const
   {
     return _points.back();
   }
@@ -282,14 +727,38 @@ public:
     return _points.end();
   }
 
-  Iterator begin()
+  [[deprecated("Use the const begin(), setY() or mutableAt()")]] Iterator begin()
   {
-    return _points.begin();
+    return Iterator(this, 0);
   }
 
-  Iterator end()
+  [[deprecated("Use the const end(), setY() or mutableAt()")]] Iterator end()
   {
-    return _points.end();
+    return Iterator(this, _points.size());
+  }
+
+  /// Number of chunks of the underlying storage. See chunkX() and chunkY().
+  size_t chunkCount() const
+  {
+    return _points.chunkCount();
+  }
+
+  /// Index of the first sample of the chunk.
+  size_t chunkFirstIndex(size_t chunk) const
+  {
+    return _points.chunkFirstIndex(chunk);
+  }
+
+  /// Contiguous x values of a chunk. Concatenating all the chunks, you get all the samples.
+  Span<const TypeX> chunkX(size_t chunk) const
+  {
+    return _points.chunkX(chunk);
+  }
+
+  /// Contiguous y values of a chunk. Concatenating all the chunks, you get all the samples.
+  Span<const Value> chunkY(size_t chunk) const
+  {
+    return _points.chunkY(chunk);
   }
 
   // template specialization for types that support compare operator
@@ -301,14 +770,26 @@ public:
       {
         return std::nullopt;
       }
+      if (_sorted_x)
+      {
+        return Range{ double(front().x), double(back().x) };
+      }
+      if (_range_tracking)
+      {
+        updateRangeTracking();
+        return Range{ _x_tracker.min(), _x_tracker.max() };
+      }
       if (_range_x_dirty)
       {
         _range_x.min = front().x;
         _range_x.max = _range_x.min;
-        for (const auto& p : _points)
+        for (size_t c = 0; c < _points.chunkCount(); c++)
         {
-          _range_x.min = std::min(_range_x.min, p.x);
-          _range_x.max = std::max(_range_x.max, p.x);
+          for (const TypeX& x : _points.chunkX(c))
+          {
+            _range_x.min = std::min(_range_x.min, x);
+            _range_x.max = std::max(_range_x.max, x);
+          }
         }
         _range_x_dirty = false;
       }
@@ -326,14 +807,22 @@ public:
       {
         return std::nullopt;
       }
+      if (_range_tracking)
+      {
+        updateRangeTracking();
+        return Range{ _y_tracker.min(), _y_tracker.max() };
+      }
       if (_range_y_dirty)
       {
         _range_y.min = front().y;
         _range_y.max = _range_y.min;
-        for (const auto& p : _points)
+        for (size_t c = 0; c < _points.chunkCount(); c++)
         {
-          _range_y.min = std::min(_range_y.min, p.y);
-          _range_y.max = std::max(_range_y.max, p.y);
+          for (const Value& y : _points.chunkY(c))
+          {
+            _range_y.min = std::min(_range_y.min, y);
+            _range_y.max = std::max(_range_y.max, y);
+          }
         }
         _range_y_dirty = false;
       }
@@ -342,6 +831,66 @@ public:
     return std::nullopt;
   }
 
+  /**
+   * @brief Range of the y values in the interval of indices [first_index, last_index].
+   *
+   * The first time a large interval is requested, a min/max pyramid (MinMaxIndex) is built;
+   * from that moment it is updated by pushBack() and popFront() and the query is O(log N).
+   */
+  RangeOpt rangeY(size_t first_index, size_t last_index) const
+  {
+    if (const auto summary = summaryY(first_index, last_index))
+    {
+      return Range{ summary->min, summary->max };
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Min, max and sums (of the values, of the squares, of the absolute values) of y
+   * in the interval of indices [first_index, last_index]. Same cost of rangeY(first, last).
+   */
+  std::optional<MinMaxIndex::Node> summaryY(size_t first_index, size_t last_index) const
+  {
+    if constexpr (std::is_arithmetic_v<Value>)
+    {
+      if (_points.empty() || first_index > last_index || last_index >= _points.size())
+      {
+        return std::nullopt;
+      }
+      if (!_y_index.isBuilt() && (last_index - first_index) >= MIN_SIZE_RANGE_INDEX)
+      {
+        _y_index.build(_points);
+      }
+      if (_y_index.isBuilt())
+      {
+        return _y_index.query(_points, first_index, last_index);
+      }
+      auto summary = MinMaxIndex::Node::Empty();
+      for (size_t c = 0; c < _points.chunkCount(); c++)
+      {
+        const size_t chunk_first = _points.chunkFirstIndex(c);
+        const auto ys = _points.chunkY(c);
+        if (chunk_first > last_index)
+        {
+          break;
+        }
+        if (chunk_first + ys.size() <= first_index)
+        {
+          continue;
+        }
+        const size_t from = (first_index > chunk_first) ? (first_index - chunk_first) : 0;
+        const size_t to = std::min(ys.size(), last_index + 1 - chunk_first);
+        for (size_t i = from; i < to; i++)
+        {
+          summary.add(ys[i]);
+        }
+      }
+      return summary;
+    }
+    return std::nullopt;
+  }
+
   virtual void pushBack(const Point& p)
   {
     auto temp = p;
@@ -350,46 +899,62 @@ public:
 
   virtual void pushBack(Point&& p)
   {
+    if (!isValid(p))
+    {
+      return;  // skip
+    }
     if constexpr (std::is_arithmetic_v<TypeX>)
     {
-      if (std::isinf(p.x) || std::isnan(p.x))
-      {
-        return;  // skip
-      }
       pushUpdateRangeX(p);
     }
     if constexpr (std::is_arithmetic_v<Value>)
     {
-      if (std::isinf(p.y) || std::isnan(p.y))
+      pushUpdateRangeY(p);
+      if (_y_index.isBuilt())
       {
-        return;  // skip
+        _y_index.pushBack(p.y);
+      }
+    }
+    if (_range_tracking && !_range_tracker_dirty)
+    {
+      if constexpr (std::is_arithmetic_v<TypeX>)
+      {
+        if (!_sorted_x)
+        {
+          _x_tracker.pushBack(p.x);
+        }
+      }
+      if constexpr (std::is_arithmetic_v<Value>)
+      {
+        _y_tracker.pushBack(p.y);
       }
-      pushUpdateRangeY(p);
     }
 
-    _points.emplace_back(p);
+    _points.push_back(std::move(p));
+    markChanged();
   }
 
-  virtual void insert(Iterator it, Point&& p)
+  virtual void insert(ConstIterator it, Point&& p)
   {
+    if (!isValid(p))
+    {
+      return;  // skip
+    }
     if constexpr (std::is_arithmetic_v<TypeX>)
     {
-      if (std::isinf(p.x) || std::isnan(p.x))
-      {
-        return;  // skip
-      }
       pushUpdateRangeX(p);
     }
     if constexpr (std::is_arithmetic_v<Value>)
     {
-      if (std::isinf(p.y) || std::isnan(p.y))
-      {
-        return;  // skip
-      }
       pushUpdateRangeY(p);
     }
 
-    _points.insert(it, p);
+    // the following samples are shifted: the indices are cut and extended again
+    const size_t index = it.index();
+    truncateIndices(index);
+    _points.insert(index, std::move(p));
+    extendIndices(index);
+    markChanged();
   }
 
   virtual void popFront()
@@ -411,13 +976,29 @@ public:
         _range_y_dirty = true;
       }
     }
+    if (_range_tracking && !_range_tracker_dirty)
+    {
+      if constexpr (std::is_arithmetic_v<TypeX>)
+      {
+        if (!_sorted_x)
+        {
+          _x_tracker.popFront();
+        }
+      }
+      if constexpr (std::is_arithmetic_v<Value>)
+      {
+        _y_tracker.popFront();
+      }
+    }
     _points.pop_front();
+    _y_index.popFront();
+    _revision++;
   }
 
 protected:
   std::string _name;
   Attributes _attributes;
-  std::deque<Point> _points;
+  Storage _points;
 
   mutable Range _range_x;
   mutable Range _range_y;
@@ -425,6 +1006,256 @@ protected:
   mutable bool _range_y_dirty;
   mutable std::shared_ptr<PlotGroup> _group;
 
+  // built lazily by rangeY(first_index, last_index)
+  mutable MinMaxIndex _y_index;
+  static constexpr size_t MIN_SIZE_RANGE_INDEX = 4 * MinMaxIndex::FANOUT * MinMaxIndex::FANOUT;
+
+  // x never decreases (timeseries): its range is given by the first and the last sample,
+  // _range_x and _x_tracker are not used
+  bool _sorted_x = false;
+
+  // used instead of _range_x and _range_y, when setRangeTracking() is enabled
+  bool _range_tracking = false;
+  mutable bool _range_tracker_dirty = true;
+  mutable SlidingMinMax<TypeX> _x_tracker;
+  mutable SlidingMinMax<Value> _y_tracker;
+
+  DirtySet::Ptr _dirty_set;
+  uint64_t _dirty_generation = 0;
+  uint64_t _revision = 0;
+
+  // O(1): a branch, when the series was already reported since the last DirtySet::drain()
+  void markChanged()
+  {
+    _revision++;
+    if (_dirty_set)
+    {
+      _dirty_set->addSeries(_name, _dirty_generation);
+    }
+  }
+
+  // the trackers will be rebuilt, if needed, by the next call to rangeX() or rangeY().
+  // Must be called after modifying _points.
+  void resetRangeTracking()
+  {
+    _x_tracker.clear();
+    _y_tracker.clear();
+    // empty trackers are valid for an empty series
+    _range_tracker_dirty = !(_range_tracking && _points.empty());
+  }
+
+  void updateRangeTracking() const
+  {
+    if (!_range_tracker_dirty)
+    {
+      return;
+    }
+    _x_tracker.clear();
+    _y_tracker.clear();
+    for (size_t c = 0; c < _points.chunkCount(); c++)
+    {
+      if constexpr (std::is_arithmetic_v<TypeX>)
+      {
+        for (const TypeX& x : _sorted_x ? Span<const TypeX>() : _points.chunkX(c))
+        {
+          _x_tracker.pushBack(x);
+        }
+      }
+      if constexpr (std::is_arithmetic_v<Value>)
+      {
+        for (const Value& y : _points.chunkY(c))
+        {
+          _y_tracker.pushBack(y);
+        }
+      }
+    }
+    _range_tracker_dirty = false;
+  }
+
+  // samples with NaN or Inf are never stored. The ranges must be updated
+  // only after checking both coordinates.
+  static bool isValid(const Point& p)
+  {
+    if constexpr (std::is_arithmetic_v<TypeX>)
+    {
+      if (std::isinf(p.x) || std::isnan(p.x))
+      {
+        return false;
+      }
+    }
+    if constexpr (std::is_arithmetic_v<Value>)
+    {
+      if (std::isinf(p.y) || std::isnan(p.y))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Append samples that are already validated (no NaN or Inf) and sorted,
+  // updating the ranges once for the entire batch.
+  void appendValidSamples(Span<const TypeX> xs, Span<const Value> ys)
+  {
+    if (xs.empty())
+    {
+      return;
+    }
+    if constexpr (std::is_arithmetic_v<TypeX>)
+    {
+      const Range range = BatchRange(xs);
+      if (_points.empty())
+      {
+        _range_x = range;
+        _range_x_dirty = false;
+      }
+      else if (!_range_x_dirty)
+      {
+        _range_x.min = std::min(_range_x.min, range.min);
+        _range_x.max = std::max(_range_x.max, range.max);
+      }
+    }
+    if constexpr (std::is_arithmetic_v<Value>)
+    {
+      const Range range = BatchRange(ys);
+      if (_points.empty())
+      {
+        _range_y = range;
+        _range_y_dirty = false;
+      }
+      else if (!_range_y_dirty)
+      {
+        _range_y.min = std::min(_range_y.min, range.min);
+        _range_y.max = std::max(_range_y.max, range.max);
+      }
+      if (_y_index.isBuilt())
+      {
+        for (const Value& y : ys)
+        {
+          _y_index.pushBack(y);
+        }
+      }
+    }
+    if (_range_tracking && !_range_tracker_dirty)
+    {
+      for (size_t i = 0; i < xs.size(); i++)
+      {
+        if constexpr (std::is_arithmetic_v<TypeX>)
+        {
+          if (!_sorted_x)
+          {
+            _x_tracker.pushBack(xs[i]);
+          }
+        }
+        if constexpr (std::is_arithmetic_v<Value>)
+        {
+          _y_tracker.pushBack(ys[i]);
+        }
+      }
+    }
+    _points.append(xs, ys);
+    markChanged();
+  }
+
+  // Overwrite the samples from the given index to the end with samples that are
+  // already validated and sorted. They may be more than the ones replaced, but the ranges
+  // are only extended: xs and ys must include the values of the replaced samples.
+  // The indices are cut at "index" and extended again: O(xs.size()), not O(size()).
+  void overwriteValidSamples(size_t index, Span<const TypeX> xs, Span<const Value> ys)
+  {
+    if (index >= _points.size())
+    {
+      appendValidSamples(xs, ys);
+      return;
+    }
+    if (xs.empty())
+    {
+      return;
+    }
+    if constexpr (std::is_arithmetic_v<TypeX>)
+    {
+      const Range range = BatchRange(xs);
+      if (!_range_x_dirty)
+      {
+        _range_x.min = std::min(_range_x.min, range.min);
+        _range_x.max = std::max(_range_x.max, range.max);
+      }
+    }
+    if constexpr (std::is_arithmetic_v<Value>)
+    {
+      const Range range = BatchRange(ys);
+      if (!_range_y_dirty)
+      {
+        _range_y.min = std::min(_range_y.min, range.min);
+        _range_y.max = std::max(_range_y.max, range.max);
+      }
+    }
+    truncateIndices(index);
+    _points.overwrite(index, xs, ys);
+    extendIndices(index);
+    markChanged();
+  }
+
+  // Remove the samples from "index" to the end from _y_index and from the trackers.
+  // Must be called before modifying them; the samples before "index" are unchanged and
+  // the removed ones must be among the ones added again by extendIndices().
+  void truncateIndices(size_t index)
+  {
+    if constexpr (std::is_arithmetic_v<Value>)
+    {
+      _y_index.truncate(_points, index);
+    }
+    if (_range_tracking && !_range_tracker_dirty)
+    {
+      _x_tracker.truncate(index);
+      _y_tracker.truncate(index);
+    }
+  }
+
+  // Add the samples from "index" to the end to _y_index and to the trackers,
+  // after truncateIndices(index) and the modification.
+  void extendIndices(size_t index)
+  {
+    const auto& points = _points;
+    const bool tracking = _range_tracking && !_range_tracker_dirty;
+    for (size_t i = index; i < points.size(); i++)
+    {
+      const auto& p = points[i];
+      if constexpr (std::is_arithmetic_v<TypeX>)
+      {
+        if (tracking && !_sorted_x)
+        {
+          _x_tracker.pushBack(p.x);
+        }
+      }
+      if constexpr (std::is_arithmetic_v<Value>)
+      {
+        if (_y_index.isBuilt())
+        {
+          _y_index.pushBack(p.y);
+        }
+        if (tracking)
+        {
+          _y_tracker.pushBack(p.y);
+        }
+      }
+    }
+  }
+
+  template <typename T>
+  static Range BatchRange(Span<const T> values)
+  {
+    // written without branches, so that the compiler can vectorize it
+    T min_value = values[0];
+    T max_value = values[0];
+    for (const T& value : values)
+    {
+      min_value = (value < min_value) ? value : min_value;
+      max_value = (value > max_value) ? value : max_value;
+    }
+    return Range{ static_cast<double>(min_value), static_cast<double>(max_value) };
+  }
+
   // template specialization for types that support compare operator
   virtual void pushUpdateRangeX(const Point& p)
   {
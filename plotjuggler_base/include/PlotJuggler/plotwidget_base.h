@@ -10,6 +10,7 @@
 #include <array>
 #include <QWidget>
 #include "plotdata.h"
+#include "latency_histogram.h"
 #include "timeseries_qwt.h"
 
 class QwtPlot;
@@ -135,6 +136,15 @@ public:
     return _line_width;
   }
 
+  /// When enabled, the curves are rasterized by a worker thread and the canvas
+  /// draws the last image available.
+  void setThreadedRendering(bool enable);
+
+  bool isThreadedRendering() const;
+
+  /// Time spent painting the canvas (curves, grid and markers), at each repaint.
+  const LatencyHistogram& paintLatency() const;
+
 public slots:
 
   void replot();
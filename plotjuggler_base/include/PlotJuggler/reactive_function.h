@@ -8,6 +8,7 @@
 #define REACTIVE_FUNCTION_H
 
 #include "PlotJuggler/transform_function.h"
+#include "PlotJuggler/series_cursor.h"
 #include <sol/sol.hpp>
 
 class TimeseriesRef;
@@ -34,6 +35,31 @@ struct TimeseriesRef
   void clear() const;
 
   PJ::PlotData* _plot_data = nullptr;
+
+  // scripts usually call atTime() with increasing time
+  mutable SeriesCursor<double> _cursor;
+};
+
+//-----------------------
+
+/// Read-only access to an ArraySeries: each sample is returned as a table of numbers.
+struct ArraySeriesRef
+{
+  ArraySeriesRef(const ArraySeries* data);
+
+  std::pair<double, std::vector<float>> at(unsigned i) const;
+
+  std::vector<float> atTime(double t) const;
+
+  int getIndexAtTime(double t) const;
+
+  unsigned size() const;
+
+  unsigned width() const;
+
+  const PJ::ArraySeries* _array = nullptr;
+
+  mutable SeriesCursor<ArrayRef> _cursor;
 };
 
 //-----------------------
@@ -126,6 +152,7 @@ protected:
   sol::protected_function _lua_function;
 
   sol::usertype<TimeseriesRef> _timeseries_ref;
+  sol::usertype<ArraySeriesRef> _array_ref;
   sol::usertype<CreatedSeriesTime> _created_timeseries;
   sol::usertype<CreatedSeriesXY> _created_scatter;
 
@@ -0,0 +1,81 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_RETENTION_POLICY_H
+#define PJ_RETENTION_POLICY_H
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace PJ
+{
+/**
+ * @brief Limits of the samples kept by a timeseries. When any of them is exceeded,
+ * the oldest samples are removed (see TimeseriesBase::setRetentionPolicy()).
+ *
+ * They are applied in addition to TimeseriesBase::setMaximumRangeX(), the time window
+ * that is common to all the series.
+ */
+struct RetentionPolicy
+{
+  /// Maximum difference between the newest and the oldest sample.
+  double max_seconds = std::numeric_limits<double>::max();
+  /// Maximum number of samples. 0 means no limit.
+  size_t max_samples = 0;
+  /// Maximum memory used by the samples (approximate, see SeriesStorage::memoryUsage()).
+  /// 0 means no limit.
+  size_t max_bytes = 0;
+
+  bool isLimited() const
+  {
+    return max_seconds < std::numeric_limits<double>::max() || max_samples > 0 || max_bytes > 0;
+  }
+
+  bool operator==(const RetentionPolicy& other) const
+  {
+    return max_seconds == other.max_seconds && max_samples == other.max_samples &&
+           max_bytes == other.max_bytes;
+  }
+
+  bool operator!=(const RetentionPolicy& other) const
+  {
+    return !(*this == other);
+  }
+};
+
+/**
+ * @brief Policy of the series whose name starts with "prefix", usually the name of a topic
+ * or of a group. An empty prefix matches all the series.
+ */
+struct RetentionRule
+{
+  std::string prefix;
+  RetentionPolicy policy;
+};
+
+using RetentionRules = std::vector<RetentionRule>;
+
+/// Policy of the rule with the longest prefix that matches the name,
+/// or a policy without limits, if there is none.
+inline RetentionPolicy FindRetentionPolicy(const RetentionRules& rules, const std::string& name)
+{
+  const RetentionRule* best = nullptr;
+  for (const auto& rule : rules)
+  {
+    if (name.compare(0, rule.prefix.size(), rule.prefix) == 0 &&
+        (!best || rule.prefix.size() > best->prefix.size()))
+    {
+      best = &rule;
+    }
+  }
+  return best ? best->policy : RetentionPolicy();
+}
+
+}  // namespace PJ
+
+#endif  // PJ_RETENTION_POLICY_H
@@ -0,0 +1,184 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_SERIES_CURSOR_H
+#define PJ_SERIES_CURSOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+#include "PlotJuggler/timeseries.h"
+
+namespace PJ
+{
+/**
+ * @brief Search of samples by time that remembers the position of the previous query.
+ *
+ * The search starts from the last position found and moves with exponentially
+ * growing steps (galloping search): when the queries have increasing (or decreasing)
+ * time, as in a replay or while merging series, each one costs O(1) amortized
+ * instead of O(log N).
+ *
+ * With setInterpolation(true), each search starts instead from the position estimated
+ * assuming that the series is uniformly sampled; this is better for random access.
+ *
+ * The results are always the same of the corresponding methods of TimeseriesBase,
+ * even if the series was modified after the previous query: the remembered position
+ * is only a starting point.
+ */
+template <typename Value>
+class SeriesCursor
+{
+public:
+  using Series = TimeseriesBase<Value>;
+
+  SeriesCursor() = default;
+
+  explicit SeriesCursor(const Series* series) : _series(series)
+  {
+  }
+
+  void setSeries(const Series* series)
+  {
+    _series = series;
+    _hint = NO_HINT;
+  }
+
+  const Series* series() const
+  {
+    return _series;
+  }
+
+  void setInterpolation(bool enable)
+  {
+    _interpolation = enable;
+  }
+
+  /// Forget the position of the previous query.
+  void reset()
+  {
+    _hint = NO_HINT;
+  }
+
+  /// Same as TimeseriesBase::lowerBoundIndex()
+  size_t lowerBound(double x)
+  {
+    const size_t size = _series->size();
+    if (size == 0)
+    {
+      return 0;
+    }
+    const size_t start = (_interpolation || _hint >= size) ? interpolate(x, size) : _hint;
+
+    size_t lo = 0;     // first candidate
+    size_t hi = size;  // last candidate; "size" means that all the samples are smaller than x
+    if (xAt(start) < x)
+    {
+      // gallop forward
+      lo = start + 1;
+      for (size_t step = 1; start + step < size; step *= 2)
+      {
+        if (!(xAt(start + step) < x))
+        {
+          hi = start + step;
+          break;
+        }
+        lo = start + step + 1;
+      }
+    }
+    else
+    {
+      // gallop backward
+      hi = start;
+      for (size_t step = 1; step <= start; step *= 2)
+      {
+        if (xAt(start - step) < x)
+        {
+          lo = start - step + 1;
+          break;
+        }
+        hi = start - step;
+      }
+    }
+    // binary search in [lo, hi]
+    while (lo < hi)
+    {
+      const size_t mid = lo + (hi - lo) / 2;
+      if (xAt(mid) < x)
+      {
+        lo = mid + 1;
+      }
+      else
+      {
+        hi = mid;
+      }
+    }
+    _hint = std::min(lo, size - 1);
+    return lo;
+  }
+
+  /// Same as TimeseriesBase::getIndexFromX()
+  int indexFromX(double x)
+  {
+    const size_t size = _series->size();
+    if (size == 0)
+    {
+      return -1;
+    }
+    size_t index = lowerBound(x);
+    if (index >= size)
+    {
+      return static_cast<int>(size - 1);
+    }
+    if (index > 0 && (std::abs(xAt(index - 1) - x) < std::abs(xAt(index) - x)))
+    {
+      index--;
+    }
+    return static_cast<int>(index);
+  }
+
+  /// Same as TimeseriesBase::getYfromX()
+  std::optional<Value> yFromX(double x)
+  {
+    const int index = indexFromX(x);
+    return (index < 0) ? std::nullopt : std::optional<Value>(_series->at(index).y);
+  }
+
+private:
+  static constexpr size_t NO_HINT = std::numeric_limits<size_t>::max();
+
+  const Series* _series = nullptr;
+  size_t _hint = NO_HINT;
+  bool _interpolation = false;
+
+  double xAt(size_t index) const
+  {
+    return _series->at(index).x;
+  }
+
+  // position of x, if the samples were equally spaced between the first and the last one
+  size_t interpolate(double x, size_t size) const
+  {
+    const double front = xAt(0);
+    const double back = xAt(size - 1);
+    if (!(x > front) || size == 1)
+    {
+      return 0;
+    }
+    if (!(x < back))
+    {
+      return size - 1;
+    }
+    const double ratio = (x - front) / (back - front);
+    return std::min(size - 1, static_cast<size_t>(ratio * static_cast<double>(size - 1)));
+  }
+};
+
+}  // namespace PJ
+
+#endif  // PJ_SERIES_CURSOR_H
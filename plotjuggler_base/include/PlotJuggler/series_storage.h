@@ -0,0 +1,1155 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_SERIES_STORAGE_H
+#define PJ_SERIES_STORAGE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "PlotJuggler/contrib/span.hpp"
+#include "PlotJuggler/chunk_codec.h"
+
+namespace PJ
+{
+template <typename T>
+using Span = nonstd::span<T>;
+
+/**
+ * @brief Proxy returned by SeriesStorage::mutableAt() (and by the const accessors, for
+ * values that are not trivially copyable). It exposes the members "x" and "y", exactly
+ * like a Point, but they are references to the values stored in the two separate arrays.
+ */
+template <typename PointT, typename RefX, typename RefY>
+class PointRefT
+{
+public:
+  RefX& x;
+  RefY& y;
+
+  PointRefT(RefX& x_ref, RefY& y_ref) : x(x_ref), y(y_ref)
+  {
+  }
+
+  operator PointT() const
+  {
+    return PointT(x, y);
+  }
+};
+
+/**
+ * @brief Timestamps shared by several series, typically the ones created from the
+ * fields of the same message (see PlotGroup::timeColumn()).
+ *
+ * The column is append-only and organized in blocks of the same size of the
+ * chunks of SeriesStorage: a series that follows the column stores only its
+ * y values and a reference to the blocks. A block is released when no series
+ * refers to it anymore.
+ */
+class TimeColumn
+{
+public:
+  using Ptr = std::shared_ptr<TimeColumn>;
+  using Block = std::vector<double>;
+
+  static constexpr size_t BLOCK_SHIFT = 12;
+  static constexpr size_t BLOCK_SIZE = size_t(1) << BLOCK_SHIFT;
+  static constexpr size_t BLOCK_MASK = BLOCK_SIZE - 1;
+
+  /// Number of values ever appended, including the ones of released blocks.
+  size_t size() const
+  {
+    return _size;
+  }
+
+  /// Block with the given index, or nullptr if it was released.
+  std::shared_ptr<const Block> block(size_t index) const
+  {
+    if (index < _first_block || index - _first_block >= _blocks.size())
+    {
+      return {};
+    }
+    return _blocks[index - _first_block];
+  }
+
+  /**
+   * @brief Position where a series that is empty should start to follow the column,
+   * in order to store its first value "x". Returns false if there is no such position.
+   */
+  bool startPosition(double x, size_t& position) const
+  {
+    if (_size == 0 || _blocks.back()->back() < x)
+    {
+      position = _size;
+      return true;
+    }
+    // search the first occurrence of x, assuming that the values are sorted
+    for (size_t b = 0; b < _blocks.size(); b++)
+    {
+      const Block& values = *_blocks[b];
+      if (values.back() < x)
+      {
+        continue;
+      }
+      const auto it = std::lower_bound(values.begin(), values.end(), x);
+      if (it == values.end() || *it != x)
+      {
+        return false;
+      }
+      position = ((_first_block + b) << BLOCK_SHIFT) + std::distance(values.begin(), it);
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief A series stores the value "x" at the given position of the column.
+   * If position is the end of the column, x is appended.
+   * Returns false if the column contains a different value in that position.
+   */
+  bool follow(size_t position, double x)
+  {
+    if (position == _size)
+    {
+      append(x);
+      return true;
+    }
+    return contains(position, x);
+  }
+
+  /// True if the value in the given position (not released yet) is x.
+  bool contains(size_t position, double x) const
+  {
+    const auto values = block(position >> BLOCK_SHIFT);
+    return position < _size && values && (*values)[position & BLOCK_MASK] == x;
+  }
+
+private:
+  std::deque<std::shared_ptr<Block>> _blocks;
+  size_t _first_block = 0;
+  size_t _size = 0;
+
+  void append(double x)
+  {
+    if ((_size & BLOCK_MASK) == 0)
+    {
+      // release the blocks that are referenced only by the column
+      while (!_blocks.empty() && _blocks.front().use_count() == 1)
+      {
+        _blocks.pop_front();
+        _first_block++;
+      }
+      if (_blocks.empty())
+      {
+        _first_block = _size >> BLOCK_SHIFT;
+      }
+      // full capacity: the values are never moved while series are reading them
+      auto new_block = std::make_shared<Block>();
+      new_block->reserve(BLOCK_SIZE);
+      _blocks.push_back(std::move(new_block));
+    }
+    _blocks.back()->push_back(x);
+    _size++;
+  }
+};
+
+/**
+ * @brief Storage of a series as a list of chunks with a fixed capacity.
+ *
+ * Each chunk keeps the x and y values in two separate contiguous arrays
+ * (struct-of-arrays), therefore algorithms that need only one of the two
+ * coordinates can use chunkX() and chunkY() directly.
+ *
+ * Invariant: all the chunks are full, except the last one.
+ * Samples removed with pop_front() are not erased from the first chunk;
+ * the chunk itself is released when all its samples were popped.
+ *
+ * When compression is enabled (only if both x and y are double), all the chunks
+ * except the last HOT_CHUNKS are "sealed", i.e. encoded with ChunkCodec
+ * (only y, if the chunk refers to the block of a TimeColumn).
+ * A sealed chunk is decoded on demand into a small cache of the DECODE_CACHE_SIZE chunks
+ * used most recently: the spans returned by chunkX() and chunkY() remain valid until
+ * DECODE_CACHE_SIZE other sealed chunks are accessed. Modifying a sample of a sealed chunk
+ * (mutableAt() or setY()) decodes it permanently; it will be sealed again when a new chunk
+ * is added.
+ *
+ * A series can follow a TimeColumn (see setTimeColumn()): as long as the x values
+ * pushed are the same of the column, the chunks refer to its blocks instead of
+ * storing their own copy. Otherwise, the series stops following the column.
+ * Two storages that follow the same column are aligned by index (see columnPosition()).
+ *
+ * Copies are snapshots: they share the chunks with the original (copy-on-write), so
+ * copying costs O(number of chunks) and no sample is copied. A chunk is duplicated
+ * only when one of the storages that share it modifies it; the only exception is the
+ * last chunk, where the original can keep appending samples in place, since a copy
+ * never reads beyond its own size.
+ * Therefore, a copy made by the thread that modifies the original can be read
+ * by another thread (each reader must use its own copy, because of the cache of
+ * the decoded chunk).
+ */
+template <typename PointT>
+class SeriesStorage
+{
+public:
+  using TypeX = decltype(PointT::x);
+  using Value = decltype(PointT::y);
+
+  static constexpr size_t CHUNK_SHIFT = TimeColumn::BLOCK_SHIFT;
+  static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_SHIFT;
+  static constexpr size_t CHUNK_MASK = CHUNK_SIZE - 1;
+  static constexpr size_t HOT_CHUNKS = 2;
+  static constexpr size_t DECODE_CACHE_SIZE = 4;
+  static constexpr bool COMPRESSIBLE =
+      std::is_same_v<TypeX, double> && std::is_same_v<Value, double>;
+  static constexpr bool SHAREABLE = std::is_same_v<TypeX, double>;
+
+  using Reference = PointRefT<PointT, TypeX, Value>;
+
+  // Trivial types are returned by value, the others by const reference
+  using ConstReference =
+      std::conditional_t<std::is_trivially_copyable_v<TypeX> && std::is_trivially_copyable_v<Value>,
+                         PointT, PointRefT<PointT, const TypeX, const Value>>;
+
+  // Read-only: samples are modified explicitly, with mutableAt() or setY()
+  class ConstIterator
+  {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = PointT;
+    using difference_type = std::ptrdiff_t;
+    using reference = ConstReference;
+
+    // the samples are not stored as Point: it->x refers to a temporary
+    struct pointer
+    {
+      reference ref;
+
+      const reference* operator->() const
+      {
+        return &ref;
+      }
+    };
+
+    ConstIterator() = default;
+
+    ConstIterator(const SeriesStorage* owner, size_t index) : _owner(owner), _index(index)
+    {
+    }
+
+    size_t index() const
+    {
+      return _index;
+    }
+
+    reference operator*() const
+    {
+      return (*_owner)[_index];
+    }
+
+    pointer operator->() const
+    {
+      return pointer{ (*_owner)[_index] };
+    }
+
+    reference operator[](difference_type n) const
+    {
+      return (*_owner)[_index + n];
+    }
+
+    ConstIterator& operator++()
+    {
+      ++_index;
+      return *this;
+    }
+
+    ConstIterator operator++(int)
+    {
+      ConstIterator prev = *this;
+      ++_index;
+      return prev;
+    }
+
+    ConstIterator& operator--()
+    {
+      --_index;
+      return *this;
+    }
+
+    ConstIterator operator--(int)
+    {
+      ConstIterator prev = *this;
+      --_index;
+      return prev;
+    }
+
+    ConstIterator& operator+=(difference_type n)
+    {
+      _index += n;
+      return *this;
+    }
+
+    ConstIterator& operator-=(difference_type n)
+    {
+      _index -= n;
+      return *this;
+    }
+
+    ConstIterator operator+(difference_type n) const
+    {
+      return ConstIterator(_owner, _index + n);
+    }
+
+    ConstIterator operator-(difference_type n) const
+    {
+      return ConstIterator(_owner, _index - n);
+    }
+
+    difference_type operator-(const ConstIterator& other) const
+    {
+      return difference_type(_index) - difference_type(other._index);
+    }
+
+    bool operator==(const ConstIterator& other) const
+    {
+      return _index == other._index;
+    }
+
+    bool operator!=(const ConstIterator& other) const
+    {
+      return _index != other._index;
+    }
+
+    bool operator<(const ConstIterator& other) const
+    {
+      return _index < other._index;
+    }
+
+    bool operator>(const ConstIterator& other) const
+    {
+      return _index > other._index;
+    }
+
+    bool operator<=(const ConstIterator& other) const
+    {
+      return _index <= other._index;
+    }
+
+    bool operator>=(const ConstIterator& other) const
+    {
+      return _index >= other._index;
+    }
+
+  private:
+    const SeriesStorage* _owner = nullptr;
+    size_t _index = 0;
+  };
+
+  SeriesStorage() = default;
+
+  SeriesStorage(const SeriesStorage& other)
+  {
+    *this = other;
+  }
+
+  SeriesStorage(SeriesStorage&& other)
+  {
+    *this = std::move(other);
+  }
+
+  // the chunks are shared, not copied
+  SeriesStorage& operator=(const SeriesStorage& other)
+  {
+    if (this != &other)
+    {
+      _chunks = other._chunks;
+      _front_offset = other._front_offset;
+      _size = other._size;
+      _compression = other._compression;
+      _unsealed_cold = other._unsealed_cold;
+      _owns_tail = false;
+      _decoded = {};
+      _column = other._column;
+      _column_chunk = other._column_chunk;
+    }
+    return *this;
+  }
+
+  SeriesStorage& operator=(SeriesStorage&& other)
+  {
+    _chunks = std::move(other._chunks);
+    _front_offset = std::exchange(other._front_offset, 0);
+    _size = std::exchange(other._size, 0);
+    _compression = other._compression;
+    _unsealed_cold = std::exchange(other._unsealed_cold, false);
+    _owns_tail = std::exchange(other._owns_tail, true);
+    _decoded = std::move(other._decoded);
+    _decode_clock = other._decode_clock;
+    _column = std::move(other._column);
+    _column_chunk = other._column_chunk;
+    other._chunks.clear();
+    other._decoded = {};
+    return *this;
+  }
+
+  size_t size() const
+  {
+    return _size;
+  }
+
+  bool empty() const
+  {
+    return _size == 0;
+  }
+
+  void clear()
+  {
+    _chunks.clear();
+    _front_offset = 0;
+    _size = 0;
+    _unsealed_cold = false;
+    _owns_tail = true;
+    _decoded = {};
+  }
+
+  /**
+   * @brief Follow the given column (or stop following, if nullptr).
+   *
+   * If the storage is not empty, it follows the column only if its x values are
+   * sorted and either already in the column or newer than its last value (they are
+   * appended to the column). In that case the chunks are rebuilt, in O(size()),
+   * to refer to the blocks of the column.
+   */
+  void setTimeColumn(TimeColumn::Ptr column)
+  {
+    if constexpr (SHAREABLE)
+    {
+      if (column && column == _column)
+      {
+        return;
+      }
+      detachColumn();
+      if (empty())
+      {
+        _column = std::move(column);
+      }
+      else if (column)
+      {
+        attachColumn(std::move(column));
+      }
+    }
+  }
+
+  const TimeColumn::Ptr& timeColumn() const
+  {
+    return _column;
+  }
+
+  /**
+   * @brief Position in timeColumn() of the x value of the first sample.
+   * Valid only if the storage is not empty and follows a column: the sample "i"
+   * has the x value stored in the position columnPosition() + i.
+   */
+  size_t columnPosition() const
+  {
+    return (_column_chunk << CHUNK_SHIFT) + _front_offset;
+  }
+
+  /// Compress the older chunks. It has effect only if both x and y are double.
+  void setCompression(bool enable)
+  {
+    if constexpr (COMPRESSIBLE)
+    {
+      _compression = enable;
+      for (size_t c = 0; c < _chunks.size(); c++)
+      {
+        if (enable && c + HOT_CHUNKS < _chunks.size())
+        {
+          seal(c);
+        }
+        else if (_chunks[c]->sealed)
+        {
+          unseal(mutableChunk(c));
+        }
+      }
+      _unsealed_cold = false;
+    }
+  }
+
+  bool compression() const
+  {
+    return _compression;
+  }
+
+  /// Approximate memory used by the samples, in bytes.
+  /// The chunks shared with other storages (or the blocks of a TimeColumn) are split among them.
+  size_t memoryUsage() const
+  {
+    size_t bytes = 0;
+    for (const auto& chunk : _chunks)
+    {
+      size_t chunk_bytes = sizeof(Chunk) + chunk->x.capacity() * sizeof(TypeX) +
+                           chunk->y.capacity() * sizeof(Value) +
+                           chunk->packed.capacity() * sizeof(uint64_t);
+      if (chunk->shared_x)
+      {
+        chunk_bytes += chunk->shared_x->capacity() * sizeof(TypeX) / chunk->shared_x.use_count();
+      }
+      bytes += chunk_bytes / chunk.use_count();
+    }
+    for (const auto& decoded : _decoded)
+    {
+      bytes += decoded.x.capacity() * sizeof(TypeX) + decoded.y.capacity() * sizeof(Value);
+    }
+    return bytes;
+  }
+
+  ConstReference operator[](size_t index) const
+  {
+    const size_t pos = index + _front_offset;
+    const Chunk& chunk = *_chunks[pos >> CHUNK_SHIFT];
+    const size_t offset = pos & CHUNK_MASK;
+    if constexpr (COMPRESSIBLE)
+    {
+      if (chunk.sealed)
+      {
+        const Decoded& decoded = decode(chunk);
+        const TypeX& x = chunk.shared_x ? (*chunk.shared_x)[offset] : decoded.x[offset];
+        return ConstReference(x, decoded.y[offset]);
+      }
+    }
+    return ConstReference(chunk.xData()[offset], chunk.y[offset]);
+  }
+
+  /**
+   * @brief Mutable access to a sample. A sealed chunk is decoded permanently and
+   * the storage stops following the column, since x might be modified.
+   * To modify only y, use setY().
+   */
+  Reference mutableAt(size_t index)
+  {
+    detachColumn();
+    const size_t pos = index + _front_offset;
+    Chunk& chunk = mutableChunk(pos >> CHUNK_SHIFT);
+    const size_t offset = pos & CHUNK_MASK;
+    unseal(chunk);
+    ownX(chunk);
+    return Reference(chunk.x[offset], chunk.y[offset]);
+  }
+
+  /// Replace the y value of a sample. The x values stay shared with the column.
+  void setY(size_t index, Value y)
+  {
+    const size_t pos = index + _front_offset;
+    Chunk& chunk = mutableChunk(pos >> CHUNK_SHIFT);
+    unseal(chunk);
+    chunk.y[pos & CHUNK_MASK] = std::move(y);
+  }
+
+  ConstReference front() const
+  {
+    return (*this)[0];
+  }
+
+  ConstReference back() const
+  {
+    return (*this)[_size - 1];
+  }
+
+  ConstIterator begin() const
+  {
+    return ConstIterator(this, 0);
+  }
+
+  ConstIterator end() const
+  {
+    return ConstIterator(this, _size);
+  }
+
+  void push_back(const PointT& p)
+  {
+    Chunk& chunk = tailChunk(p.x);
+    if (!chunk.shared_x)
+    {
+      chunk.x.push_back(p.x);
+    }
+    chunk.y.push_back(p.y);
+    _size++;
+  }
+
+  void push_back(PointT&& p)
+  {
+    Chunk& chunk = tailChunk(p.x);
+    if (!chunk.shared_x)
+    {
+      chunk.x.push_back(std::move(p.x));
+    }
+    chunk.y.push_back(std::move(p.y));
+    _size++;
+  }
+
+  /// Same as calling push_back() for each sample, but the chunks are filled with bulk copies.
+  void append(Span<const TypeX> xs, Span<const Value> ys)
+  {
+    size_t i = 0;
+    while (i < xs.size())
+    {
+      if (_column)
+      {
+        // each x must be compared with the column
+        push_back(PointT(xs[i], ys[i]));
+        i++;
+        continue;
+      }
+      Chunk& chunk = tailChunk(xs[i]);
+      size_t count = std::min(xs.size() - i, CHUNK_SIZE - chunk.y.size());
+      if (!isExclusive(_chunks.back()))
+      {
+        // shared with a copy: it can not be reallocated
+        count = std::min(count, chunk.y.capacity() - chunk.y.size());
+      }
+      else if (chunk.y.size() + count > chunk.y.capacity())
+      {
+        const size_t new_capacity =
+            std::min(CHUNK_SIZE, std::max(chunk.y.size() + count, chunk.y.capacity() * 2));
+        chunk.x.reserve(new_capacity);
+        chunk.y.reserve(new_capacity);
+      }
+      chunk.x.insert(chunk.x.end(), xs.begin() + i, xs.begin() + i + count);
+      chunk.y.insert(chunk.y.end(), ys.begin() + i, ys.begin() + i + count);
+      _size += count;
+      i += count;
+    }
+  }
+
+  void pop_front()
+  {
+    if (_size == 0)
+    {
+      return;
+    }
+    if constexpr (!std::is_trivially_destructible_v<Value>)
+    {
+      // release the resources of the value, the slot itself is reused only
+      // when the entire chunk is released (or by the copies that share it)
+      if (isExclusive(_chunks.front()))
+      {
+        _chunks.front()->y[_front_offset] = Value();
+      }
+    }
+    _front_offset++;
+    _size--;
+    if (_front_offset == CHUNK_SIZE || _size == 0)
+    {
+      forgetDecoded(_chunks.front().get());
+      _chunks.pop_front();
+      _front_offset = 0;
+      _column_chunk++;
+    }
+  }
+
+  /**
+   * @brief Overwrite the samples starting from the given index with xs and ys.
+   * The ones that go beyond the end are appended. index must not be larger than size().
+   */
+  void overwrite(size_t index, Span<const TypeX> xs, Span<const Value> ys)
+  {
+    const size_t count = std::min(xs.size(), _size - index);
+    if (count > 0)
+    {
+      // x is modified: the samples can not refer to the column anymore
+      detachColumn();
+    }
+    size_t i = 0;
+    while (i < count)
+    {
+      const size_t pos = index + i + _front_offset;
+      Chunk& chunk = mutableChunk(pos >> CHUNK_SHIFT);
+      unseal(chunk);
+      ownX(chunk);
+      const size_t offset = pos & CHUNK_MASK;
+      const size_t n = std::min(count - i, chunk.y.size() - offset);
+      std::copy(xs.begin() + i, xs.begin() + i + n, chunk.x.begin() + offset);
+      std::copy(ys.begin() + i, ys.begin() + i + n, chunk.y.begin() + offset);
+      i += n;
+    }
+    append(xs.subspan(count), ys.subspan(count));
+  }
+
+  /// Insert a sample before the given index, shifting the following ones by one position.
+  void insert(size_t index, PointT&& p)
+  {
+    if (index >= _size)
+    {
+      push_back(std::move(p));
+      return;
+    }
+    // the following samples are shifted: they can not refer to the column anymore
+    detachColumn();
+
+    // grow by one, duplicating the last sample
+    push_back(PointT(std::as_const(*this)[_size - 1]));
+
+    const size_t pos_first = index + _front_offset;
+    const size_t pos_last = _size - 1 + _front_offset;
+    const size_t chunk_first = pos_first >> CHUNK_SHIFT;
+
+    for (size_t c = chunk_first; c < _chunks.size(); c++)
+    {
+      Chunk& chunk = mutableChunk(c);
+      unseal(chunk);
+      ownX(chunk);
+    }
+
+    for (size_t c = pos_last >> CHUNK_SHIFT;; c--)
+    {
+      Chunk& chunk = *_chunks[c];
+      const size_t lo = (c == chunk_first) ? (pos_first & CHUNK_MASK) : 0;
+      const size_t hi = (c == (pos_last >> CHUNK_SHIFT)) ? (pos_last & CHUNK_MASK) : CHUNK_MASK;
+      std::move_backward(chunk.x.begin() + lo, chunk.x.begin() + hi, chunk.x.begin() + hi + 1);
+      std::move_backward(chunk.y.begin() + lo, chunk.y.begin() + hi, chunk.y.begin() + hi + 1);
+      if (c == chunk_first)
+      {
+        break;
+      }
+      // the last sample of the previous chunk becomes the first of this one
+      Chunk& prev = *_chunks[c - 1];
+      chunk.x[0] = std::move(prev.x[CHUNK_MASK]);
+      chunk.y[0] = std::move(prev.y[CHUNK_MASK]);
+    }
+    Chunk& chunk = *_chunks[chunk_first];
+    chunk.x[pos_first & CHUNK_MASK] = std::move(p.x);
+    chunk.y[pos_first & CHUNK_MASK] = std::move(p.y);
+  }
+
+  //---------- direct access to the chunks ----------
+
+  size_t chunkCount() const
+  {
+    return _chunks.size();
+  }
+
+  /// Index (as used by operator[]) of the first sample of the chunk
+  size_t chunkFirstIndex(size_t chunk) const
+  {
+    return (chunk == 0) ? 0 : (chunk << CHUNK_SHIFT) - _front_offset;
+  }
+
+  Span<const TypeX> chunkX(size_t chunk) const
+  {
+    const Chunk& ch = *_chunks[chunk];
+    const size_t first = (chunk == 0) ? _front_offset : 0;
+    if constexpr (COMPRESSIBLE)
+    {
+      if (ch.sealed && !ch.shared_x)
+      {
+        const auto& xs = decode(ch).x;
+        return Span<const TypeX>(xs.data() + first, xs.size() - first);
+      }
+    }
+    return Span<const TypeX>(ch.xData() + first, chunkSlots(chunk) - first);
+  }
+
+  Span<const Value> chunkY(size_t chunk) const
+  {
+    const Chunk& ch = *_chunks[chunk];
+    const size_t first = (chunk == 0) ? _front_offset : 0;
+    if constexpr (COMPRESSIBLE)
+    {
+      if (ch.sealed)
+      {
+        const auto& ys = decode(ch).y;
+        return Span<const Value>(ys.data() + first, ys.size() - first);
+      }
+    }
+    return Span<const Value>(ch.y.data() + first, chunkSlots(chunk) - first);
+  }
+
+  /// Last x of the chunk. Unlike chunkX(), it never decodes a sealed chunk.
+  TypeX chunkBackX(size_t chunk) const
+  {
+    const Chunk& ch = *_chunks[chunk];
+    return ch.sealed ? ch.back_x : ch.xData()[chunkSlots(chunk) - 1];
+  }
+
+private:
+  struct Chunk
+  {
+    std::vector<TypeX> x;
+    std::vector<Value> y;
+    // when the chunk refers to a block of a TimeColumn, x is empty
+    std::shared_ptr<const std::vector<TypeX>> shared_x;
+    // when sealed, x and y are empty and the samples are encoded in "packed"
+    // (only the y values, if shared_x is used)
+    bool sealed = false;
+    std::vector<uint64_t> packed;
+    size_t packed_count = 0;
+    TypeX back_x = {};
+
+    // valid only if not sealed, or if shared_x is used
+    const TypeX* xData() const
+    {
+      return shared_x ? shared_x->data() : x.data();
+    }
+  };
+
+  struct Decoded
+  {
+    const Chunk* chunk = nullptr;
+    uint64_t last_use = 0;
+    std::vector<TypeX> x;
+    std::vector<Value> y;
+  };
+
+  // shared with the copies of this storage
+  std::deque<std::shared_ptr<Chunk>> _chunks;
+  size_t _front_offset = 0;
+  size_t _size = 0;
+
+  bool _compression = false;
+  // a chunk that is not in the hot tail was decoded by a mutable access
+  bool _unsealed_cold = false;
+  // the last chunk was created by this storage: it can append samples to it in place,
+  // even if it is shared
+  bool _owns_tail = true;
+  // least recently used sealed chunks, decoded
+  mutable std::array<Decoded, DECODE_CACHE_SIZE> _decoded;
+  mutable uint64_t _decode_clock = 0;
+
+  TimeColumn::Ptr _column;
+  // index of the block of the column that corresponds to the first chunk
+  size_t _column_chunk = 0;
+
+  const Decoded& decode(const Chunk& chunk) const
+  {
+    if constexpr (COMPRESSIBLE)
+    {
+      Decoded* entry = &_decoded[0];
+      for (auto& decoded : _decoded)
+      {
+        if (decoded.chunk == &chunk)
+        {
+          decoded.last_use = ++_decode_clock;
+          return decoded;
+        }
+        if (decoded.last_use < entry->last_use)
+        {
+          entry = &decoded;
+        }
+      }
+      entry->y.resize(chunk.packed_count);
+      if (chunk.shared_x)
+      {
+        entry->x.clear();
+        ChunkCodec::decodeValues(chunk.packed, chunk.packed_count, entry->y.data());
+      }
+      else
+      {
+        entry->x.resize(chunk.packed_count);
+        ChunkCodec::decode(chunk.packed, chunk.packed_count, entry->x.data(), entry->y.data());
+      }
+      entry->chunk = &chunk;
+      entry->last_use = ++_decode_clock;
+      return *entry;
+    }
+    return _decoded[0];
+  }
+
+  void forgetDecoded(const Chunk* chunk) const
+  {
+    for (auto& decoded : _decoded)
+    {
+      if (decoded.chunk == chunk)
+      {
+        decoded.chunk = nullptr;
+        decoded.last_use = 0;
+      }
+    }
+  }
+
+  // number of slots of the chunk used by this storage, including the ones before
+  // _front_offset. Unlike y.size(), it is not modified by other storages that share the chunk.
+  size_t chunkSlots(size_t chunk) const
+  {
+    return (chunk + 1 < _chunks.size()) ? CHUNK_SIZE
+                                        : (_front_offset + _size - (chunk << CHUNK_SHIFT));
+  }
+
+  // True if no other storage refers to the chunk. The storages that released it might have
+  // done so in another thread: their reads must happen before the chunk is modified, but
+  // use_count() doesn't synchronize with them, while releasing a reference does.
+  static bool isExclusive(const std::shared_ptr<Chunk>& chunk)
+  {
+    if (chunk.use_count() > 1)
+    {
+      return false;
+    }
+    std::shared_ptr<Chunk> sync = chunk;
+    return true;
+  }
+
+  // the chunk, duplicated first if it is shared with a copy
+  Chunk& mutableChunk(size_t c)
+  {
+    auto& chunk = _chunks[c];
+    const size_t slot_count = chunk->sealed ? chunk->packed_count : chunkSlots(c);
+    if (!isExclusive(chunk))
+    {
+      auto copy = std::make_shared<Chunk>();
+      copy->sealed = chunk->sealed;
+      copy->packed = chunk->packed;
+      copy->packed_count = chunk->packed_count;
+      copy->back_x = chunk->back_x;
+      copy->shared_x = chunk->shared_x;
+      if (!chunk->sealed)
+      {
+        size_t capacity = slot_count;
+        if (c + 1 == _chunks.size())
+        {
+          // the tail keeps growing geometrically
+          capacity = std::min(CHUNK_SIZE, std::max<size_t>(16, slot_count * 2));
+        }
+        if (!chunk->shared_x)
+        {
+          copy->x.reserve(capacity);
+          copy->x.assign(chunk->x.begin(), chunk->x.begin() + slot_count);
+        }
+        copy->y.reserve(capacity);
+        copy->y.assign(chunk->y.begin(), chunk->y.begin() + slot_count);
+      }
+      replaceChunk(c, std::move(copy));
+    }
+    else if (!chunk->sealed && chunk->y.size() > slot_count)
+    {
+      // samples appended by the storage that created the chunk, which does not exist anymore
+      chunk->y.resize(slot_count);
+      if (!chunk->shared_x)
+      {
+        chunk->x.resize(slot_count);
+      }
+    }
+    if (c + 1 == _chunks.size())
+    {
+      _owns_tail = true;
+    }
+    return *_chunks[c];
+  }
+
+  void replaceChunk(size_t c, std::shared_ptr<Chunk> chunk)
+  {
+    // the address of the old chunk might be reused
+    forgetDecoded(_chunks[c].get());
+    _chunks[c] = std::move(chunk);
+  }
+
+  void seal(size_t c)
+  {
+    if constexpr (COMPRESSIBLE)
+    {
+      const Chunk& chunk = *_chunks[c];
+      if (chunk.sealed || chunk.y.empty())
+      {
+        return;
+      }
+      // a new chunk replaces the old one, that might be shared
+      const size_t count = chunkSlots(c);
+      auto sealed = std::make_shared<Chunk>();
+      if (chunk.shared_x)
+      {
+        // x is stored once, by the column
+        sealed->shared_x = chunk.shared_x;
+        ChunkCodec::encodeValues(Span<const Value>(chunk.y.data(), count), sealed->packed);
+      }
+      else
+      {
+        ChunkCodec::encode(Span<const TypeX>(chunk.xData(), count),
+                           Span<const Value>(chunk.y.data(), count), sealed->packed);
+      }
+      sealed->packed_count = count;
+      sealed->back_x = chunk.xData()[count - 1];
+      sealed->sealed = true;
+      replaceChunk(c, std::move(sealed));
+    }
+  }
+
+  void unseal(Chunk& chunk)
+  {
+    if constexpr (COMPRESSIBLE)
+    {
+      if (!chunk.sealed)
+      {
+        return;
+      }
+      forgetDecoded(&chunk);
+      chunk.y.resize(chunk.packed_count);
+      if (chunk.shared_x)
+      {
+        ChunkCodec::decodeValues(chunk.packed, chunk.packed_count, chunk.y.data());
+      }
+      else
+      {
+        chunk.x.resize(chunk.packed_count);
+        ChunkCodec::decode(chunk.packed, chunk.packed_count, chunk.x.data(), chunk.y.data());
+      }
+      std::vector<uint64_t>().swap(chunk.packed);
+      chunk.sealed = false;
+      _unsealed_cold = _compression;
+    }
+  }
+
+  // copy the values of the column, before modifying x
+  void ownX(Chunk& chunk)
+  {
+    if (chunk.shared_x)
+    {
+      chunk.x.reserve(chunk.y.capacity());
+      chunk.x.assign(chunk.shared_x->begin(), chunk.shared_x->begin() + chunk.y.size());
+      chunk.shared_x.reset();
+    }
+  }
+
+  void detachColumn()
+  {
+    if (_column && !_chunks.empty())
+    {
+      ownX(mutableChunk(_chunks.size() - 1));
+    }
+    _column.reset();
+  }
+
+  // update the column with the next x pushed. Returns false if x is not the same of the column
+  bool followColumn(const TypeX& x)
+  {
+    if constexpr (SHAREABLE)
+    {
+      if (_size == 0)
+      {
+        size_t position = 0;
+        if (!_column->startPosition(x, position))
+        {
+          return false;
+        }
+        _front_offset = position & CHUNK_MASK;
+        _column_chunk = position >> CHUNK_SHIFT;
+      }
+      return _column->follow((_column_chunk << CHUNK_SHIFT) + _front_offset + _size, x);
+    }
+    return false;
+  }
+
+  // follow the column with the samples already stored, if their x values are in it
+  void attachColumn(TimeColumn::Ptr column)
+  {
+    if constexpr (SHAREABLE)
+    {
+      size_t start = 0;
+      if (!column->startPosition(front().x, start))
+      {
+        return;
+      }
+      // check everything first: the column is modified only if it can be followed
+      for (size_t i = 0; i < _size; i++)
+      {
+        const TypeX x = (*this)[i].x;
+        if ((i > 0 && x < (*this)[i - 1].x) ||
+            (start + i < column->size() && !column->contains(start + i, x)))
+        {
+          return;
+        }
+      }
+      SeriesStorage attached;
+      attached._compression = _compression;
+      attached._column = std::move(column);
+      for (size_t i = 0; i < _size; i++)
+      {
+        attached.push_back(PointT((*this)[i]));
+      }
+      *this = std::move(attached);
+    }
+  }
+
+  // all the chunks, except the last HOT_CHUNKS, are sealed
+  void sealColdChunks()
+  {
+    if (!_compression || _chunks.size() <= HOT_CHUNKS)
+    {
+      return;
+    }
+    const size_t cold_count = _chunks.size() - HOT_CHUNKS;
+    if (_unsealed_cold)
+    {
+      for (size_t c = 0; c < cold_count; c++)
+      {
+        seal(c);
+      }
+      _unsealed_cold = false;
+    }
+    else
+    {
+      seal(cold_count - 1);
+    }
+  }
+
+  // chunk where the next sample (with the given x) will be stored
+  Chunk& tailChunk(const TypeX& x)
+  {
+    if (_column && !followColumn(x))
+    {
+      detachColumn();
+    }
+    if (!_chunks.empty())
+    {
+      // The copies never read beyond their own size: the storage that owns the tail can append
+      // to it in place even if it is shared, as long as the vectors are not reallocated.
+      // Its size is always the one of the chunk, therefore the chunk is not full.
+      Chunk& tail = *_chunks.back();
+      if (_owns_tail && tail.y.size() < tail.y.capacity() &&
+          (tail.shared_x || tail.x.size() < tail.x.capacity()))
+      {
+        return tail;
+      }
+    }
+    if (_chunks.empty() || chunkSlots(_chunks.size() - 1) == CHUNK_SIZE)
+    {
+      auto new_chunk = std::make_shared<Chunk>();
+      if constexpr (SHAREABLE)
+      {
+        if (_column)
+        {
+          new_chunk->shared_x = _column->block(_column_chunk + _chunks.size());
+          // the slots before the first sample are never read
+          new_chunk->y.resize(_chunks.empty() ? _front_offset : 0);
+        }
+      }
+      _chunks.push_back(std::move(new_chunk));
+      sealColdChunks();
+    }
+    mutableChunk(_chunks.size() - 1);
+    Chunk& chunk = *_chunks.back();
+    // grow geometrically, but never above CHUNK_SIZE
+    if (chunk.y.size() == chunk.y.capacity())
+    {
+      const size_t new_capacity = std::min(CHUNK_SIZE, std::max<size_t>(16, chunk.y.size() * 2));
+      if (!chunk.shared_x)
+      {
+        chunk.x.reserve(new_capacity);
+      }
+      chunk.y.reserve(new_capacity);
+    }
+    return chunk;
+  }
+};
+
+}  // namespace PJ
+
+#endif  // PJ_SERIES_STORAGE_H
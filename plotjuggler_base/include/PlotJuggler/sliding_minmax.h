@@ -0,0 +1,128 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_SLIDING_MINMAX_H
+#define PJ_SLIDING_MINMAX_H
+
+#include <cstddef>
+#include <deque>
+
+namespace PJ
+{
+/**
+ * @brief Min and max of a sliding window, where values are added at the back
+ * and removed from the front. Each operation is O(1) amortized.
+ *
+ * Two monotonic queues are used: the first one contains the candidates to be
+ * the minimum, in increasing order, the second one the candidates to be
+ * the maximum, in decreasing order. A value stops being a candidate as soon as
+ * a newer one (that will leave the window later) is smaller, or larger.
+ */
+template <typename T>
+class SlidingMinMax
+{
+public:
+  void clear()
+  {
+    _min_queue.clear();
+    _max_queue.clear();
+    _pushed = 0;
+    _popped = 0;
+  }
+
+  bool empty() const
+  {
+    return _pushed == _popped;
+  }
+
+  void pushBack(const T& value)
+  {
+    while (!_min_queue.empty() && !(_min_queue.back().value < value))
+    {
+      _min_queue.pop_back();
+    }
+    _min_queue.push_back({ _pushed, value });
+
+    while (!_max_queue.empty() && !(value < _max_queue.back().value))
+    {
+      _max_queue.pop_back();
+    }
+    _max_queue.push_back({ _pushed, value });
+    _pushed++;
+  }
+
+  void popFront()
+  {
+    if (empty())
+    {
+      return;
+    }
+    if (_min_queue.front().position == _popped)
+    {
+      _min_queue.pop_front();
+    }
+    if (_max_queue.front().position == _popped)
+    {
+      _max_queue.pop_front();
+    }
+    _popped++;
+  }
+
+  /**
+   * @brief Remove the newest values, keeping the first "count" of the window.
+   *
+   * The removed values must be pushed again (possibly in another order, together with
+   * new ones), as when samples are merged into a series: the older values that were not
+   * candidates because of them stay dominated, therefore they don't need to be restored.
+   * O(number of removed candidates).
+   */
+  void truncate(size_t count)
+  {
+    const size_t end = _popped + count;
+    if (end >= _pushed)
+    {
+      return;
+    }
+    while (!_min_queue.empty() && _min_queue.back().position >= end)
+    {
+      _min_queue.pop_back();
+    }
+    while (!_max_queue.empty() && _max_queue.back().position >= end)
+    {
+      _max_queue.pop_back();
+    }
+    _pushed = end;
+  }
+
+  /// Undefined if empty()
+  const T& min() const
+  {
+    return _min_queue.front().value;
+  }
+
+  /// Undefined if empty()
+  const T& max() const
+  {
+    return _max_queue.front().value;
+  }
+
+private:
+  struct Entry
+  {
+    size_t position;
+    T value;
+  };
+  std::deque<Entry> _min_queue;
+  std::deque<Entry> _max_queue;
+  // positions count all the values ever pushed
+  size_t _pushed = 0;
+  size_t _popped = 0;
+
+};
+
+}  // namespace PJ
+
+#endif  // PJ_SLIDING_MINMAX_H
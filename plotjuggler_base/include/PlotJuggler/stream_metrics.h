@@ -0,0 +1,129 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_STREAM_METRICS_H
+#define PJ_STREAM_METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "PlotJuggler/latency_histogram.h"
+
+namespace PJ
+{
+/**
+ * @brief Counters of the messages received on a topic.
+ *
+ * The counters are cumulative: rates are computed by the reader, from the difference
+ * between two readings. They can be updated by one thread while others read them.
+ */
+struct TopicMetrics
+{
+  using Ptr = std::shared_ptr<TopicMetrics>;
+
+  std::atomic<uint64_t> messages = 0;
+  std::atomic<uint64_t> bytes = 0;
+  // messages discarded: the parser failed, or the streamer could not keep up
+  std::atomic<uint64_t> dropped = 0;
+  // time spent by MessageParser::parseMessage()
+  LatencyHistogram parse_latency;
+
+  void recordMessage(size_t size, std::chrono::nanoseconds parse_time)
+  {
+    messages.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    parse_latency.record(parse_time);
+  }
+
+  void recordDropped(uint64_t count = 1)
+  {
+    dropped.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  void reset()
+  {
+    messages.store(0, std::memory_order_relaxed);
+    bytes.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+    parse_latency.reset();
+  }
+};
+
+/**
+ * @brief Metrics of the data received by a DataStreamer: counters of each topic,
+ * time spent waiting for the mutex and amount of data queued, waiting to be processed
+ * (reported only by the streamers that can tell it, e.g. the bytes buffered by a port).
+ */
+class StreamMetrics
+{
+public:
+  /// Counters of the topic, created the first time. Keep the pointer: the lookup locks a mutex.
+  TopicMetrics::Ptr topic(const std::string& name)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto& metrics = _topics[name];
+    if (!metrics)
+    {
+      metrics = std::make_shared<TopicMetrics>();
+    }
+    return metrics;
+  }
+
+  /// All the topics, sorted by name.
+  std::vector<std::pair<std::string, TopicMetrics::Ptr>> topics() const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return { _topics.begin(), _topics.end() };
+  }
+
+  /// Time spent by the receiving thread to lock DataStreamer::mutex().
+  LatencyHistogram& lockWait()
+  {
+    return _lock_wait;
+  }
+
+  const LatencyHistogram& lockWait() const
+  {
+    return _lock_wait;
+  }
+
+  /// Bytes received and not processed yet.
+  void setPendingBytes(size_t bytes)
+  {
+    _pending_bytes.store(bytes, std::memory_order_relaxed);
+  }
+
+  size_t pendingBytes() const
+  {
+    return _pending_bytes.load(std::memory_order_relaxed);
+  }
+
+  /// Zero all the counters. The topics are kept, since their owners refer to them.
+  void reset()
+  {
+    for (const auto& it : topics())
+    {
+      it.second->reset();
+    }
+    _lock_wait.reset();
+    _pending_bytes.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  mutable std::mutex _mutex;
+  std::map<std::string, TopicMetrics::Ptr> _topics;
+  LatencyHistogram _lock_wait;
+  std::atomic<size_t> _pending_bytes = 0;
+};
+
+}  // namespace PJ
+
+#endif  // PJ_STREAM_METRICS_H
@@ -11,9 +11,11 @@
 #include "PlotJuggler/string_ref_sso.h"
 #include "PlotJuggler/string_dict_index.h"
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace PJ
@@ -36,8 +38,8 @@ public:
 
   virtual void clear() override
   {
-    _index_to_string.clear();
-    _string_to_index.clear();
+    // the copies might still use the dictionary
+    _dictionary = std::make_shared<Dictionary>();
     TimeseriesBase<StringDictIndex>::clear();
   }
 
@@ -66,11 +68,11 @@ public:
 
   std::string_view getString(StringDictIndex idx) const
   {
-    if (!idx.isValid() || idx.index >= _index_to_string.size())
+    if (!_dictionary || !idx.isValid() || idx.index >= _dictionary->index_to_string.size())
     {
       return {};
     }
-    return _index_to_string[idx.index];
+    return _dictionary->index_to_string[idx.index];
   }
 
   std::optional<std::string_view> getStringFromX(double x) const
@@ -85,43 +87,63 @@ public:
 
   void clonePoints(StringSeries&& other)
   {
-    _index_to_string = std::move(other._index_to_string);
-    _string_to_index = std::move(other._string_to_index);
+    _dictionary = std::exchange(other._dictionary, std::make_shared<Dictionary>());
     PlotDataBase<double, StringDictIndex>::clonePoints(std::move(other));
   }
 
+  // Both the samples and the dictionary are shared with "other" (copy-on-write):
+  // O(number of chunks), as PlotDataBase::clonePoints().
   void clonePoints(const StringSeries& other)
   {
-    _index_to_string = other._index_to_string;
-    _string_to_index = other._string_to_index;
+    _dictionary = other._dictionary;
     PlotDataBase<double, StringDictIndex>::clonePoints(other);
   }
 
   void swapData(StringSeries& other)
   {
     TimeseriesBase<StringDictIndex>::swapData(other);
-    std::swap(_index_to_string, other._index_to_string);
-    std::swap(_string_to_index, other._string_to_index);
+    std::swap(_dictionary, other._dictionary);
   }
 
 private:
+  // the strings, in the order they were added. Never modified while shared with a copy
+  struct Dictionary
+  {
+    std::vector<std::string> index_to_string;
+    std::unordered_map<std::string, uint32_t> string_to_index;
+  };
+
   StringDictIndex internString(std::string_view str)
   {
     _tmp_str.assign(str.data(), str.size());
-    auto it = _string_to_index.find(_tmp_str);
-    if (it != _string_to_index.end())
+    if (!_dictionary)
+    {
+      _dictionary = std::make_shared<Dictionary>();
+    }
+    auto it = _dictionary->string_to_index.find(_tmp_str);
+    if (it != _dictionary->string_to_index.end())
     {
       return StringDictIndex(it->second);
     }
-    uint32_t new_index = static_cast<uint32_t>(_index_to_string.size());
-    _index_to_string.push_back(_tmp_str);
-    _string_to_index.emplace(_tmp_str, new_index);
+    if (_dictionary.use_count() > 1)
+    {
+      // shared with a copy, that might be read by another thread
+      _dictionary = std::make_shared<Dictionary>(*_dictionary);
+    }
+    else
+    {
+      // a copy released by another thread: synchronize with it before writing
+      // (see SeriesStorage::isExclusive())
+      std::shared_ptr<Dictionary> sync = _dictionary;
+    }
+    uint32_t new_index = static_cast<uint32_t>(_dictionary->index_to_string.size());
+    _dictionary->index_to_string.push_back(_tmp_str);
+    _dictionary->string_to_index.emplace(_tmp_str, new_index);
     return StringDictIndex(new_index);
   }
 
   std::string _tmp_str;
-  std::vector<std::string> _index_to_string;
-  std::unordered_map<std::string, uint32_t> _string_to_index;
+  std::shared_ptr<Dictionary> _dictionary = std::make_shared<Dictionary>();
 };
 
 }  // namespace PJ
@@ -8,7 +8,12 @@
 #define PJ_TIMESERIES_H
 
 #include "plotdatabase.h"
+#include "retention_policy.h"
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <vector>
 
 namespace PJ
 {
@@ -25,6 +30,11 @@ public:
   TimeseriesBase(const std::string& name, PlotGroup::Ptr group)
     : PlotDataBase<double, Value>(name, group), _max_range_x(std::numeric_limits<double>::max())
   {
+    this->_sorted_x = true;
+    if (group)
+    {
+      _points.setTimeColumn(group->timeColumn());
+    }
   }
 
   TimeseriesBase(const TimeseriesBase& other) = delete;
@@ -38,9 +48,37 @@ public:
     return true;
   }
 
+  /// The series follows the time column of the new group, if its x values are in it.
+  void changeGroup(PlotGroup::Ptr group) override
+  {
+    PlotDataBase<double, Value>::changeGroup(group);
+    _points.setTimeColumn(group ? group->timeColumn() : nullptr);
+  }
+
+  /**
+   * @brief True if this series and "other" follow the same time column (same PlotGroup).
+   * In that case, the sample "i" of this series has the same x of the sample "i + offset"
+   * of the other one, and no search is needed to align them.
+   */
+  bool alignedWith(const TimeseriesBase& other, std::ptrdiff_t& offset) const
+  {
+    const auto& column = _points.timeColumn();
+    if (!column || column != other._points.timeColumn() || _points.empty() ||
+        other._points.empty())
+    {
+      return false;
+    }
+    offset = std::ptrdiff_t(_points.columnPosition()) -
+             std::ptrdiff_t(other._points.columnPosition());
+    return true;
+  }
+
   void setMaximumRangeX(double max_range)
   {
     _max_range_x = max_range;
+    // a sliding window: samples are continuously removed with popFront()
+    this->setRangeTracking(max_range < std::numeric_limits<double>::max() ||
+                           _retention.isLimited());
     trimRange();
   }
 
@@ -49,14 +87,167 @@ public:
     return _max_range_x;
   }
 
+  /**
+   * @brief Limits of this series, applied together with maximumRangeX():
+   * the oldest samples are removed as soon as one of them is exceeded.
+   */
+  void setRetentionPolicy(const RetentionPolicy& policy)
+  {
+    _retention = policy;
+    _measured_size = 0;
+    _measured_chunks = 0;
+    _bytes_per_sample = 0;
+    this->setRangeTracking(_max_range_x < std::numeric_limits<double>::max() ||
+                           _retention.isLimited());
+    trimRange();
+  }
+
+  const RetentionPolicy& retentionPolicy() const
+  {
+    return _retention;
+  }
+
+  /**
+   * @brief Remove the oldest samples, keeping at most the newest "count" ones.
+   * Used to release memory, see PlotDataMapRef::enforceMemoryBudget().
+   */
+  void keepNewest(size_t count)
+  {
+    while (_points.size() > count)
+    {
+      this->popFront();
+    }
+  }
+
+  /// Used to select the series to trim first, see PlotDataMapRef::markViewed().
+  void setLastViewed(uint64_t tick)
+  {
+    _last_viewed = tick;
+  }
+
+  uint64_t lastViewed() const
+  {
+    return _last_viewed;
+  }
+
+  /**
+   * @brief Keep the older samples in a compressed form (disabled by default).
+   * It has effect only on numeric series: see SeriesStorage and ChunkCodec.
+   *
+   * Meant for data that is mostly read, like the one loaded from a file: reading a
+   * compressed chunk requires decoding it. The x values shared with the time column of
+   * the group stay shared, only y is compressed.
+   */
+  void setCompression(bool enable)
+  {
+    _points.setCompression(enable);
+  }
+
+  bool compression() const
+  {
+    return _points.compression();
+  }
+
+  /**
+   * @brief Delay the insertion of the samples that are older than the last one.
+   *
+   * By default, a late sample is inserted immediately in the right position, that is O(N).
+   * With a window larger than zero, late samples are kept in a small buffer instead and
+   * merged all together in a single pass when:
+   *
+   * - the last timestamp is more than "window" seconds newer than the oldest late sample
+   *   (the watermark advanced), or
+   * - flushLateSamples() is called, before reading the data, or
+   * - too many late samples are pending.
+   *
+   * Until then, the late samples are not visible (they are not counted by size()).
+   */
+  void setReorderWindow(double window)
+  {
+    _reorder_window = window;
+    if (_reorder_window <= 0)
+    {
+      flushLateSamples();
+    }
+  }
+
+  double reorderWindow() const
+  {
+    return _reorder_window;
+  }
+
+  /// Number of late samples not merged yet. See setReorderWindow()
+  size_t pendingLateSamples() const
+  {
+    return _late_samples.size();
+  }
+
+  /// Merge the pending late samples. O(K log K + M), where K is the number of late
+  /// samples and M the number of stored samples newer than the oldest of them.
+  void flushLateSamples()
+  {
+    if (_late_samples.empty())
+    {
+      return;
+    }
+    std::vector<Point> late;
+    late.swap(_late_samples);
+    // stable: samples with the same x keep the order in which they were pushed
+    std::stable_sort(late.begin(), late.end(), TimeCompare);
+    mergeSorted(late);
+    trimRange();
+  }
+
+  void clear() override
+  {
+    _late_samples.clear();
+    PlotDataBase<double, Value>::clear();
+  }
+
   void swapData(TimeseriesBase& other)
   {
     PlotDataBase<double, Value>::swapData(other);
     std::swap(_max_range_x, other._max_range_x);
+    std::swap(_retention, other._retention);
+    std::swap(_measured_size, other._measured_size);
+    std::swap(_measured_chunks, other._measured_chunks);
+    std::swap(_bytes_per_sample, other._bytes_per_sample);
+    std::swap(_late_samples, other._late_samples);
+    std::swap(_late_min_x, other._late_min_x);
+    // the samples may come from a series of another group, or of another PlotDataMapRef
+    // used by a different thread: follow the column of our own group instead, if possible
+    _points.setTimeColumn(this->_group ? this->_group->timeColumn() : nullptr);
+    other._points.setTimeColumn(other._group ? other._group->timeColumn() : nullptr);
   }
 
   int getIndexFromX(double x) const;
 
+  // same as std::lower_bound, searching first the chunk and then the contiguous x array
+  size_t lowerBoundIndex(double x) const
+  {
+    const size_t chunk = findChunk([x](double back_x) { return !(back_x < x); });
+    if (chunk == _points.chunkCount())
+    {
+      return _points.size();
+    }
+    const auto xs = _points.chunkX(chunk);
+    const auto it = std::lower_bound(xs.begin(), xs.end(), x);
+    return _points.chunkFirstIndex(chunk) + std::distance(xs.begin(), it);
+  }
+
+  // same as std::upper_bound, searching first the chunk and then the contiguous x array
+  size_t upperBoundIndex(double x) const
+  {
+    const size_t chunk = findChunk([x](double back_x) { return x < back_x; });
+    if (chunk == _points.chunkCount())
+    {
+      return _points.size();
+    }
+    const auto xs = _points.chunkX(chunk);
+    const auto it = std::upper_bound(xs.begin(), xs.end(), x);
+    return _points.chunkFirstIndex(chunk) + std::distance(xs.begin(), it);
+  }
+
   std::optional<Value> getYfromX(double x) const
   {
     int index = getIndexFromX(x);
@@ -73,16 +264,99 @@ public:
   {
     bool need_sorting = (!_points.empty() && p.x < this->back().x);
 
-    if (need_sorting)
+    if (need_sorting && _reorder_window > 0)
     {
-      auto it = std::upper_bound(_points.begin(), _points.end(), p,
-                                 [](const auto& a, const auto& b) { return a.x < b.x; });
+      if (this->isValid(p))
+      {
+        _late_min_x = _late_samples.empty() ? p.x : std::min(_late_min_x, p.x);
+        _late_samples.push_back(std::move(p));
+        this->markChanged();
+      }
+    }
+    else if (need_sorting)
+    {
+      auto it = _points.begin() + upperBoundIndex(p.x);
       PlotDataBase<double, Value>::insert(it, std::move(p));
     }
     else
     {
       PlotDataBase<double, Value>::pushBack(std::move(p));
     }
+
+    if (!_late_samples.empty() && (_late_samples.size() >= MAX_LATE_SAMPLES ||
+                                   this->back().x - _late_min_x > _reorder_window))
+    {
+      flushLateSamples();
+    }
+    trimRange();
+  }
+
+  /**
+   * @brief Append many samples at once, with the same result of calling pushBack()
+   * for each of them: samples with NaN or Inf are skipped and the series stays sorted.
+   *
+   * The validity and the order of the samples are checked once for the entire batch
+   * and the ranges are updated once. A batch that is not sorted, or older than the last
+   * sample, is sorted and merged only with the stored samples that follow its oldest one:
+   * O(K log K + M), as in flushLateSamples(). xs and ys must have the same size.
+   */
+  void pushBackBatch(Span<const double> xs, Span<const Value> ys)
+  {
+    const size_t count = std::min(xs.size(), ys.size());
+    xs = xs.first(count);
+    ys = ys.first(count);
+
+    std::vector<double> valid_x;
+    std::vector<Value> valid_y;
+    bool all_valid = AllFinite(xs);
+    if constexpr (std::is_arithmetic_v<Value>)
+    {
+      all_valid = all_valid && AllFinite(ys);
+    }
+    if (!all_valid)
+    {
+      valid_x.reserve(count);
+      valid_y.reserve(count);
+      for (size_t i = 0; i < count; i++)
+      {
+        bool valid = std::isfinite(xs[i]);
+        if constexpr (std::is_arithmetic_v<Value>)
+        {
+          valid = valid && std::isfinite(ys[i]);
+        }
+        if (valid)
+        {
+          valid_x.push_back(xs[i]);
+          valid_y.push_back(ys[i]);
+        }
+      }
+      xs = valid_x;
+      ys = valid_y;
+    }
+    if (xs.empty())
+    {
+      return;
+    }
+
+    if (IsSorted(xs) && (_points.empty() || !(xs.front() < this->back().x)))
+    {
+      this->appendValidSamples(xs, ys);
+      trimRange();
+      return;
+    }
+    // sort the batch, together with the pending late samples, and merge it with the
+    // stored samples that follow its oldest one, instead of inserting each sample
+    std::vector<Point> batch;
+    batch.reserve(_late_samples.size() + xs.size());
+    std::move(_late_samples.begin(), _late_samples.end(), std::back_inserter(batch));
+    _late_samples.clear();
+    for (size_t i = 0; i < xs.size(); i++)
+    {
+      batch.push_back(Point(xs[i], ys[i]));
+    }
+    // stable: samples with the same x keep the order in which they were pushed
+    std::stable_sort(batch.begin(), batch.end(), TimeCompare);
+    mergeSorted(batch);
     trimRange();
   }
 
@@ -97,53 +371,206 @@ public:
     }
     if (!std::isinf(p.x) && !std::isnan(p.x))
     {
+      // sorted again by sort()
+      this->_sorted_x = false;
       _points.push_back(std::move(p));
+      this->invalidateRanges();
     }
   }
 
   void sort()
   {
-    std::sort(_points.begin(), _points.end(),
-              [](const auto& a, const auto& b) { return a.x < b.x; });
-
-    Range range_x;
-    Range range_y;
-
-    for (const auto& p : _points)
+    // the chunked storage can not be sorted in place: copy, sort and rebuild it
+    std::vector<Point> sorted;
+    sorted.reserve(_points.size() + _late_samples.size());
+    const auto& points = _points;  // read only: sealed chunks are not decoded permanently
+    for (size_t i = 0; i < points.size(); i++)
+    {
+      sorted.push_back(points[i]);
+    }
+    for (auto& p : _late_samples)
     {
-      range_x.min = std::max(range_x.min, p.x);
-      range_x.max = std::min(range_x.max, p.x);
+      sorted.push_back(std::move(p));
+    }
+    _late_samples.clear();
+    // stable: samples with the same x keep the order in which they were pushed
+    std::stable_sort(sorted.begin(), sorted.end(), TimeCompare);
 
-      if constexpr (std::is_arithmetic_v<Value>)
-      {
-        range_y.min = std::max(range_y.min, p.y);
-        range_y.max = std::min(range_y.max, p.y);
-      }
+    _points.clear();
+    for (auto& p : sorted)
+    {
+      _points.push_back(std::move(p));
     }
-    this->_range_x = range_x;
-    this->_range_y = range_y;
-    this->_range_x_dirty = false;
-    this->_range_y_dirty = false;
+    // ranges will be recomputed lazily
+    this->_sorted_x = true;
+    this->invalidateRanges();
     trimRange();
   }
 
 private:
+  static constexpr size_t MAX_LATE_SAMPLES = 4096;
+
+  double _reorder_window = 0;
+  std::vector<Point> _late_samples;
+  // x of the oldest sample in _late_samples
+  double _late_min_x = 0;
+
+  RetentionPolicy _retention;
+  // cost of a sample, to convert _retention.max_bytes into a number of samples
+  size_t _measured_size = 0;
+  size_t _measured_chunks = 0;
+  double _bytes_per_sample = 0;
+
+  uint64_t _last_viewed = 0;
+
   void trimRange()
   {
-    if (_max_range_x < std::numeric_limits<double>::max() && !_points.empty())
+    if (_points.empty())
+    {
+      return;
+    }
+    const double max_range = std::min(_max_range_x, _retention.max_seconds);
+    if (max_range < std::numeric_limits<double>::max())
     {
       auto const back_point_x = _points.back().x;
-      while (_points.size() > 2 && (back_point_x - _points.front().x) > _max_range_x)
+      while (_points.size() > 2 && (back_point_x - _points.front().x) > max_range)
       {
         this->popFront();
       }
     }
+    if (_retention.max_samples > 0 || _retention.max_bytes > 0)
+    {
+      keepNewest(retainedSamples());
+    }
+  }
+
+  // maximum number of samples allowed by _retention
+  size_t retainedSamples()
+  {
+    size_t max_size = std::numeric_limits<size_t>::max();
+    if (_retention.max_samples > 0)
+    {
+      max_size = _retention.max_samples;
+    }
+    if (_retention.max_bytes > 0)
+    {
+      // memoryUsage() visits all the chunks: measure again only when a chunk was added
+      // or removed, or the size changed by more than 1/8 (the tail chunk grows geometrically)
+      const size_t size = _points.size();
+      const size_t delta = (size > _measured_size) ? size - _measured_size : _measured_size - size;
+      if (_points.chunkCount() != _measured_chunks || delta > _measured_size / 8)
+      {
+        _bytes_per_sample = double(_points.memoryUsage()) / double(size);
+        _measured_size = size;
+        _measured_chunks = _points.chunkCount();
+      }
+      max_size = std::min(max_size, size_t(double(_retention.max_bytes) / _bytes_per_sample));
+    }
+    return std::max<size_t>(max_size, 1);
   }
 
   static bool TimeCompare(const Point& a, const Point& b)
   {
     return a.x < b.x;
   }
+
+  // Merge samples (valid and sorted by x) with the stored ones, rewriting only the stored
+  // samples newer than the oldest of them. For the same x, the new samples go after the
+  // ones already stored, as in pushBack().
+  void mergeSorted(std::vector<Point>& sorted)
+  {
+    const size_t first = upperBoundIndex(sorted.front().x);
+    std::vector<double> xs;
+    std::vector<Value> ys;
+    xs.reserve(_points.size() - first + sorted.size());
+    ys.reserve(_points.size() - first + sorted.size());
+    // chunk that contains the sample "first" (chunkFirstIndex() does not decode the chunks)
+    size_t chunk = _points.chunkCount();
+    while (chunk > 0 && _points.chunkFirstIndex(chunk - 1) > first)
+    {
+      chunk--;
+    }
+    auto it = sorted.begin();
+    for (size_t c = (chunk > 0) ? chunk - 1 : 0; c < _points.chunkCount(); c++)
+    {
+      const size_t chunk_first = _points.chunkFirstIndex(c);
+      const auto chunk_x = _points.chunkX(c);
+      const auto chunk_y = _points.chunkY(c);
+      for (size_t i = (first > chunk_first) ? first - chunk_first : 0; i < chunk_x.size(); i++)
+      {
+        for (; it != sorted.end() && it->x < chunk_x[i]; it++)
+        {
+          xs.push_back(it->x);
+          ys.push_back(std::move(it->y));
+        }
+        xs.push_back(chunk_x[i]);
+        ys.push_back(chunk_y[i]);
+      }
+    }
+    for (; it != sorted.end(); it++)
+    {
+      xs.push_back(it->x);
+      ys.push_back(std::move(it->y));
+    }
+    this->overwriteValidSamples(first, xs, ys);
+  }
+
+  // The following loops have no branches and no early exit,
+  // so that the compiler can vectorize them.
+
+  template <typename T>
+  static bool AllFinite(Span<const T> values)
+  {
+    if constexpr (std::is_same_v<T, double>)
+    {
+      // NaN and Inf have all the bits of the exponent set
+      constexpr uint64_t EXPONENT_MASK = 0x7FF0000000000000ULL;
+      uint64_t not_finite = 0;
+      for (const double& value : values)
+      {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        not_finite |= static_cast<uint64_t>((bits & EXPONENT_MASK) == EXPONENT_MASK);
+      }
+      return not_finite == 0;
+    }
+    else
+    {
+      return std::all_of(values.begin(), values.end(),
+                         [](const T& value) { return std::isfinite(value); });
+    }
+  }
+
+  static bool IsSorted(Span<const double> xs)
+  {
+    unsigned unsorted = 0;
+    for (size_t i = 1; i < xs.size(); i++)
+    {
+      unsorted |= static_cast<unsigned>(xs[i] < xs[i - 1]);
+    }
+    return unsorted == 0;
+  }
+
+  // index of the first chunk whose last sample satisfies the predicate
+  template <typename Predicate>
+  size_t findChunk(Predicate pred) const
+  {
+    size_t lo = 0;
+    size_t hi = _points.chunkCount();
+    while (lo < hi)
+    {
+      const size_t mid = (lo + hi) / 2;
+      if (pred(_points.chunkBackX(mid)))
+      {
+        hi = mid;
+      }
+      else
+      {
+        lo = mid + 1;
+      }
+    }
+    return lo;
+  }
 };
 
 //--------------------
@@ -155,8 +582,7 @@ inline int TimeseriesBase<Value>::getIndexFromX(double x) const
   {
     return -1;
   }
-  auto lower = std::lower_bound(_points.begin(), _points.end(), Point(x, {}), TimeCompare);
-  auto index = std::distance(_points.begin(), lower);
+  std::ptrdiff_t index = lowerBoundIndex(x);
 
   if (index >= _points.size())
   {
@@ -167,7 +593,7 @@ inline int TimeseriesBase<Value>::getIndexFromX(double x) const
     return 0;
   }
 
-  if (index > 0 && (abs(_points[index - 1].x - x) < abs(_points[index].x - x)))
+  if (index > 0 && (std::abs(_points[index - 1].x - x) < std::abs(_points[index].x - x)))
   {
     index = index - 1;
   }
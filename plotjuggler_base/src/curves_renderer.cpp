@@ -0,0 +1,172 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "curves_renderer.h"
+#include "timeseries_qwt.h"
+
+#include <QPainter>
+#include "qwt_plot.h"
+
+namespace
+{
+constexpr QwtPlotCurve::PaintAttribute PAINT_ATTRIBUTES[] = {
+  QwtPlotCurve::ClipPolygons,
+  QwtPlotCurve::FilterPoints,
+  QwtPlotCurve::MinimizeMemory,
+  QwtPlotCurve::ImageBuffer,
+  QwtPlotCurve::FilterPointsAggressive,
+};
+
+// linear transformation of the pixel coordinates, from the old map to the new one
+void ReprojectedInterval(const QwtScaleMap& old_map, const QwtScaleMap& new_map, double& p1,
+                         double& p2)
+{
+  const double old_p1 = old_map.p1();
+  const double old_p2 = old_map.p2();
+  const double new_p1 = new_map.transform(old_map.s1());
+  const double new_p2 = new_map.transform(old_map.s2());
+  if (old_p2 == old_p1)
+  {
+    return;
+  }
+  const double scale = (new_p2 - new_p1) / (old_p2 - old_p1);
+  p1 = new_p1 + (p1 - old_p1) * scale;
+  p2 = new_p1 + (p2 - old_p1) * scale;
+}
+}  // namespace
+
+CurvesFrame CurvesFrame::takeSnapshot(const QwtPlot* plot, const std::list<QwtPlotCurve*>& curves)
+{
+  CurvesFrame frame;
+  const QWidget* canvas = plot->canvas();
+  frame.canvas_size = canvas->size();
+  frame.canvas_rect = canvas->contentsRect();
+  frame.pixel_ratio = canvas->devicePixelRatioF();
+  frame.x_map = plot->canvasMap(QwtPlot::xBottom);
+  frame.y_map = plot->canvasMap(QwtPlot::yLeft);
+  frame.curves.reserve(curves.size());
+
+  for (QwtPlotCurve* curve : curves)
+  {
+    if (!curve->isVisible())
+    {
+      continue;
+    }
+    Curve info;
+    info.pen = curve->pen();
+    info.brush = curve->brush();
+    info.style = curve->style();
+    info.inverted = curve->testCurveAttribute(QwtPlotCurve::Inverted);
+    info.antialiased = curve->testRenderHint(QwtPlotItem::RenderAntialiased);
+    info.baseline = curve->baseline();
+    info.orientation = curve->orientation();
+    for (auto attribute : PAINT_ATTRIBUTES)
+    {
+      info.paint_attributes.setFlag(attribute, curve->testPaintAttribute(attribute));
+    }
+    info.x_map = plot->canvasMap(curve->xAxis());
+    info.y_map = plot->canvasMap(curve->yAxis());
+
+    // same selection of samples done when the curve is drawn directly
+    auto data = curve->data();
+    const QwtTimeseries* timeseries = dynamic_cast<const QwtTimeseries*>(data);
+    if (auto decimated = dynamic_cast<QwtDecimatedSeries*>(data))
+    {
+      decimated->setCanvasMap(info.x_map, frame.pixel_ratio);
+      timeseries = decimated->isDecimating() ? nullptr : decimated->source();
+    }
+    if (timeseries)
+    {
+      // all the samples are drawn: share the chunks, O(number of chunks)
+      auto copy = std::make_shared<PlotData>(timeseries->timeseriesData()->plotName(), nullptr);
+      copy->clonePoints(*timeseries->timeseriesData());
+      info.series = std::move(copy);
+      info.time_offset = timeseries->timeOffset();
+    }
+    else
+    {
+      const size_t size = data->size();
+      info.points.reserve(static_cast<int>(size));
+      for (size_t i = 0; i < size; i++)
+      {
+        info.points.push_back(data->sample(i));
+      }
+    }
+    frame.curves.push_back(std::move(info));
+  }
+  return frame;
+}
+
+void CurvesFrame::render()
+{
+  image = QImage(canvas_size * pixel_ratio, QImage::Format_ARGB32_Premultiplied);
+  image.setDevicePixelRatio(pixel_ratio);
+  image.fill(Qt::transparent);
+
+  QPainter painter(&image);
+  painter.setClipRect(canvas_rect);
+
+  for (auto& info : curves)
+  {
+    // a detached curve, owned by this thread
+    QwtPlotCurve curve;
+    curve.setPen(info.pen);
+    curve.setBrush(info.brush);
+    curve.setStyle(info.style);
+    curve.setCurveAttribute(QwtPlotCurve::Inverted, info.inverted);
+    curve.setBaseline(info.baseline);
+    curve.setOrientation(info.orientation);
+    for (auto attribute : PAINT_ATTRIBUTES)
+    {
+      curve.setPaintAttribute(attribute, info.paint_attributes.testFlag(attribute));
+    }
+    if (info.series)
+    {
+      auto series = new QwtTimeseries(info.series.get());
+      series->setTimeOffset(info.time_offset);
+      curve.setData(series);
+    }
+    else
+    {
+      curve.setSamples(std::move(info.points));
+    }
+
+    painter.save();
+    painter.setRenderHint(QPainter::Antialiasing, info.antialiased);
+    curve.draw(&painter, info.x_map, info.y_map, canvas_rect);
+    painter.restore();
+  }
+  // the samples are not needed anymore
+  curves.clear();
+}
+
+void CurvesFrame::draw(QPainter* painter, const QwtScaleMap& new_x_map,
+                       const QwtScaleMap& new_y_map) const
+{
+  if (image.isNull())
+  {
+    return;
+  }
+  double left = 0;
+  double right = canvas_size.width();
+  double top = 0;
+  double bottom = canvas_size.height();
+  ReprojectedInterval(x_map, new_x_map, left, right);
+  ReprojectedInterval(y_map, new_y_map, top, bottom);
+
+  const QRectF target(QPointF(left, top), QPointF(right, bottom));
+  if (target.width() <= 0 || target.height() <= 0)
+  {
+    // an axis was flipped: wait for the next frame
+    return;
+  }
+  const QRectF source(QPointF(0, 0), QSizeF(image.size()));
+
+  painter->save();
+  painter->setClipRect(canvas_rect);
+  painter->drawImage(target, image, source);
+  painter->restore();
+}
@@ -0,0 +1,71 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CURVES_RENDERER_H
+#define CURVES_RENDERER_H
+
+#include <list>
+#include <memory>
+#include <vector>
+#include <QImage>
+#include <QPen>
+#include <QVector>
+#include "qwt_plot_curve.h"
+#include "qwt_scale_map.h"
+#include "PlotJuggler/plotdata.h"
+
+class QwtPlot;
+
+/**
+ * @brief Copy of the curves of a plot, that can be rasterized by any thread.
+ *
+ * The snapshot is taken in the GUI thread: it contains the style of the curves and
+ * the samples that QwtPlotCurve would draw. The decimated ones are copied, since they
+ * are a few per pixel; the other timeseries are copied with PlotDataBase::clonePoints(),
+ * that shares their chunks instead of copying the samples.
+ * After that, the snapshot doesn't refer to the plot anymore.
+ */
+struct CurvesFrame
+{
+  struct Curve
+  {
+    QPen pen;
+    QBrush brush;
+    QwtPlotCurve::CurveStyle style;
+    bool inverted;
+    bool antialiased;
+    double baseline;
+    Qt::Orientation orientation;
+    QwtPlotCurve::PaintAttributes paint_attributes;
+    QwtScaleMap x_map;
+    QwtScaleMap y_map;
+    // either the samples to draw, or a copy of the whole series
+    QVector<QPointF> points;
+    std::shared_ptr<const PJ::PlotData> series;
+    double time_offset = 0;
+  };
+
+  QSize canvas_size;
+  QRectF canvas_rect;
+  double pixel_ratio = 1.0;
+  // maps of the bottom and left axes, used to reproject the image when the scales change
+  QwtScaleMap x_map;
+  QwtScaleMap y_map;
+  std::vector<Curve> curves;
+
+  // result of render()
+  QImage image;
+
+  static CurvesFrame takeSnapshot(const QwtPlot* plot, const std::list<QwtPlotCurve*>& curves);
+
+  // Rasterize the curves into "image". Thread-safe.
+  void render();
+
+  // Draw the image, moved and scaled if the current maps differ from the ones of the snapshot
+  void draw(QPainter* painter, const QwtScaleMap& x_map, const QwtScaleMap& y_map) const;
+};
+
+#endif  // CURVES_RENDERER_H
@@ -5,9 +5,77 @@
  */
 
 #include "PlotJuggler/datastreamer_base.h"
+#include <chrono>
 
 namespace PJ
 {
+namespace
+{
+// Move the samples of the series "name" of "source", if it exists, into the series with
+// the same name of "destination". "create" adds a series to destination_map.
+// Returns false if the destination was not consumed yet: nothing is moved and
+// it should be tried again later.
+template <typename SeriesMap, typename CreateFunction>
+bool HandOver(const std::string& name, SeriesMap& source, SeriesMap& destination,
+              PlotDataMapRef& destination_map, CreateFunction create, bool& moved)
+{
+  auto source_it = source.find(name);
+  if (source_it == source.end())
+  {
+    return true;
+  }
+  auto& source_plot = source_it->second;
+  if constexpr (!std::is_same_v<PlotDataXY, typename SeriesMap::mapped_type>)
+  {
+    source_plot.flushLateSamples();
+  }
+  PlotGroup::Ptr group;
+  if (source_plot.group())
+  {
+    group = destination_map.getOrCreateGroup(source_plot.group()->name());
+  }
+  auto it = destination.find(name);
+  if (source_plot.size() == 0)
+  {
+    // a series without samples, for instance not requested in "lazy fields" mode
+    // (see FieldDemand), is handed over only once, to be listed
+    if (it == destination.end())
+    {
+      create(name, group);
+      moved = true;
+    }
+    return true;
+  }
+  if (it == destination.end())
+  {
+    it = create(name, group);
+  }
+  auto& destination_plot = it->second;
+  if (destination_plot.size() > 0)
+  {
+    return false;
+  }
+  if (destination_plot.group() != group)
+  {
+    destination_plot.changeGroup(group);
+  }
+  for (const auto& [attr_name, attr] : source_plot.attributes())
+  {
+    if (destination_plot.attribute(attr_name) != attr)
+    {
+      destination_plot.setAttribute(attr_name, attr);
+    }
+  }
+  if constexpr (!std::is_same_v<PlotDataXY, typename SeriesMap::mapped_type>)
+  {
+    destination_plot.setMaximumRangeX(source_plot.maximumRangeX());
+    destination_plot.setRetentionPolicy(source_plot.retentionPolicy());
+  }
+  destination_plot.swapData(source_plot);
+  moved = true;
+  return true;
+}
+}  // namespace
 
 void PJ::DataStreamer::setMaximumRangeX(double range)
 {
@@ -24,6 +92,212 @@ void PJ::DataStreamer::setMaximumRangeX(double range)
   {
     it.second.setMaximumRangeX(range);
   }
+  for (auto& it : dataMap().arrays)
+  {
+    it.second.setMaximumRangeX(range);
+  }
+}
+
+void DataStreamer::setRetentionRules(const RetentionRules& rules)
+{
+  std::lock_guard<std::mutex> lock(mutex());
+  dataMap().setRetentionRules(rules);
+}
+
+bool DataStreamer::consumeData(const std::function<void(PlotDataMapRef&)>& consume)
+{
+  const auto start_time = std::chrono::steady_clock::now();
+  if (!_double_buffering)
+  {
+    std::lock_guard<std::mutex> lock(mutex());
+    consume(_data_map);
+  }
+  else
+  {
+    int expected = HANDOFF_READY;
+    if (!_handoff_state.compare_exchange_strong(expected, HANDOFF_CONSUMING,
+                                                std::memory_order_acquire))
+    {
+      return false;
+    }
+    consume(_handoff);
+    _handoff_state.store(HANDOFF_FREE, std::memory_order_release);
+  }
+  _consume_latency.record(std::chrono::steady_clock::now() - start_time);
+  return true;
+}
+
+bool DataStreamer::publishData()
+{
+  if (!_double_buffering || _handoff_state.load(std::memory_order_acquire) != HANDOFF_FREE)
+  {
+    return false;
+  }
+  const auto start_time = std::chrono::steady_clock::now();
+  bool moved = false;
+
+  // only the series written since the previous handover, plus the ones to be tried again
+  DirtySet::Changes changes = _data_map.dirtySet()->drain();
+  changes.series.insert(changes.series.end(), _handoff_retry.begin(), _handoff_retry.end());
+  _handoff_retry.clear();
+
+  using Group = const PlotGroup::Ptr&;
+  auto createNumeric = [this](const std::string& name, Group group) {
+    return _handoff.addNumeric(name, group);
+  };
+  auto createString = [this](const std::string& name, Group group) {
+    return _handoff.addStringSeries(name, group);
+  };
+  auto createScatterXY = [this](const std::string& name, Group group) {
+    return _handoff.addScatterXY(name, group);
+  };
+  auto createUserDefined = [this](const std::string& name, Group group) {
+    return _handoff.addUserDefined(name, group);
+  };
+  auto createArray = [this](const std::string& name, Group group) {
+    return _handoff.addArraySeries(name, group);
+  };
+  for (const auto& name : changes.series)
+  {
+    bool done = HandOver(name, _data_map.numeric, _handoff.numeric, _handoff, createNumeric, moved);
+    done &= HandOver(name, _data_map.strings, _handoff.strings, _handoff, createString, moved);
+    done &= HandOver(name, _data_map.scatter_xy, _handoff.scatter_xy, _handoff, createScatterXY,
+                     moved);
+    done &= HandOver(name, _data_map.user_defined, _handoff.user_defined, _handoff,
+                     createUserDefined, moved);
+    done &= HandOver(name, _data_map.arrays, _handoff.arrays, _handoff, createArray, moved);
+    if (!done)
+    {
+      _handoff_retry.push_back(name);
+    }
+  }
+  for (const auto& name : changes.groups)
+  {
+    auto it = _data_map.groups.find(name);
+    if (it == _data_map.groups.end())
+    {
+      continue;
+    }
+    auto group = _handoff.getOrCreateGroup(name);
+    for (const auto& [attr_name, attr] : it->second->attributes())
+    {
+      if (group->attribute(attr_name) != attr)
+      {
+        group->setAttribute(attr_name, attr);
+        moved = true;
+      }
+    }
+  }
+  if (moved)
+  {
+    _handoff_state.store(HANDOFF_READY, std::memory_order_release);
+  }
+  _publish_latency.record(std::chrono::steady_clock::now() - start_time);
+  return moved;
+}
+
+bool DataStreamer::hasPendingData() const
+{
+  if (!_double_buffering)
+  {
+    return false;
+  }
+  return _handoff_state.load(std::memory_order_acquire) != HANDOFF_FREE ||
+         !_handoff_retry.empty() || !_data_map.dirtySet()->empty();
+}
+
+std::unique_lock<std::mutex> DataStreamer::lockMutex()
+{
+  const auto start_time = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(_mutex);
+  _metrics.lockWait().record(std::chrono::steady_clock::now() - start_time);
+  return lock;
+}
+
+bool DataStreamer::parseMessageWithMetrics(MessageParser& parser, const MessageRef& msg,
+                                           double& timestamp)
+{
+  if (!parser.metrics())
+  {
+    parser.setMetrics(_metrics.topic(parser.topicName()));
+  }
+  TopicMetrics& metrics = *parser.metrics();
+  const double receive_time = timestamp;
+  parser.setFieldDemand(_field_demand);
+  parser.updateFieldDemand();
+  const auto start_time = std::chrono::steady_clock::now();
+  bool parsed = false;
+  try
+  {
+    parsed = parser.parseMessage(msg, timestamp);
+  }
+  catch (...)
+  {
+    metrics.recordDropped();
+    if (_recorder)
+    {
+      recordMessage(parser, msg, receive_time, receive_time);
+    }
+    throw;
+  }
+  metrics.recordMessage(msg.size(), std::chrono::steady_clock::now() - start_time);
+  if (!parsed)
+  {
+    metrics.recordDropped();
+  }
+  else
+  {
+    parser.keepForBackfill(msg, receive_time);
+  }
+  // the raw message is kept also when it can't be parsed
+  if (_recorder)
+  {
+    recordMessage(parser, msg, receive_time, timestamp);
+  }
+  return parsed;
+}
+
+void DataStreamer::setRecorder(MessageRecorder::Ptr recorder)
+{
+  std::lock_guard<std::mutex> lock(mutex());
+  _recorder = std::move(recorder);
+  _recorded_topics.clear();
+}
+
+void DataStreamer::setFieldDemand(FieldDemand::Ptr demand)
+{
+  std::lock_guard<std::mutex> lock(mutex());
+  _field_demand = std::move(demand);
+}
+
+void DataStreamer::recordMessage(const MessageParser& parser, const MessageRef& msg,
+                                 double receive_time, double timestamp)
+{
+  auto it = _recorded_topics.find(parser.topicName());
+  if (it == _recorded_topics.end())
+  {
+    // streamers with a single parser have no topic
+    const std::string topic = parser.topicName().empty() ? name() : parser.topicName();
+    const uint32_t id = _recorder->addTopic(topic, parser.schema());
+    it = _recorded_topics.insert({ parser.topicName(), id }).first;
+  }
+  _recorder->record(it->second, msg, receive_time, timestamp);
+}
+
+MessageParserPtr DataStreamer::createParser(ParserFactoryPlugin& factory,
+                                            const std::string& topic_name, MessageSchema schema)
+{
+  auto parser = factory.createParser(topic_name, schema.name, schema.definition, _data_map);
+  if (parser)
+  {
+    if (schema.encoding.empty())
+    {
+      const std::string encodings = factory.encoding();
+      schema.encoding = encodings.substr(0, encodings.find(';'));
+    }
+    parser->setSchema(std::move(schema));
+  }
+  return parser;
 }
 
 void DataStreamer::setParserFactories(ParserFactories* parsers)
@@ -0,0 +1,88 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "PlotJuggler/messageparser_base.h"
+
+namespace PJ
+{
+void MessageParser::setFieldDemand(FieldDemand::Ptr demand)
+{
+  if (demand == _field_demand)
+  {
+    return;
+  }
+  _field_demand = std::move(demand);
+  _requested_generation = 0;
+  _requested_fields.clear();
+  _ever_requested_fields.clear();
+  _kept_messages.clear();
+  _field_demand_generation++;
+}
+
+void MessageParser::updateFieldDemand()
+{
+  if (!_field_demand || _field_demand->generation() == _requested_generation)
+  {
+    return;
+  }
+  _requested_generation = _field_demand->generation();
+  _requested_fields = _field_demand->requested();
+  _field_demand_generation++;
+
+  _backfill_fields.clear();
+  for (const auto& name : _requested_fields)
+  {
+    if (_ever_requested_fields.insert(name).second)
+    {
+      _backfill_fields.insert(name);
+    }
+  }
+  if (_backfill_fields.empty() || _kept_messages.empty())
+  {
+    return;
+  }
+
+  // the kept messages were parsed when these series were not requested: their
+  // samples were not stored yet
+  _backfilling = true;
+  _field_demand_generation++;
+  for (const auto& kept : _kept_messages)
+  {
+    double timestamp = kept.timestamp;
+    try
+    {
+      parseMessage(MessageRef(kept.data), timestamp);
+    }
+    catch (std::exception&)
+    {
+      // it failed already the first time
+    }
+  }
+  _backfilling = false;
+  _backfill_fields.clear();
+  _field_demand_generation++;
+}
+
+void MessageParser::keepForBackfill(const MessageRef& msg, double timestamp)
+{
+  const size_t max_messages = _field_demand ? _field_demand->backfillMessages() : 0;
+  if (max_messages == 0 || !supportsLazyFields())
+  {
+    _kept_messages.clear();
+    return;
+  }
+  // reuse the buffer of the oldest message
+  std::vector<uint8_t> data;
+  while (_kept_messages.size() >= max_messages)
+  {
+    data = std::move(_kept_messages.front().data);
+    _kept_messages.pop_front();
+  }
+  data.assign(msg.data(), msg.data() + msg.size());
+  _kept_messages.push_back({ std::move(data), timestamp });
+}
+
+}  // namespace PJ
@@ -5,12 +5,40 @@
  */
 
 #include "PlotJuggler/plotdata.h"
+#include <cmath>
+#include <functional>
 
 namespace PJ
 {
+// only timeseries have a reorder window
+template <typename Value>
+void initReorderWindow(TimeseriesBase<Value>& series, double window)
+{
+  series.setReorderWindow(window);
+}
+
+void initReorderWindow(PlotDataXY&, double)
+{
+}
+
+// only timeseries have a retention policy
+template <typename Value>
+void initRetentionPolicy(TimeseriesBase<Value>& series, const RetentionRules& rules)
+{
+  if (!rules.empty())
+  {
+    series.setRetentionPolicy(FindRetentionPolicy(rules, series.plotName()));
+  }
+}
+
+void initRetentionPolicy(PlotDataXY&, const RetentionRules&)
+{
+}
+
 template <typename T>
 typename std::unordered_map<std::string, T>::iterator
-addImpl(std::unordered_map<std::string, T>& series, const std::string& name, PlotGroup::Ptr group)
+addImpl(std::unordered_map<std::string, T>& series, const std::string& name, PlotGroup::Ptr group,
+        const PlotDataMapRef& map)
 {
   std::string ID;
   if (group)
@@ -23,63 +51,81 @@ addImpl(std::unordered_map<std::string, T>& series, const std::string& name, Plo
   }
   ID += name;
 
-  return series
-      .emplace(std::piecewise_construct, std::forward_as_tuple(name),
-               std::forward_as_tuple(name, group))
-      .first;
+  auto it = series
+                .emplace(std::piecewise_construct, std::forward_as_tuple(name),
+                         std::forward_as_tuple(name, group))
+                .first;
+  initReorderWindow(it->second, map.reorderWindow());
+  initRetentionPolicy(it->second, map.retentionRules());
+  if (map.dirtySet())
+  {
+    it->second.setDirtySet(map.dirtySet());
+  }
+  return it;
 }
 
 template <typename T>
 T& getOrCreateImpl(std::unordered_map<std::string, T>& series, const std::string& name,
-                   const PlotGroup::Ptr& group)
+                   const PlotGroup::Ptr& group, const PlotDataMapRef& map)
 {
   auto it = series.find(name);
   if (it == series.end())
   {
-    it = addImpl(series, name, group);
+    it = addImpl(series, name, group, map);
   }
   return it->second;
 }
 
 ScatterXYMap::iterator PlotDataMapRef::addScatterXY(const std::string& name, PlotGroup::Ptr group)
 {
-  return addImpl(scatter_xy, name, group);
+  return addImpl(scatter_xy, name, group, *this);
 }
 
 TimeseriesMap::iterator PlotDataMapRef::addNumeric(const std::string& name, PlotGroup::Ptr group)
 {
-  return addImpl(numeric, name, group);
+  return addImpl(numeric, name, group, *this);
 }
 
 AnySeriesMap::iterator PlotDataMapRef::addUserDefined(const std::string& name, PlotGroup::Ptr group)
 {
-  return addImpl(user_defined, name, group);
+  return addImpl(user_defined, name, group, *this);
 }
 
 StringSeriesMap::iterator PlotDataMapRef::addStringSeries(const std::string& name,
                                                           PlotGroup::Ptr group)
 {
-  return addImpl(strings, name, group);
+  return addImpl(strings, name, group, *this);
+}
+
+ArraySeriesMap::iterator PlotDataMapRef::addArraySeries(const std::string& name,
+                                                        PlotGroup::Ptr group)
+{
+  return addImpl(arrays, name, group, *this);
 }
 
 PlotDataXY& PlotDataMapRef::getOrCreateScatterXY(const std::string& name, PlotGroup::Ptr group)
 {
-  return getOrCreateImpl(scatter_xy, name, group);
+  return getOrCreateImpl(scatter_xy, name, group, *this);
 }
 
 PlotData& PlotDataMapRef::getOrCreateNumeric(const std::string& name, PlotGroup::Ptr group)
 {
-  return getOrCreateImpl(numeric, name, group);
+  return getOrCreateImpl(numeric, name, group, *this);
 }
 
 StringSeries& PlotDataMapRef::getOrCreateStringSeries(const std::string& name, PlotGroup::Ptr group)
 {
-  return getOrCreateImpl(strings, name, group);
+  return getOrCreateImpl(strings, name, group, *this);
 }
 
 PlotDataAny& PlotDataMapRef::getOrCreateUserDefined(const std::string& name, PlotGroup::Ptr group)
 {
-  return getOrCreateImpl(user_defined, name, group);
+  return getOrCreateImpl(user_defined, name, group, *this);
+}
+
+ArraySeries& PlotDataMapRef::getOrCreateArraySeries(const std::string& name, PlotGroup::Ptr group)
+{
+  return getOrCreateImpl(arrays, name, group, *this);
 }
 
 PlotGroup::Ptr PlotDataMapRef::getOrCreateGroup(const std::string& name)
@@ -92,10 +138,145 @@ PlotGroup::Ptr PlotDataMapRef::getOrCreateGroup(const std::string& name)
   if (!group)
   {
     group = std::make_shared<PlotGroup>(name);
+    group->setDirtySet(_dirty_set);
   }
   return group;
 }
 
+SeriesId PlotDataMapRef::registerSeries(const std::string& name, PlotGroup::Ptr group)
+{
+  auto it = _numeric_ids.find(name);
+  if (it != _numeric_ids.end())
+  {
+    return it->second;
+  }
+  PlotData& plot = getOrCreateNumeric(name, group);
+  SeriesId id = addSlot(&plot, nullptr);
+  _numeric_ids.insert({ name, id });
+  return id;
+}
+
+SeriesId PlotDataMapRef::registerStringSeries(const std::string& name, PlotGroup::Ptr group)
+{
+  auto it = _string_ids.find(name);
+  if (it != _string_ids.end())
+  {
+    return it->second;
+  }
+  StringSeries& plot = getOrCreateStringSeries(name, group);
+  SeriesId id = addSlot(nullptr, &plot);
+  _string_ids.insert({ name, id });
+  return id;
+}
+
+SeriesId PlotDataMapRef::findSeriesId(const std::string& name)
+{
+  if (numeric.count(name) > 0)
+  {
+    return registerSeries(name);
+  }
+  if (strings.count(name) > 0)
+  {
+    return registerStringSeries(name);
+  }
+  return {};
+}
+
+SeriesId PlotDataMapRef::addSlot(PlotData* numeric_plot, StringSeries* string_plot)
+{
+  uint32_t index = 0;
+  if (!_free_slots.empty())
+  {
+    index = _free_slots.back();
+    _free_slots.pop_back();
+  }
+  else
+  {
+    index = static_cast<uint32_t>(_slots.size());
+    _slots.emplace_back();
+  }
+  Slot& slot = _slots[index];
+  slot.numeric = numeric_plot;
+  slot.string = string_plot;
+  return { index, slot.generation };
+}
+
+void PlotDataMapRef::releaseId(std::unordered_map<std::string, SeriesId>& ids,
+                               const std::string& name)
+{
+  auto it = ids.find(name);
+  if (it == ids.end())
+  {
+    return;
+  }
+  Slot& slot = _slots[it->second.index];
+  // the handles that are still around will not match this slot anymore
+  slot.generation++;
+  slot.numeric = nullptr;
+  slot.string = nullptr;
+  _free_slots.push_back(it->second.index);
+  ids.erase(it);
+}
+
+void PlotDataMapRef::invalidateSeriesIds()
+{
+  _free_slots.clear();
+  for (uint32_t i = 0; i < _slots.size(); i++)
+  {
+    _slots[i].generation++;
+    _slots[i].numeric = nullptr;
+    _slots[i].string = nullptr;
+    _free_slots.push_back(i);
+  }
+  _numeric_ids.clear();
+  _string_ids.clear();
+}
+
+PlotData* PlotDataMapRef::materializeArrayElement(const std::string& name)
+{
+  auto numeric_it = numeric.find(name);
+  if (numeric_it != numeric.end())
+  {
+    return &numeric_it->second;
+  }
+  std::string array_name;
+  size_t index = 0;
+  if (!SplitArrayElementName(name, array_name, index))
+  {
+    return nullptr;
+  }
+  auto array_it = arrays.find(array_name);
+  if (array_it == arrays.end())
+  {
+    return nullptr;
+  }
+  const ArraySeries& array = array_it->second;
+  PlotData& element = getOrCreateNumeric(name, array.group());
+  element.setMaximumRangeX(array.maximumRangeX());
+  array.appendElement(index, 0, element);
+  _array_elements[name] = { array_name, index };
+  return &element;
+}
+
+void PlotDataMapRef::updateArrayElements()
+{
+  for (auto it = _array_elements.begin(); it != _array_elements.end();)
+  {
+    auto numeric_it = numeric.find(it->first);
+    auto array_it = arrays.find(it->second.array_name);
+    if (numeric_it == numeric.end() || array_it == arrays.end())
+    {
+      it = _array_elements.erase(it);
+      continue;
+    }
+    PlotData& element = numeric_it->second;
+    const ArraySeries& array = array_it->second;
+    const size_t first = element.size() == 0 ? 0 : array.upperBoundIndex(element.back().x);
+    array.appendElement(it->second.index, first, element);
+    it++;
+  }
+}
+
 std::unordered_set<std::string> PlotDataMapRef::getAllNames() const
 {
   std::unordered_set<std::string> out;
@@ -111,14 +292,21 @@ std::unordered_set<std::string> PlotDataMapRef::getAllNames() const
   {
     out.insert(it.first);
   }
+  for (auto& it : arrays)
+  {
+    out.insert(it.first);
+  }
   return out;
 }
 
 void PlotDataMapRef::clear()
 {
+  invalidateSeriesIds();
   numeric.clear();
   strings.clear();
   user_defined.clear();
+  arrays.clear();
+  _array_elements.clear();
 }
 
 void PlotDataMapRef::setMaximumRangeX(double range)
@@ -135,6 +323,217 @@ void PlotDataMapRef::setMaximumRangeX(double range)
   {
     it.second.setMaximumRangeX(range);
   }
+  for (auto& it : arrays)
+  {
+    it.second.setMaximumRangeX(range);
+  }
+}
+
+void PlotDataMapRef::setRetentionRules(RetentionRules rules)
+{
+  _retention_rules = std::move(rules);
+  auto apply = [this](auto& series_map) {
+    for (auto& it : series_map)
+    {
+      it.second.setRetentionPolicy(FindRetentionPolicy(_retention_rules, it.first));
+    }
+  };
+  apply(numeric);
+  apply(strings);
+  apply(user_defined);
+  apply(arrays);
+}
+
+void PlotDataMapRef::markViewed(const std::string& name)
+{
+  _view_clock++;
+  auto mark = [&](auto& series_map) {
+    auto it = series_map.find(name);
+    if (it != series_map.end())
+    {
+      it->second.setLastViewed(_view_clock);
+    }
+  };
+  mark(numeric);
+  mark(strings);
+  mark(user_defined);
+  mark(arrays);
+}
+
+// samples of each series not removed by enforceMemoryBudget(), as done by the time window
+static constexpr size_t MIN_SAMPLES_KEPT = 2;
+static constexpr int MAX_TRIM_ATTEMPTS = 8;
+
+size_t PlotDataMapRef::enforceMemoryBudget()
+{
+  if (_memory_budget == 0)
+  {
+    return 0;
+  }
+  struct Candidate
+  {
+    uint64_t last_viewed;
+    size_t size;
+    size_t bytes;
+    // keep the newest samples and return the memory used after that
+    std::function<size_t(size_t)> keep_newest;
+  };
+  std::vector<Candidate> candidates;
+  size_t total_bytes = 0;
+  auto collect = [&](auto& series_map) {
+    for (auto& it : series_map)
+    {
+      auto& series = it.second;
+      const size_t bytes = series.memoryUsage();
+      total_bytes += bytes;
+      if (series.size() > MIN_SAMPLES_KEPT)
+      {
+        candidates.push_back({ series.lastViewed(), series.size(), bytes, [&series](size_t count) {
+                                series.keepNewest(count);
+                                return series.memoryUsage();
+                              } });
+      }
+    }
+  };
+  collect(numeric);
+  collect(strings);
+  collect(user_defined);
+  collect(arrays);
+  if (total_bytes <= _memory_budget)
+  {
+    return 0;
+  }
+
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const Candidate& a, const Candidate& b) {
+                     return a.last_viewed < b.last_viewed;
+                   });
+  size_t excess = total_bytes - _memory_budget;
+  size_t removed = 0;
+  for (auto& candidate : candidates)
+  {
+    // The older samples are usually compressed, and memory is released only when an entire
+    // chunk is removed: start from the average cost of a sample, then use the memory
+    // actually released by the samples removed so far
+    double bytes_per_sample = double(candidate.bytes) / double(candidate.size);
+    for (int attempt = 0; attempt < MAX_TRIM_ATTEMPTS; attempt++)
+    {
+      if (excess == 0 || candidate.size <= MIN_SAMPLES_KEPT)
+      {
+        break;
+      }
+      const size_t needed = static_cast<size_t>(std::ceil(double(excess) / bytes_per_sample));
+      const size_t count = std::min(needed, candidate.size - MIN_SAMPLES_KEPT);
+      const size_t bytes = candidate.keep_newest(candidate.size - count);
+      const size_t released = (candidate.bytes > bytes) ? candidate.bytes - bytes : 0;
+      if (released > 0)
+      {
+        bytes_per_sample = double(released) / double(count);
+      }
+      excess -= std::min(excess, released);
+      candidate.bytes = bytes;
+      candidate.size -= count;
+      removed += count;
+    }
+  }
+  return removed;
+}
+
+void PlotDataMapRef::enableDirtyTracking()
+{
+  if (_dirty_set)
+  {
+    return;
+  }
+  _dirty_set = std::make_shared<DirtySet>();
+  auto attach = [this](auto& series_map) {
+    for (auto& it : series_map)
+    {
+      it.second.setDirtySet(_dirty_set);
+    }
+  };
+  attach(numeric);
+  attach(strings);
+  attach(scatter_xy);
+  attach(user_defined);
+  attach(arrays);
+  for (auto& it : groups)
+  {
+    it.second->setDirtySet(_dirty_set);
+  }
+}
+
+void PlotDataMapRef::setReorderWindow(double window)
+{
+  _reorder_window = window;
+  for (auto& it : numeric)
+  {
+    it.second.setReorderWindow(window);
+  }
+  for (auto& it : strings)
+  {
+    it.second.setReorderWindow(window);
+  }
+  for (auto& it : user_defined)
+  {
+    it.second.setReorderWindow(window);
+  }
+  for (auto& it : arrays)
+  {
+    it.second.setReorderWindow(window);
+  }
+}
+
+void PlotDataMapRef::setCompression(bool enable)
+{
+  for (auto& it : numeric)
+  {
+    it.second.setCompression(enable);
+  }
+}
+
+template <typename T>
+void snapshotImpl(const std::unordered_map<std::string, T>& source,
+                  std::unordered_map<std::string, T>& destination, PlotDataMapRef& map)
+{
+  for (const auto& [name, series] : source)
+  {
+    PlotGroup::Ptr group;
+    if (series.group())
+    {
+      const PlotGroup::Ptr& source_group = series.group();
+      auto it = map.groups.find(source_group->name());
+      if (it == map.groups.end())
+      {
+        // a group that is not in the map
+        group = map.getOrCreateGroup(source_group->name());
+        group->attributes() = source_group->attributes();
+      }
+      else
+      {
+        group = it->second;
+      }
+    }
+    T& copy = addImpl(destination, name, group, map)->second;
+    copy.attributes() = series.attributes();
+    copy.clonePoints(series);
+  }
+}
+
+PlotDataMapRef PlotDataMapRef::snapshot() const
+{
+  PlotDataMapRef copy;
+  copy._reorder_window = _reorder_window;
+  for (const auto& [name, group] : groups)
+  {
+    copy.getOrCreateGroup(name)->attributes() = group->attributes();
+  }
+  snapshotImpl(numeric, copy.numeric, copy);
+  snapshotImpl(strings, copy.strings, copy);
+  snapshotImpl(scatter_xy, copy.scatter_xy, copy);
+  snapshotImpl(user_defined, copy.user_defined, copy);
+  snapshotImpl(arrays, copy.arrays, copy);
+  return copy;
 }
 
 bool PlotDataMapRef::erase(const std::string& name)
@@ -143,6 +542,7 @@ bool PlotDataMapRef::erase(const std::string& name)
   auto num_it = numeric.find(name);
   if (num_it != numeric.end())
   {
+    releaseId(_numeric_ids, name);
     numeric.erase(num_it);
     erased = true;
   }
@@ -150,6 +550,7 @@ bool PlotDataMapRef::erase(const std::string& name)
   auto str_it = strings.find(name);
   if (str_it != strings.end())
   {
+    releaseId(_string_ids, name);
     strings.erase(str_it);
     erased = true;
   }
@@ -160,6 +561,13 @@ bool PlotDataMapRef::erase(const std::string& name)
     user_defined.erase(any_it);
     erased = true;
   }
+
+  auto array_it = arrays.find(name);
+  if (array_it != arrays.end())
+  {
+    arrays.erase(array_it);
+    erased = true;
+  }
   return erased;
 }
 
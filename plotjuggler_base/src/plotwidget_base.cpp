@@ -6,6 +6,7 @@
 
 #include "PlotJuggler/plotwidget_base.h"
 #include "timeseries_qwt.h"
+#include "curves_renderer.h"
 
 #include "plotmagnifier.h"
 #include "plotzoomer.h"
@@ -31,13 +32,18 @@
 #include "qwt_text.h"
 
 #include <array>
+#include <chrono>
 #include <QBoxLayout>
 #include <QMessageBox>
 #include <QSettings>
 #include <QDebug>
 #include <QDragEnterEvent>
 #include <QDropEvent>
+#include <QFutureWatcher>
 #include <QHBoxLayout>
+#include <QPainter>
+#include <QThreadPool>
+#include <QtConcurrent>
 
 #include "plotpanner.h"
 
@@ -128,11 +134,141 @@ public:
     return rect;
   }
 
+  void drawItems(QPainter* painter, const QRectF& canvas_rect,
+                 const QwtScaleMap maps[QwtAxis::AxisPositions]) const override
+  {
+    if (threaded_rendering && painting_canvas)
+    {
+      drawItemsWithRenderedCurves(painter, canvas_rect, maps);
+      return;
+    }
+    // the decimation depends on the number of pixels of the paint device
+    const double pixel_ratio = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    for (const auto& it : curve_list)
+    {
+      if (auto decimated = dynamic_cast<QwtDecimatedSeries*>(it.curve->data()))
+      {
+        decimated->setCanvasMap(maps[it.curve->xAxis()], pixel_ratio);
+      }
+    }
+    QwtPlot::drawItems(painter, canvas_rect, maps);
+  }
+
+  // Used by the canvas only. The other paint devices (export to file, clipboard) draw the
+  // curves directly in drawItems().
+  void drawCanvas(QPainter* painter) override
+  {
+    const auto start_time = std::chrono::steady_clock::now();
+    painting_canvas = true;
+    QwtPlot::drawCanvas(painter);
+    painting_canvas = false;
+    paint_latency.record(std::chrono::steady_clock::now() - start_time);
+  }
+
+  LatencyHistogram paint_latency;
+
+  void replot() override
+  {
+    QwtPlot::replot();
+    if (threaded_rendering)
+    {
+      renderCurves();
+    }
+  }
+
   virtual void resizeEvent(QResizeEvent* ev) override
   {
     QwtPlot::resizeEvent(ev);
     resized_callback(canvasBoundingRect());
     emit parent->widgetResized();
+    if (threaded_rendering)
+    {
+      renderCurves();
+    }
+  }
+
+  //---------------------------------------------
+  // Threaded rendering: the curves are rasterized by a worker of the global QThreadPool,
+  // using a copy of their samples. The canvas draws the last image available, in place of
+  // the curves. At most one image per plot is rendered at a time; the requests received
+  // in the meantime are merged into a single one.
+
+  bool threaded_rendering = false;
+  mutable bool painting_canvas = false;
+  bool render_requested = false;
+  std::shared_ptr<const CurvesFrame> rendered_curves;
+  QFutureWatcher<std::shared_ptr<const CurvesFrame>>* render_watcher = nullptr;
+
+  void setThreadedRendering(bool enable)
+  {
+    threaded_rendering = enable;
+    if (enable && !render_watcher)
+    {
+      render_watcher = new QFutureWatcher<std::shared_ptr<const CurvesFrame>>(this);
+      connect(render_watcher, &QFutureWatcherBase::finished, this, [this]() {
+        rendered_curves = render_watcher->result();
+        // repaint the canvas only, without rendering the curves again
+        QwtPlot::replot();
+        if (render_requested)
+        {
+          render_requested = false;
+          renderCurves();
+        }
+      });
+    }
+    if (!enable)
+    {
+      rendered_curves.reset();
+    }
+    replot();
+  }
+
+  void renderCurves()
+  {
+    if (render_watcher->isRunning())
+    {
+      render_requested = true;
+      return;
+    }
+    std::list<QwtPlotCurve*> curves;
+    for (const auto& it : curve_list)
+    {
+      curves.push_back(it.curve);
+    }
+    auto frame = std::make_shared<CurvesFrame>(CurvesFrame::takeSnapshot(this, curves));
+    render_watcher->setFuture(
+        QtConcurrent::run(QThreadPool::globalInstance(), [frame]() {
+          frame->render();
+          return std::shared_ptr<const CurvesFrame>(frame);
+        }));
+  }
+
+  void drawItemsWithRenderedCurves(QPainter* painter, const QRectF& canvas_rect,
+                                   const QwtScaleMap maps[QwtAxis::AxisPositions]) const
+  {
+    bool curves_drawn = false;
+    for (QwtPlotItem* item : itemList())
+    {
+      if (!item || !item->isVisible())
+      {
+        continue;
+      }
+      if (item->rtti() == QwtPlotItem::Rtti_PlotCurve)
+      {
+        // all the curves are in the same image, drawn at the position of the first one
+        if (!curves_drawn && rendered_curves)
+        {
+          rendered_curves->draw(painter, maps[QwtPlot::xBottom], maps[QwtPlot::yLeft]);
+        }
+        curves_drawn = true;
+        continue;
+      }
+      painter->save();
+      painter->setRenderHint(QPainter::Antialiasing,
+                             item->testRenderHint(QwtPlotItem::RenderAntialiased));
+      item->draw(painter, maps[item->xAxis()], maps[item->yAxis()], canvas_rect);
+      painter->restore();
+    }
   }
 
   std::list<CurveInfo> curve_list;
@@ -196,7 +332,7 @@ Range PlotWidgetBase::getVisualizationRangeX() const
       continue;
     }
 
-    auto series = dynamic_cast<QwtSeriesWrapper*>(it.curve->data());
+    auto series = dynamic_cast<QwtSeriesWrapper*>(UnwrapSeries(it.curve->data()));
     const auto max_range_X = series->getVisualizationRangeX();
     if (!max_range_X)
     {
@@ -236,7 +372,7 @@ Range PlotWidgetBase::getVisualizationRangeY(Range range_X) const
       continue;
     }
 
-    auto series = dynamic_cast<QwtSeriesWrapper*>(it.curve->data());
+    auto series = dynamic_cast<QwtSeriesWrapper*>(UnwrapSeries(it.curve->data()));
 
     auto max_range_X = series->getVisualizationRangeX();
     if (!max_range_X)
@@ -367,6 +503,11 @@ PlotWidgetBase::PlotWidgetBase(QWidget* parent) : _xy_mode(false), _keep_aspect_
 
   qwtPlot()->setAxisScale(QwtPlot::xBottom, 0.0, 1.0);
   qwtPlot()->setAxisScale(QwtPlot::yLeft, 0.0, 1.0);
+
+  if (settings.value("Preferences::threaded_rendering", false).toBool())
+  {
+    p->setThreadedRendering(true);
+  }
 }
 
 PlotWidgetBase::~PlotWidgetBase()
@@ -405,7 +546,16 @@ PlotWidgetBase::CurveInfo* PlotWidgetBase::addCurve(const std::string& name, Plo
 
     curve->setPaintAttribute(QwtPlotCurve::ClipPolygons, true);
     curve->setPaintAttribute(QwtPlotCurve::FilterPointsAggressive, true);
-    curve->setData(plot_qwt);
+
+    // timeseries are sorted by X: draw only a few samples for each pixel column
+    if (auto timeseries = dynamic_cast<QwtTimeseries*>(plot_qwt))
+    {
+      curve->setData(new QwtDecimatedSeries(timeseries));
+    }
+    else
+    {
+      curve->setData(plot_qwt);
+    }
   }
   catch (std::exception& ex)
   {
@@ -697,6 +847,12 @@ void PlotWidgetBase::setStyle(QwtPlotCurve* curve, CurveStyle style)
       (style == DOTS) ? dotWidthValue(lineWidth()) : lineWidthValue(lineWidth());
   curve->setPen(curve->pen().color(), line_width);
 
+  // samples drawn as dots can not be decimated
+  if (auto decimated = dynamic_cast<QwtDecimatedSeries*>(curve->data()))
+  {
+    decimated->setEnabled(style != DOTS && style != LINES_AND_DOTS);
+  }
+
   switch (style)
   {
     case LINES:
@@ -801,6 +957,21 @@ std::optional<PlotWidgetBase::CurveStyle> PlotWidgetBase::overriddenCurvesStyle(
   return p->overridden_curve_style;
 }
 
+void PlotWidgetBase::setThreadedRendering(bool enable)
+{
+  p->setThreadedRendering(enable);
+}
+
+bool PlotWidgetBase::isThreadedRendering() const
+{
+  return p->threaded_rendering;
+}
+
+const LatencyHistogram& PlotWidgetBase::paintLatency() const
+{
+  return p->paint_latency;
+}
+
 void PlotWidgetBase::replot()
 {
   if (p->zoomer)
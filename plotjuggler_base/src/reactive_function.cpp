@@ -114,12 +114,13 @@ void ReactiveLuaFunction::prepareLua()
 
   _timeseries_ref["find"] = [this](sol::object name) {
     auto str = name.as<std::string>();
-    auto it = plotData()->numeric.find(str);
-    if (it == plotData()->numeric.end())
+    // the element of an ArraySeries, as "scan/ranges[3]", is created if needed
+    PlotData* data = plotData()->materializeArrayElement(str);
+    if (!data)
     {
       return sol::make_object(_lua_engine, sol::lua_nil);
     }
-    auto series = std::make_unique<TimeseriesRef>(&(it->second));
+    auto series = std::make_unique<TimeseriesRef>(data);
     return sol::object(_lua_engine, sol::in_place, std::move(series));
   };
   _timeseries_ref["size"] = &TimeseriesRef::size;
@@ -129,6 +130,25 @@ void ReactiveLuaFunction::prepareLua()
   _timeseries_ref["getIndexAtTime"] = &TimeseriesRef::getIndexAtTime;
   _timeseries_ref["clear"] = &TimeseriesRef::clear;
 
+  //---------------------------------------
+  _array_ref = _lua_engine.new_usertype<ArraySeriesRef>("ArrayView");
+
+  _array_ref["find"] = [this](sol::object name) {
+    auto str = name.as<std::string>();
+    auto it = plotData()->arrays.find(str);
+    if (it == plotData()->arrays.end())
+    {
+      return sol::make_object(_lua_engine, sol::lua_nil);
+    }
+    auto array = std::make_unique<ArraySeriesRef>(&(it->second));
+    return sol::object(_lua_engine, sol::in_place, std::move(array));
+  };
+  _array_ref["size"] = &ArraySeriesRef::size;
+  _array_ref["width"] = &ArraySeriesRef::width;
+  _array_ref["at"] = &ArraySeriesRef::at;
+  _array_ref["atTime"] = &ArraySeriesRef::atTime;
+  _array_ref["getIndexAtTime"] = &ArraySeriesRef::getIndexAtTime;
+
   //---------------------------------------
   _created_timeseries = _lua_engine.new_usertype<CreatedSeriesTime>("Timeseries");
 
@@ -179,33 +199,48 @@ void ReactiveLuaFunction::prepareLua()
     return names;
   };
   _lua_engine.set_function("GetSeriesNames", GetSeriesNames);
+
+  auto GetArrayNames = [this]() {
+    std::vector<std::string> names;
+    for (const auto& it : plotData()->arrays)
+    {
+      names.push_back(it.first);
+    }
+    return names;
+  };
+  _lua_engine.set_function("GetArrayNames", GetArrayNames);
 }
 
-TimeseriesRef::TimeseriesRef(PlotData* data) : _plot_data(data)
+TimeseriesRef::TimeseriesRef(PlotData* data) : _plot_data(data), _cursor(data)
 {
 }
 
 std::pair<double, double> TimeseriesRef::at(unsigned i) const
 {
-  const auto& p = _plot_data->at(i);
+  // read through a const reference, to avoid decoding permanently a compressed chunk
+  const PlotData& data = *_plot_data;
+  const auto& p = data.at(i);
   return { p.x, p.y };
 }
 
 void TimeseriesRef::set(unsigned index, double x, double y)
 {
-  auto& p = _plot_data->at(index);
-  p = { x, y };
+  auto p = _plot_data->mutableAt(index);
+  p.x = x;
+  p.y = y;
+  _plot_data->invalidateRanges();
 }
 
 double TimeseriesRef::atTime(double t) const
 {
-  int i = _plot_data->getIndexFromX(t);
-  return _plot_data->at(i).y;
+  const PlotData& data = *_plot_data;
+  int i = _cursor.indexFromX(t);
+  return data.at(i).y;
 }
 
 int TimeseriesRef::getIndexAtTime(double t) const
 {
-  return _plot_data->getIndexFromX(t);
+  return _cursor.indexFromX(t);
 }
 
 unsigned TimeseriesRef::size() const
@@ -218,6 +253,43 @@ void TimeseriesRef::clear() const
   _plot_data->clear();
 }
 
+ArraySeriesRef::ArraySeriesRef(const ArraySeries* data) : _array(data), _cursor(data)
+{
+}
+
+std::pair<double, std::vector<float>> ArraySeriesRef::at(unsigned i) const
+{
+  const auto& p = _array->at(i);
+  auto values = p.y.values();
+  return { p.x, std::vector<float>(values.begin(), values.end()) };
+}
+
+std::vector<float> ArraySeriesRef::atTime(double t) const
+{
+  int i = _cursor.indexFromX(t);
+  if (i < 0)
+  {
+    return {};
+  }
+  auto values = _array->at(i).y.values();
+  return std::vector<float>(values.begin(), values.end());
+}
+
+int ArraySeriesRef::getIndexAtTime(double t) const
+{
+  return _cursor.indexFromX(t);
+}
+
+unsigned ArraySeriesRef::size() const
+{
+  return _array->size();
+}
+
+unsigned ArraySeriesRef::width() const
+{
+  return _array->width();
+}
+
 CreatedSeriesBase::CreatedSeriesBase(PlotDataMapRef* data_map, const std::string& name,
                                      bool timeseries)
 {
@@ -5,6 +5,8 @@
  */
 
 #include "timeseries_qwt.h"
+#include <array>
+#include <cmath>
 #include <limits>
 #include <stdexcept>
 #include <QMessageBox>
@@ -45,17 +47,13 @@ RangeOpt QwtTimeseries::getVisualizationRangeY(Range range_X)
   {
     return _ts_data->rangeY();
   }
-
-  double min_y = (std::numeric_limits<double>::max());
-  double max_y = (std::numeric_limits<double>::lowest());
-
-  for (size_t i = first_index; i < last_index; i++)
+  if (first_index == last_index)
   {
-    const double Y = sample(i).y();
-    min_y = std::min(min_y, Y);
-    max_y = std::max(max_y, Y);
+    // empty interval: the last sample is excluded
+    return Range{ std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest() };
   }
-  return Range{ min_y, max_y };
+  // scan the contiguous y values of the chunks, without touching x
+  return _ts_data->rangeY(first_index, last_index - 1);
 }
 
 std::optional<QPointF> QwtTimeseries::sampleFromTime(double t)
@@ -104,6 +102,7 @@ bool TransformedTimeseries::setTransform(QString transform_ID)
 
 void TransformedTimeseries::updateCache(bool reset_old_data)
 {
+  _revision++;
   if (_transform)
   {
     if (reset_old_data)
@@ -194,6 +193,7 @@ size_t QwtSeriesWrapper::size() const
 void QwtTimeseries::setTimeOffset(double offset)
 {
   _time_offset = offset;
+  _revision++;
 }
 
 RangeOpt QwtSeriesWrapper::getVisualizationRangeX()
@@ -225,3 +225,234 @@ const PlotDataBase<double, double>* QwtSeriesWrapper::plotData() const
 {
   return _data;
 }
+
+//---------------------------------------------------------
+
+QwtDecimatedSeries::QwtDecimatedSeries(QwtTimeseries* source) : _source(source)
+{
+}
+
+void QwtDecimatedSeries::setEnabled(bool enabled)
+{
+  _enabled = enabled;
+  _cache_valid = false;
+}
+
+void QwtDecimatedSeries::setCanvasMap(const QwtScaleMap& x_map, double pixel_ratio)
+{
+  // logarithmic scales are not supported
+  _linear_map = (x_map.transformation() == nullptr);
+  _s1 = x_map.s1();
+  _s2 = x_map.s2();
+  _p1 = x_map.p1() * pixel_ratio;
+  _p2 = x_map.p2() * pixel_ratio;
+}
+
+bool QwtDecimatedSeries::CacheKey::operator==(const CacheKey& other) const
+{
+  return s1 == other.s1 && s2 == other.s2 && p1 == other.p1 && p2 == other.p2 &&
+         time_offset == other.time_offset && revision == other.revision &&
+         data_revision == other.data_revision;
+}
+
+QwtDecimatedSeries::CacheKey QwtDecimatedSeries::currentKey() const
+{
+  CacheKey key;
+  key.s1 = _s1;
+  key.s2 = _s2;
+  key.p1 = _p1;
+  key.p2 = _p2;
+  key.time_offset = _source->timeOffset();
+  key.revision = _source->revision();
+  key.data_revision = _source->timeseriesData()->revision();
+  return key;
+}
+
+bool QwtDecimatedSeries::isDecimating() const
+{
+  return _enabled && _linear_map && _s1 != _s2 && _p1 != _p2;
+}
+
+void QwtDecimatedSeries::refreshIndices() const
+{
+  if (!_cache_valid || !(_cache_key == currentKey()))
+  {
+    updateIndices();
+  }
+}
+
+size_t QwtDecimatedSeries::size() const
+{
+  if (!isDecimating())
+  {
+    return _source->size();
+  }
+  refreshIndices();
+  return _indices.size();
+}
+
+QPointF QwtDecimatedSeries::sample(size_t i) const
+{
+  if (!isDecimating())
+  {
+    return _source->sample(i);
+  }
+  // the data might have changed since the last call to size()
+  refreshIndices();
+  if (i >= _indices.size())
+  {
+    return _indices.empty() ? QPointF() : _source->sample(_indices.back());
+  }
+  return _source->sample(_indices[i]);
+}
+
+QRectF QwtDecimatedSeries::boundingRect() const
+{
+  return _source->boundingRect();
+}
+
+void QwtDecimatedSeries::updateIndices() const
+{
+  _cache_key = currentKey();
+  _cache_valid = true;
+  _indices.clear();
+
+  const PlotData* data = _source->timeseriesData();
+  const size_t count = data->size();
+  if (count == 0)
+  {
+    return;
+  }
+
+  // X values of the data are not shifted by the time offset
+  const double offset = _source->timeOffset();
+  const double min_x = std::min(_s1, _s2) + offset;
+  const double max_x = std::max(_s1, _s2) + offset;
+
+  size_t first = data->lowerBoundIndex(min_x);
+  size_t last = data->upperBoundIndex(max_x);
+
+  // include one sample on each side, to draw the segments crossing the borders of the canvas
+  first = (first > 0) ? first - 1 : 0;
+  last = std::min(last, count - 1);
+
+  if (last - first + 1 <= static_cast<size_t>(4.0 * std::abs(_p2 - _p1)))
+  {
+    _indices.reserve(last - first + 1);
+    for (size_t i = first; i <= last; i++)
+    {
+      _indices.push_back(i);
+    }
+    return;
+  }
+
+  // pixel column of x is floor((x - origin) * scale)
+  const double origin = _s1 + offset;
+  const double scale = (_p2 - _p1) / (_s2 - _s1);
+
+  struct Column
+  {
+    double pixel;
+    size_t first;
+    size_t last;
+    size_t min;
+    size_t max;
+    double min_y;
+    double max_y;
+  };
+  Column column = {};
+  bool column_started = false;
+
+  auto flushColumn = [&]() {
+    std::array<size_t, 4> selected = { column.first, column.min, column.max, column.last };
+    std::sort(selected.begin(), selected.end());
+    for (size_t k = 0; k < selected.size(); k++)
+    {
+      if (k == 0 || selected[k] != selected[k - 1])
+      {
+        _indices.push_back(selected[k]);
+      }
+    }
+  };
+
+  // find the chunk containing the first sample
+  size_t chunk = 0;
+  size_t chunk_end = data->chunkCount();
+  while (chunk_end - chunk > 1)
+  {
+    const size_t middle = (chunk + chunk_end) / 2;
+    if (data->chunkFirstIndex(middle) <= first)
+    {
+      chunk = middle;
+    }
+    else
+    {
+      chunk_end = middle;
+    }
+  }
+
+  // scan the contiguous arrays of the chunks
+  for (; chunk < data->chunkCount(); chunk++)
+  {
+    const size_t chunk_first = data->chunkFirstIndex(chunk);
+    if (chunk_first > last)
+    {
+      break;
+    }
+    const auto xs = data->chunkX(chunk);
+    const auto ys = data->chunkY(chunk);
+    const size_t from = (first > chunk_first) ? first - chunk_first : 0;
+    const size_t to = std::min(xs.size(), last + 1 - chunk_first);
+
+    for (size_t j = from; j < to; j++)
+    {
+      const size_t index = chunk_first + j;
+      const double pixel = std::floor((xs[j] - origin) * scale);
+      const double y = ys[j];
+
+      if (!column_started || pixel != column.pixel)
+      {
+        if (column_started)
+        {
+          flushColumn();
+        }
+        column = { pixel, index, index, index, index, y, y };
+        column_started = true;
+        continue;
+      }
+      column.last = index;
+      if (y < column.min_y)
+      {
+        column.min_y = y;
+        column.min = index;
+      }
+      if (y > column.max_y)
+      {
+        column.max_y = y;
+        column.max = index;
+      }
+    }
+  }
+  if (column_started)
+  {
+    flushColumn();
+  }
+}
+
+QwtSeriesData<QPointF>* UnwrapSeries(QwtSeriesData<QPointF>* data)
+{
+  if (auto decimated = dynamic_cast<QwtDecimatedSeries*>(data))
+  {
+    return decimated->source();
+  }
+  return data;
+}
+
+const QwtSeriesData<QPointF>* UnwrapSeries(const QwtSeriesData<QPointF>* data)
+{
+  if (auto decimated = dynamic_cast<const QwtDecimatedSeries*>(data))
+  {
+    return decimated->source();
+  }
+  return data;
+}
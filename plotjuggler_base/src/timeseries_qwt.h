@@ -7,7 +7,10 @@
 #ifndef TIMESERIES_QWT_H
 #define TIMESERIES_QWT_H
 
+#include <memory>
+#include <vector>
 #include "qwt_series_data.h"
+#include "qwt_scale_map.h"
 #include "PlotJuggler/plotdata.h"
 #include "PlotJuggler/transform_function.h"
 
@@ -54,6 +57,22 @@ public:
 
   void setTimeOffset(double offset);
 
+  const PlotData* timeseriesData() const
+  {
+    return _ts_data;
+  }
+
+  double timeOffset() const
+  {
+    return _time_offset;
+  }
+
+  // incremented every time the content of the series might have changed
+  size_t revision() const
+  {
+    return _revision;
+  }
+
   virtual RangeOpt getVisualizationRangeX() override;
 
   virtual RangeOpt getVisualizationRangeY(Range range_X) override;
@@ -67,6 +86,7 @@ public:
 protected:
   const PlotData* _ts_data;
   double _time_offset = 0.0;
+  size_t _revision = 0;
 };
 
 //------------------------------------
@@ -85,6 +105,12 @@ public:
 
   QString transformName();
 
+  // series used as input of the transform
+  const PlotData* sourceData() const
+  {
+    return _src_data;
+  }
+
   QString alias() const;
 
   void setAlias(QString alias);
@@ -98,4 +124,86 @@ protected:
 
 //---------------------------------------------------------
 
+/**
+ * @brief Adaptor used by QwtPlotCurve to draw a QwtTimeseries.
+ *
+ * Only the samples inside the visible interval are considered, plus one sample
+ * on each side. When they are more than 4 per pixel column, each column is
+ * reduced to its first, min, max and last sample (M4 aggregation): the line
+ * passing through these samples covers the same pixels of the original one.
+ *
+ * The selected indices are cached and computed again only when the X axis,
+ * the width of the canvas or the data change (see PlotDataBase::revision()).
+ */
+class QwtDecimatedSeries : public QwtSeriesData<QPointF>
+{
+public:
+  // It takes the ownership of the source
+  QwtDecimatedSeries(QwtTimeseries* source);
+
+  QwtTimeseries* source() const
+  {
+    return _source.get();
+  }
+
+  // Disable it when the single samples are drawn, for instance as dots.
+  void setEnabled(bool enabled);
+
+  bool isEnabled() const
+  {
+    return _enabled;
+  }
+
+  // Must be called before drawing, with the map of the X axis of the canvas
+  void setCanvasMap(const QwtScaleMap& x_map, double pixel_ratio);
+
+  QPointF sample(size_t i) const override;
+
+  size_t size() const override;
+
+  QRectF boundingRect() const override;
+
+  // false when all the samples of the source are drawn
+  bool isDecimating() const;
+
+private:
+  struct CacheKey
+  {
+    double s1 = 0;
+    double s2 = 0;
+    double p1 = 0;
+    double p2 = 0;
+    double time_offset = 0;
+    size_t revision = 0;
+    uint64_t data_revision = 0;
+
+    bool operator==(const CacheKey& other) const;
+  };
+
+  CacheKey currentKey() const;
+
+  // compute the indices again, if the cache is stale
+  void refreshIndices() const;
+
+  void updateIndices() const;
+
+  std::unique_ptr<QwtTimeseries> _source;
+  bool _enabled = true;
+  bool _linear_map = false;
+  double _s1 = 0;
+  double _s2 = 0;
+  double _p1 = 0;
+  double _p2 = 0;
+
+  mutable bool _cache_valid = false;
+  mutable CacheKey _cache_key;
+  mutable std::vector<size_t> _indices;
+};
+
+// Return the series containing all the samples, if "data" is a QwtDecimatedSeries,
+// otherwise "data" itself.
+QwtSeriesData<QPointF>* UnwrapSeries(QwtSeriesData<QPointF>* data);
+
+const QwtSeriesData<QPointF>* UnwrapSeries(const QwtSeriesData<QPointF>* data);
+
 #endif  // PLOTDATA_H
@@ -0,0 +1,99 @@
+#include "PlotJuggler/chunk_codec.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+using PJ::ChunkCodec;
+
+namespace
+{
+// the codec is lossless: compare the bits, not the values (NaN, -0.0)
+bool SameBits(double a, double b)
+{
+  return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+void ExpectRoundTrip(const std::vector<double>& x, const std::vector<double>& y)
+{
+  std::vector<uint64_t> packed;
+  ChunkCodec::encode(x, y, packed);
+
+  std::vector<double> out_x(x.size());
+  std::vector<double> out_y(y.size());
+  ChunkCodec::decode(packed, x.size(), out_x.data(), out_y.data());
+  for (size_t i = 0; i < x.size(); i++)
+  {
+    ASSERT_TRUE(SameBits(x[i], out_x[i])) << "x at index " << i;
+    ASSERT_TRUE(SameBits(y[i], out_y[i])) << "y at index " << i;
+  }
+
+  // the same values, without x
+  ChunkCodec::encodeValues(y, packed);
+  std::fill(out_y.begin(), out_y.end(), 0.0);
+  ChunkCodec::decodeValues(packed, y.size(), out_y.data());
+  for (size_t i = 0; i < y.size(); i++)
+  {
+    ASSERT_TRUE(SameBits(y[i], out_y[i])) << "y only, at index " << i;
+  }
+}
+}  // namespace
+
+TEST(ChunkCodec, SingleSample)
+{
+  ExpectRoundTrip({ 1.5 }, { -3.25 });
+}
+
+TEST(ChunkCodec, RegularPeriod)
+{
+  std::vector<double> x, y;
+  for (int i = 0; i < 4096; i++)
+  {
+    x.push_back(1000.0 + i * 0.01);
+    y.push_back(std::sin(i * 0.1));
+  }
+  ExpectRoundTrip(x, y);
+}
+
+TEST(ChunkCodec, RegularPeriodIsCompact)
+{
+  // integer timestamps and constant values: a couple of bits per sample
+  std::vector<double> x, y;
+  for (int i = 0; i < 4096; i++)
+  {
+    x.push_back(i);
+    y.push_back(42.0);
+  }
+  std::vector<uint64_t> packed;
+  ChunkCodec::encode(x, y, packed);
+  EXPECT_LT(packed.size() * sizeof(uint64_t), x.size());
+}
+
+TEST(ChunkCodec, JitteryTimestampsAndRandomValues)
+{
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> jitter(-1e-4, 1e-4);
+  std::uniform_real_distribution<double> value(-1e6, 1e6);
+  std::vector<double> x, y;
+  double t = 1.6e9;
+  for (int i = 0; i < 4096; i++)
+  {
+    t += 0.001 + jitter(rng);
+    x.push_back(t);
+    y.push_back(value(rng));
+  }
+  ExpectRoundTrip(x, y);
+}
+
+TEST(ChunkCodec, SpecialValues)
+{
+  const double inf = std::numeric_limits<double>::infinity();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  std::vector<double> x = { 0.0, -0.0, 1e-300, 1e300, -1e300, 5.0, 5.0, 4.0 };
+  std::vector<double> y = { nan, -0.0, inf, -inf, std::numeric_limits<double>::denorm_min(),
+                            0.0, std::numeric_limits<double>::max(),
+                            std::numeric_limits<double>::lowest() };
+  ExpectRoundTrip(x, y);
+}
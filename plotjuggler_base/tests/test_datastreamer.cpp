@@ -0,0 +1,122 @@
+#include "PlotJuggler/datastreamer_base.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace
+{
+// receives a sample of "value" when receive() is called
+class TestStreamer : public PJ::DataStreamer
+{
+public:
+  TestStreamer()
+  {
+    setDoubleBuffering(true);
+  }
+
+  bool start(QStringList*) override
+  {
+    return true;
+  }
+
+  void shutdown() override
+  {
+  }
+
+  bool isRunning() const override
+  {
+    return true;
+  }
+
+  const char* name() const override
+  {
+    return "TestStreamer";
+  }
+
+  // a message, published as soon as it is parsed
+  void receive(double time)
+  {
+    auto lock = lockMutex();
+    dataMap().getOrCreateNumeric("value").pushBack({ time, time });
+    publishData();
+  }
+
+  // what the streamers do when no message arrives for a while
+  bool publishPending()
+  {
+    auto lock = lockMutex();
+    return hasPendingData() && publishData();
+  }
+
+  bool pending()
+  {
+    auto lock = lockMutex();
+    return hasPendingData();
+  }
+};
+
+// the main application takes the samples handed over
+bool Consume(TestStreamer& streamer, std::vector<double>& received)
+{
+  return streamer.consumeData([&](PJ::PlotDataMapRef& data) {
+    auto it = data.numeric.find("value");
+    if (it == data.numeric.end())
+    {
+      return;
+    }
+    for (size_t i = 0; i < it->second.size(); i++)
+    {
+      received.push_back(it->second[i].x);
+    }
+    it->second.clear();
+  });
+}
+}  // namespace
+
+TEST(DataStreamer, DoubleBufferingHandsOverEverySample)
+{
+  TestStreamer streamer;
+  std::vector<double> received;
+  std::vector<double> sent;
+  for (int i = 0; i < 100; i++)
+  {
+    sent.push_back(i);
+    streamer.receive(i);
+    if (i % 7 == 0)
+    {
+      Consume(streamer, received);
+    }
+  }
+  while (streamer.pending())
+  {
+    Consume(streamer, received);
+    streamer.publishPending();
+  }
+  EXPECT_EQ(received, sent);
+}
+
+TEST(DataStreamer, LastSamplesAreHandedOverWhenTheStreamStops)
+{
+  TestStreamer streamer;
+  std::vector<double> received;
+
+  streamer.receive(1);
+  EXPECT_TRUE(streamer.pending());
+
+  // the main application did not take the first sample yet: these are not handed over
+  streamer.receive(2);
+  streamer.receive(3);
+  EXPECT_FALSE(streamer.publishPending());
+
+  // no message arrives anymore
+  ASSERT_TRUE(Consume(streamer, received));
+  EXPECT_EQ(received, std::vector<double>({ 1 }));
+  EXPECT_TRUE(streamer.pending());
+
+  EXPECT_TRUE(streamer.publishPending());
+  ASSERT_TRUE(Consume(streamer, received));
+  EXPECT_EQ(received, std::vector<double>({ 1, 2, 3 }));
+
+  EXPECT_FALSE(streamer.pending());
+  EXPECT_FALSE(streamer.publishPending());
+  EXPECT_FALSE(Consume(streamer, received));
+}
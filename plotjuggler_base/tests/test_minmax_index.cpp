@@ -0,0 +1,199 @@
+#include "PlotJuggler/minmax_index.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <deque>
+#include <random>
+
+using PJ::MinMaxIndex;
+
+namespace
+{
+struct Point
+{
+  double x;
+  double y;
+};
+
+// minimal container with the interface required by MinMaxIndex
+struct Points
+{
+  std::deque<Point> values;
+
+  size_t size() const
+  {
+    return values.size();
+  }
+
+  const Point& operator[](size_t index) const
+  {
+    return values[index];
+  }
+};
+
+void ExpectQuery(const MinMaxIndex& index, const Points& points, size_t first, size_t last)
+{
+  double min_y = points[first].y;
+  double max_y = min_y;
+  for (size_t i = first; i <= last; i++)
+  {
+    min_y = std::min(min_y, points[i].y);
+    max_y = std::max(max_y, points[i].y);
+  }
+  double sum = 0;
+  double sum_squares = 0;
+  double sum_abs = 0;
+  for (size_t i = first; i <= last; i++)
+  {
+    sum += points[i].y;
+    sum_squares += points[i].y * points[i].y;
+    sum_abs += std::abs(points[i].y);
+  }
+  const auto node = index.query(points, first, last);
+  ASSERT_EQ(node.min, min_y) << "interval [" << first << ", " << last << "]";
+  ASSERT_EQ(node.max, max_y) << "interval [" << first << ", " << last << "]";
+  // the sums are accumulated in a different order
+  const double tolerance = 1e-9 * (last - first + 1) * 1e4;
+  ASSERT_NEAR(node.sum, sum, tolerance) << "interval [" << first << ", " << last << "]";
+  ASSERT_NEAR(node.sum_squares, sum_squares, tolerance);
+  ASSERT_NEAR(node.sum_abs, sum_abs, tolerance);
+}
+}  // namespace
+
+TEST(MinMaxIndex, BuildAndQuery)
+{
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> value(-100, 100);
+  Points points;
+  for (int i = 0; i < 20000; i++)
+  {
+    points.values.push_back({ double(i), value(rng) });
+  }
+  MinMaxIndex index;
+  EXPECT_FALSE(index.isBuilt());
+  index.build(points);
+  EXPECT_TRUE(index.isBuilt());
+
+  std::uniform_int_distribution<size_t> position(0, points.size() - 1);
+  for (int i = 0; i < 500; i++)
+  {
+    size_t first = position(rng);
+    size_t last = position(rng);
+    if (first > last)
+    {
+      std::swap(first, last);
+    }
+    ExpectQuery(index, points, first, last);
+  }
+  ExpectQuery(index, points, 0, points.size() - 1);
+  ExpectQuery(index, points, 4096, 4096);
+}
+
+TEST(MinMaxIndex, SlidingWindow)
+{
+  std::mt19937 rng(2);
+  std::uniform_real_distribution<double> value(-100, 100);
+  Points points;
+  MinMaxIndex index;
+  index.build(points);
+
+  for (int i = 0; i < 30000; i++)
+  {
+    const double y = value(rng);
+    points.values.push_back({ double(i), y });
+    index.pushBack(y);
+    if (points.size() > 10000)
+    {
+      points.values.pop_front();
+      index.popFront();
+    }
+    if (i % 997 == 0)
+    {
+      std::uniform_int_distribution<size_t> position(0, points.size() - 1);
+      size_t first = position(rng);
+      size_t last = position(rng);
+      if (first > last)
+      {
+        std::swap(first, last);
+      }
+      ExpectQuery(index, points, first, last);
+      ExpectQuery(index, points, 0, points.size() - 1);
+    }
+  }
+}
+
+TEST(MinMaxIndex, PopUntilEmpty)
+{
+  Points points;
+  MinMaxIndex index;
+  index.build(points);
+  for (int i = 0; i < 5000; i++)
+  {
+    points.values.push_back({ double(i), double(i % 77) });
+    index.pushBack(i % 77);
+  }
+  while (points.size() > 1)
+  {
+    points.values.pop_front();
+    index.popFront();
+  }
+  ExpectQuery(index, points, 0, 0);
+  points.values.pop_front();
+  index.popFront();
+
+  // the index restarts from scratch
+  for (int i = 0; i < 300; i++)
+  {
+    points.values.push_back({ double(i), double(-i) });
+    index.pushBack(-i);
+  }
+  ExpectQuery(index, points, 0, 299);
+  ExpectQuery(index, points, 64, 127);
+}
+
+TEST(MinMaxIndex, TruncateAndPushAgain)
+{
+  std::mt19937 rng(4);
+  std::uniform_real_distribution<double> value(-100, 100);
+  Points points;
+  MinMaxIndex index;
+  index.build(points);
+  for (int i = 0; i < 20000; i++)
+  {
+    const double y = value(rng);
+    points.values.push_back({ double(i), y });
+    index.pushBack(y);
+  }
+  for (int round = 0; round < 50; round++)
+  {
+    // remove the tail, from a random position, and push different values
+    std::uniform_int_distribution<size_t> position(0, points.size() - 1);
+    const size_t keep = (round % 10 == 0) ? points.size() - 1 - position(rng) % 64
+                                          : position(rng);
+    points.values.resize(keep);
+    index.truncate(points, keep);
+    const size_t added = 1 + position(rng) % 5000;
+    for (size_t i = 0; i < added; i++)
+    {
+      const double y = value(rng);
+      points.values.push_back({ double(i), y });
+      index.pushBack(y);
+    }
+    if (round % 3 == 0 && points.size() > 100)
+    {
+      for (int i = 0; i < 100; i++)
+      {
+        points.values.pop_front();
+        index.popFront();
+      }
+    }
+    ExpectQuery(index, points, 0, points.size() - 1);
+    std::uniform_int_distribution<size_t> new_position(0, points.size() - 1);
+    size_t first = new_position(rng);
+    size_t last = new_position(rng);
+    if (first > last)
+    {
+      std::swap(first, last);
+    }
+    ExpectQuery(index, points, first, last);
+  }
+}
@@ -0,0 +1,98 @@
+#include "PlotJuggler/timeseries.h"
+#include <algorithm>
+#include <any>
+#include <gtest/gtest.h>
+
+using Series = PJ::TimeseriesBase<double>;
+using Point = Series::Point;
+
+namespace
+{
+void Fill(Series& series, size_t count)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    series.pushBack({ double(i), double(i) });
+  }
+}
+}  // namespace
+
+// the code written when at(), operator[] and the iterators returned Point& still works
+
+TEST(PlotDataAccess, ReadingDoesNotModify)
+{
+  Series series("series", {});
+  Fill(series, 100);
+  ASSERT_TRUE(series.rangeY());
+  const auto revision = series.revision();
+
+  double sum = 0;
+  for (size_t i = 0; i < series.size(); i++)
+  {
+    const Point& p = series.at(i);
+    sum += p.y + series[i].x;
+  }
+  for (auto it = series.begin(); it != series.end(); it++)
+  {
+    sum += it->y + (*it).x;
+  }
+  const Point& front = series.front();
+  const auto& back = series.back();
+  EXPECT_EQ(sum, 4 * 4950.0);
+  EXPECT_EQ(front.x, 0.0);
+  EXPECT_EQ(back.x, 99.0);
+  EXPECT_EQ(series.revision(), revision);
+}
+
+TEST(PlotDataAccess, ModifiedSamplesInvalidateTheRanges)
+{
+  Series series("series", {});
+  Fill(series, 100);
+  ASSERT_EQ(series.rangeY()->max, 99.0);
+
+  series[10].y = 1000;
+  EXPECT_EQ(series.rangeY()->max, 1000.0);
+
+  {
+    auto p = series.at(20);
+    p.y = -5;
+    EXPECT_EQ(series.rangeY()->min, 0.0);  // stored when the copy is destroyed
+  }
+  EXPECT_EQ(series.rangeY()->min, -5.0);
+
+  series.begin()->x = 500;
+  EXPECT_EQ(series.rangeX()->max, 500.0);
+
+  series[30] = Point(30, 2000);
+  for (auto p : series)
+  {
+    p.y *= 2;
+  }
+  EXPECT_EQ(std::as_const(series)[30].y, 4000.0);
+  EXPECT_EQ(series.rangeY()->max, 4000.0);
+  EXPECT_EQ(series.rangeY()->min, -10.0);
+}
+
+TEST(PlotDataAccess, Iterators)
+{
+  Series series("series", {});
+  Fill(series, 100);
+
+  auto it = std::lower_bound(series.begin(), series.end(), 42.5,
+                             [](const Point& p, double x) { return p.x < x; });
+  ASSERT_EQ(it - series.begin(), 43);
+  series.insert(it, Point(42.5, -1));
+  EXPECT_EQ(std::as_const(series).at(43).y, -1.0);
+  EXPECT_EQ(series.size(), 101u);
+
+  Series::ConstIterator const_it = series.begin() + 43;
+  EXPECT_EQ(const_it->x, 42.5);
+
+  PJ::TimeseriesBase<std::any> any_series("any", {});
+  any_series.pushBack({ 1.0, std::any(std::string("one")) });
+  const auto& const_any = any_series;
+  EXPECT_EQ(std::any_cast<std::string>(const_any.begin()->y), "one");
+
+  any_series.begin()->y = std::string("two");
+  EXPECT_EQ(std::any_cast<std::string>(const_any.front().y), "two");
+}
@@ -0,0 +1,91 @@
+#include "PlotJuggler/plotdata.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+
+using PJ::PlotDataMapRef;
+
+namespace
+{
+void FillMap(PlotDataMapRef& map, size_t count, size_t first = 0)
+{
+  auto group = map.getOrCreateGroup("robot");
+  auto& position = map.getOrCreateNumeric("robot/position", group);
+  auto& state = map.getOrCreateStringSeries("robot/state", group);
+  for (size_t i = first; i < first + count; i++)
+  {
+    const double t = double(i) * 0.01;
+    position.pushBack({ t, std::sin(t) });
+    state.pushBack({ t, PJ::StringRef(std::to_string(i / 100)) });
+  }
+}
+}  // namespace
+
+TEST(PlotDataSnapshot, CopiesTheSeriesAndTheGroups)
+{
+  PlotDataMapRef map;
+  FillMap(map, 20000);
+
+  PlotDataMapRef snapshot = map.snapshot();
+  ASSERT_EQ(snapshot.numeric.size(), 1u);
+  ASSERT_EQ(snapshot.strings.size(), 1u);
+  ASSERT_EQ(snapshot.groups.size(), 1u);
+
+  const auto& position = map.numeric.at("robot/position");
+  const auto& position_copy = snapshot.numeric.at("robot/position");
+  ASSERT_EQ(position_copy.size(), position.size());
+  ASSERT_EQ(position_copy.group()->name(), "robot");
+  EXPECT_NE(position_copy.group(), position.group());
+  for (size_t i = 0; i < position.size(); i++)
+  {
+    ASSERT_EQ(position_copy[i].x, position[i].x);
+    ASSERT_EQ(position_copy[i].y, position[i].y);
+  }
+
+  // the index of the y values is built by the snapshot, when needed
+  const auto range = position.rangeY(100, 15000);
+  const auto range_copy = position_copy.rangeY(100, 15000);
+  ASSERT_TRUE(range && range_copy);
+  EXPECT_EQ(range_copy->min, range->min);
+  EXPECT_EQ(range_copy->max, range->max);
+
+  const auto& state = map.strings.at("robot/state");
+  const auto& state_copy = snapshot.strings.at("robot/state");
+  ASSERT_EQ(state_copy.size(), state.size());
+  for (size_t i = 0; i < state.size(); i += 97)
+  {
+    ASSERT_EQ(state_copy.getString(state_copy[i].y), state.getString(state[i].y));
+  }
+}
+
+TEST(PlotDataSnapshot, NotModifiedByTheOriginal)
+{
+  PlotDataMapRef map;
+  FillMap(map, 5000);
+  PlotDataMapRef snapshot = map.snapshot();
+
+  // new samples, also in the chunk shared with the snapshot, and new strings
+  FillMap(map, 5000, 5000);
+  map.numeric.at("robot/position").popFront();
+  map.strings.at("robot/state").clear();
+  FillMap(map, 10, 1000000);
+
+  const auto& position_copy = snapshot.numeric.at("robot/position");
+  const auto& state_copy = snapshot.strings.at("robot/state");
+  ASSERT_EQ(position_copy.size(), 5000u);
+  ASSERT_EQ(state_copy.size(), 5000u);
+  for (size_t i = 0; i < 5000; i++)
+  {
+    const double t = double(i) * 0.01;
+    ASSERT_EQ(position_copy[i].x, t);
+    ASSERT_EQ(position_copy[i].y, std::sin(t));
+    ASSERT_EQ(state_copy.getString(state_copy[i].y), std::to_string(i / 100));
+  }
+
+  // and the snapshot can be modified without changing the original
+  const size_t original_size = map.numeric.at("robot/position").size();
+  FillMap(snapshot, 10, 5000);
+  EXPECT_EQ(position_copy.size(), 5010u);
+  EXPECT_EQ(state_copy.getString(state_copy.back().y), "50");
+  EXPECT_EQ(map.numeric.at("robot/position").size(), original_size);
+}
@@ -0,0 +1,137 @@
+#include "PlotJuggler/series_cursor.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using PJ::SeriesCursor;
+using Series = PJ::TimeseriesBase<double>;
+
+namespace
+{
+// samples with irregular period and some repeated timestamps
+void Fill(Series& series, size_t count, std::mt19937& rng)
+{
+  std::uniform_real_distribution<double> period(0.0, 2.0);
+  double x = series.size() == 0 ? 0.0 : series.back().x;
+  for (size_t i = 0; i < count; i++)
+  {
+    x += (i % 7 == 3) ? 0.0 : period(rng);
+    series.pushBack({ x, double(i) });
+  }
+}
+
+std::vector<double> Queries(const Series& series, size_t count, std::mt19937& rng)
+{
+  // also before the first and after the last sample
+  std::uniform_real_distribution<double> dist(series.front().x - 5, series.back().x + 5);
+  std::vector<double> queries;
+  for (size_t i = 0; i < count; i++)
+  {
+    queries.push_back(dist(rng));
+  }
+  // exact timestamps, including the repeated ones
+  for (size_t i = 0; i < series.size(); i += 5)
+  {
+    queries.push_back(series.at(i).x);
+  }
+  return queries;
+}
+
+void ExpectSameResults(const Series& series, SeriesCursor<double>& cursor,
+                       const std::vector<double>& queries)
+{
+  for (double x : queries)
+  {
+    ASSERT_EQ(cursor.lowerBound(x), series.lowerBoundIndex(x)) << "x = " << x;
+    ASSERT_EQ(cursor.indexFromX(x), series.getIndexFromX(x)) << "x = " << x;
+    ASSERT_EQ(cursor.yFromX(x), series.getYfromX(x)) << "x = " << x;
+  }
+}
+
+void ExpectSameResultsInAnyOrder(const Series& series, SeriesCursor<double>& cursor,
+                                 std::vector<double> queries, std::mt19937& rng)
+{
+  std::sort(queries.begin(), queries.end());
+  ExpectSameResults(series, cursor, queries);
+
+  std::reverse(queries.begin(), queries.end());
+  ExpectSameResults(series, cursor, queries);
+
+  std::shuffle(queries.begin(), queries.end(), rng);
+  ExpectSameResults(series, cursor, queries);
+}
+}  // namespace
+
+TEST(SeriesCursor, EmptySeries)
+{
+  Series series("empty", {});
+  SeriesCursor<double> cursor(&series);
+  EXPECT_EQ(cursor.lowerBound(1.0), 0u);
+  EXPECT_EQ(cursor.indexFromX(1.0), -1);
+  EXPECT_FALSE(cursor.yFromX(1.0).has_value());
+}
+
+TEST(SeriesCursor, MatchesBinarySearch)
+{
+  std::mt19937 rng(42);
+  Series series("series", {});
+  Fill(series, 20000, rng);
+  const auto queries = Queries(series, 5000, rng);
+
+  for (bool interpolation : { false, true })
+  {
+    SeriesCursor<double> cursor(&series);
+    cursor.setInterpolation(interpolation);
+    ExpectSameResultsInAnyOrder(series, cursor, queries, rng);
+  }
+}
+
+TEST(SeriesCursor, SeriesModifiedBetweenQueries)
+{
+  std::mt19937 rng(7);
+  Series series("series", {});
+  Fill(series, 10000, rng);
+
+  for (bool interpolation : { false, true })
+  {
+    SeriesCursor<double> cursor(&series);
+    cursor.setInterpolation(interpolation);
+
+    // the remembered position is past the end, after the pops
+    cursor.lowerBound(series.back().x);
+    for (int i = 0; i < 6000; i++)
+    {
+      series.popFront();
+    }
+    ExpectSameResultsInAnyOrder(series, cursor, Queries(series, 2000, rng), rng);
+
+    // samples inserted before the remembered position
+    cursor.lowerBound(series.back().x);
+    std::uniform_real_distribution<double> dist(series.front().x, series.back().x);
+    for (int i = 0; i < 500; i++)
+    {
+      series.pushBack({ dist(rng), -1.0 });
+    }
+    ExpectSameResultsInAnyOrder(series, cursor, Queries(series, 2000, rng), rng);
+
+    // samples appended
+    Fill(series, 3000, rng);
+    ExpectSameResultsInAnyOrder(series, cursor, Queries(series, 2000, rng), rng);
+  }
+}
+
+TEST(SeriesCursor, SeriesCleared)
+{
+  std::mt19937 rng(3);
+  Series series("series", {});
+  Fill(series, 1000, rng);
+
+  SeriesCursor<double> cursor(&series);
+  cursor.lowerBound(series.back().x);
+  series.clear();
+  EXPECT_EQ(cursor.indexFromX(1.0), -1);
+
+  Fill(series, 10, rng);
+  ExpectSameResults(series, cursor, Queries(series, 100, rng));
+}
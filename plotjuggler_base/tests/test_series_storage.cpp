@@ -0,0 +1,346 @@
+#include "PlotJuggler/series_storage.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using PJ::SeriesStorage;
+using PJ::TimeColumn;
+
+namespace
+{
+struct Point
+{
+  double x;
+  double y;
+  Point(double x_, double y_) : x(x_), y(y_)
+  {
+  }
+  Point() = default;
+};
+
+struct StringPoint
+{
+  double x;
+  std::string y;
+  StringPoint(double x_, std::string y_) : x(x_), y(std::move(y_))
+  {
+  }
+  StringPoint() = default;
+};
+
+using Storage = SeriesStorage<Point>;
+constexpr size_t CHUNK = Storage::CHUNK_SIZE;
+
+void Fill(Storage& storage, size_t count, double first_x = 0)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    storage.push_back(Point(first_x + i, (first_x + i) * 0.5));
+  }
+}
+
+// concatenating the chunks gives all the samples
+void ExpectChunksMatch(const Storage& storage)
+{
+  size_t index = 0;
+  for (size_t c = 0; c < storage.chunkCount(); c++)
+  {
+    ASSERT_EQ(storage.chunkFirstIndex(c), index);
+    const auto xs = storage.chunkX(c);
+    const auto ys = storage.chunkY(c);
+    ASSERT_EQ(xs.size(), ys.size());
+    ASSERT_EQ(storage.chunkBackX(c), xs[xs.size() - 1]);
+    for (size_t i = 0; i < xs.size(); i++, index++)
+    {
+      ASSERT_EQ(xs[i], storage[index].x);
+      ASSERT_EQ(ys[i], storage[index].y);
+    }
+  }
+  ASSERT_EQ(index, storage.size());
+}
+}  // namespace
+
+TEST(SeriesStorage, PushAndRead)
+{
+  Storage storage;
+  EXPECT_TRUE(storage.empty());
+  Fill(storage, 3 * CHUNK + 10);
+  ASSERT_EQ(storage.size(), 3 * CHUNK + 10);
+  EXPECT_EQ(storage.chunkCount(), 4u);
+  EXPECT_EQ(storage.front().x, 0.0);
+  EXPECT_EQ(storage.back().x, double(3 * CHUNK + 9));
+  EXPECT_EQ(storage[CHUNK].y, CHUNK * 0.5);
+  ExpectChunksMatch(storage);
+
+  size_t count = 0;
+  for (const auto& p : storage)
+  {
+    ASSERT_EQ(p.x, double(count));
+    count++;
+  }
+  EXPECT_EQ(count, storage.size());
+}
+
+TEST(SeriesStorage, PopFront)
+{
+  Storage storage;
+  Fill(storage, 2 * CHUNK + 5);
+  for (size_t i = 0; i < CHUNK + 3; i++)
+  {
+    storage.pop_front();
+  }
+  ASSERT_EQ(storage.size(), CHUNK + 2);
+  // the first chunk was released
+  EXPECT_EQ(storage.chunkCount(), 2u);
+  EXPECT_EQ(storage.front().x, double(CHUNK + 3));
+  ExpectChunksMatch(storage);
+
+  while (!storage.empty())
+  {
+    storage.pop_front();
+  }
+  EXPECT_EQ(storage.chunkCount(), 0u);
+  Fill(storage, 10);
+  EXPECT_EQ(storage.front().x, 0.0);
+}
+
+TEST(SeriesStorage, Append)
+{
+  Storage reference;
+  Storage storage;
+  Fill(storage, 100);
+  Fill(reference, 100);
+
+  std::vector<double> xs, ys;
+  for (size_t i = 100; i < 3 * CHUNK; i++)
+  {
+    xs.push_back(i);
+    ys.push_back(i * 0.5);
+  }
+  storage.append(xs, ys);
+  Fill(reference, 3 * CHUNK - 100, 100);
+
+  ASSERT_EQ(storage.size(), reference.size());
+  for (size_t i = 0; i < storage.size(); i++)
+  {
+    ASSERT_EQ(storage[i].x, reference[i].x);
+    ASSERT_EQ(storage[i].y, reference[i].y);
+  }
+  ExpectChunksMatch(storage);
+}
+
+TEST(SeriesStorage, InsertAndOverwrite)
+{
+  Storage storage;
+  for (size_t i = 0; i < CHUNK + 10; i++)
+  {
+    storage.push_back(Point(2.0 * i, 1.0));
+  }
+  // insert in the first chunk: the samples are shifted across the border of the chunks
+  storage.insert(5, Point(9.0, -1.0));
+  ASSERT_EQ(storage.size(), CHUNK + 11);
+  EXPECT_EQ(storage[4].x, 8.0);
+  EXPECT_EQ(storage[5].x, 9.0);
+  EXPECT_EQ(storage[6].x, 10.0);
+  EXPECT_EQ(storage.back().x, 2.0 * (CHUNK + 9));
+  ExpectChunksMatch(storage);
+
+  std::vector<double> xs = { 100.5, 101.5, 102.5 };
+  std::vector<double> ys = { 7.0, 8.0, 9.0 };
+  // two samples are overwritten, the third one is appended
+  storage.overwrite(storage.size() - 2, xs, ys);
+  ASSERT_EQ(storage.size(), CHUNK + 12);
+  EXPECT_EQ(storage.back().x, 102.5);
+  EXPECT_EQ(storage[storage.size() - 3].y, 7.0);
+  ExpectChunksMatch(storage);
+}
+
+TEST(SeriesStorage, CopiesAreSnapshots)
+{
+  Storage storage;
+  Fill(storage, CHUNK + 100);
+  const Storage snapshot = storage;
+
+  // the original keeps growing and changing, the snapshot does not
+  Fill(storage, 2 * CHUNK, CHUNK + 100);
+  storage.setY(0, -1.0);
+  storage.mutableAt(CHUNK + 50).x = -2.0;
+  storage.pop_front();
+
+  ASSERT_EQ(snapshot.size(), CHUNK + 100);
+  EXPECT_EQ(snapshot[0].y, 0.0);
+  EXPECT_EQ(snapshot[CHUNK + 50].x, double(CHUNK + 50));
+  EXPECT_EQ(snapshot.back().x, double(CHUNK + 99));
+  ExpectChunksMatch(snapshot);
+
+  EXPECT_EQ(storage[CHUNK + 49].x, -2.0);
+  ExpectChunksMatch(storage);
+}
+
+TEST(SeriesStorage, Compression)
+{
+  Storage storage;
+  storage.setCompression(true);
+  Fill(storage, 6 * CHUNK + 1);
+  const size_t compressed = storage.memoryUsage();
+
+  Storage plain;
+  Fill(plain, 6 * CHUNK + 1);
+  EXPECT_LT(compressed, plain.memoryUsage());
+  ExpectChunksMatch(storage);
+
+  // modifying a sealed chunk decodes it, it is sealed again by the next chunk
+  storage.setY(10, 123.0);
+  EXPECT_EQ(storage[10].y, 123.0);
+  Fill(storage, CHUNK, 6 * CHUNK + 1);
+  EXPECT_EQ(storage[10].y, 123.0);
+  ExpectChunksMatch(storage);
+
+  storage.setCompression(false);
+  EXPECT_EQ(storage[10].y, 123.0);
+  ExpectChunksMatch(storage);
+}
+
+TEST(SeriesStorage, InterleavedReadsOfCompressedChunks)
+{
+  Storage storage;
+  storage.setCompression(true);
+  Fill(storage, 8 * CHUNK);
+  // alternate between more chunks than the decode cache can hold
+  for (size_t round = 0; round < 3; round++)
+  {
+    for (size_t c = 0; c < 6; c++)
+    {
+      const size_t index = c * CHUNK + round * 7;
+      ASSERT_EQ(storage[index].x, double(index));
+      ASSERT_EQ(storage[index].y, index * 0.5);
+    }
+  }
+  ExpectChunksMatch(storage);
+}
+
+TEST(SeriesStorage, TimeColumnSharing)
+{
+  auto column = std::make_shared<TimeColumn>();
+  Storage a;
+  Storage b;
+  a.setTimeColumn(column);
+  b.setTimeColumn(column);
+  for (size_t i = 0; i < 2 * CHUNK; i++)
+  {
+    a.push_back(Point(i, 1.0));
+    b.push_back(Point(i, 2.0));
+  }
+  EXPECT_EQ(column->size(), 2 * CHUNK);
+  EXPECT_EQ(a.timeColumn(), column);
+  EXPECT_EQ(b.timeColumn(), column);
+  // each storage pays for half of the x values
+  Storage alone;
+  Fill(alone, 2 * CHUNK);
+  EXPECT_LT(a.memoryUsage(), alone.memoryUsage());
+
+  // setY() does not touch x: the storage keeps following the column
+  a.setY(5, 10.0);
+  EXPECT_EQ(a.timeColumn(), column);
+  EXPECT_EQ(a[5].y, 10.0);
+
+  // a different x stops the sharing, the values are preserved
+  a.push_back(Point(2 * CHUNK, 1.0));
+  b.push_back(Point(2 * CHUNK + 0.5, 3.0));
+  EXPECT_EQ(a.timeColumn(), column);
+  EXPECT_EQ(b.timeColumn(), nullptr);
+  EXPECT_EQ(b[7].x, 7.0);
+  ExpectChunksMatch(a);
+  ExpectChunksMatch(b);
+}
+
+TEST(SeriesStorage, CompressedChunksKeepSharingTheColumn)
+{
+  auto column = std::make_shared<TimeColumn>();
+  Storage a;
+  Storage b;
+  Storage plain;
+  a.setCompression(true);
+  b.setCompression(true);
+  a.setTimeColumn(column);
+  b.setTimeColumn(column);
+  plain.setTimeColumn(column);
+  for (size_t i = 0; i < 6 * CHUNK; i++)
+  {
+    a.push_back(Point(i * 0.001, 1.0));
+    b.push_back(Point(i * 0.001, double(i % 7)));
+    plain.push_back(Point(i * 0.001, 1.0));
+  }
+  EXPECT_EQ(a.timeColumn(), column);
+  EXPECT_EQ(b.timeColumn(), column);
+  EXPECT_EQ(plain.timeColumn(), column);
+  // the sealed chunks store only y, x is still paid once by the column
+  const size_t hot_y = Storage::HOT_CHUNKS * CHUNK * sizeof(double);
+  EXPECT_LT(a.memoryUsage() - hot_y, (plain.memoryUsage() - hot_y) / 2);
+  ExpectChunksMatch(a);
+  ExpectChunksMatch(b);
+
+  // a sealed chunk is decoded, but x stays shared
+  b.setY(10, -1.0);
+  EXPECT_EQ(b.timeColumn(), column);
+  EXPECT_EQ(b[10].y, -1.0);
+  EXPECT_EQ(b[10].x, 10 * 0.001);
+  ExpectChunksMatch(b);
+}
+
+TEST(SeriesStorage, AttachToColumn)
+{
+  Storage a;
+  Storage b;
+  Storage c;
+  Fill(a, 2 * CHUNK + 10);
+  Fill(b, 2 * CHUNK + 10);
+  for (size_t i = 0; i < 20; i++)
+  {
+    b.pop_front();
+  }
+  Fill(c, 2 * CHUNK + 10, 0.5);
+
+  // the first storage appends its x values to the empty column
+  auto column = std::make_shared<TimeColumn>();
+  a.setTimeColumn(column);
+  ASSERT_EQ(a.timeColumn(), column);
+  EXPECT_EQ(column->size(), 2 * CHUNK + 10);
+  ExpectChunksMatch(a);
+
+  // the second one finds them in the column, with a different first sample
+  const size_t alone = b.memoryUsage();
+  b.setTimeColumn(column);
+  ASSERT_EQ(b.timeColumn(), column);
+  EXPECT_LT(b.memoryUsage(), alone);
+  EXPECT_EQ(b.columnPosition(), a.columnPosition() + 20);
+  EXPECT_EQ(b.size(), 2 * CHUNK - 10);
+  EXPECT_EQ(b.front().x, 20.0);
+  ExpectChunksMatch(b);
+
+  // different x values can not follow the column
+  c.setTimeColumn(column);
+  EXPECT_EQ(c.timeColumn(), nullptr);
+  EXPECT_EQ(column->size(), 2 * CHUNK + 10);
+  ExpectChunksMatch(c);
+
+  // mutable access might change x: stop following
+  a.mutableAt(3).y = 5.0;
+  EXPECT_EQ(a.timeColumn(), nullptr);
+  EXPECT_EQ(a[3].y, 5.0);
+  ExpectChunksMatch(a);
+}
+
+TEST(SeriesStorage, NonTrivialValues)
+{
+  SeriesStorage<StringPoint> storage;
+  for (size_t i = 0; i < CHUNK + 3; i++)
+  {
+    storage.push_back(StringPoint(i, std::to_string(i)));
+  }
+  EXPECT_EQ(storage[CHUNK + 1].y, std::to_string(CHUNK + 1));
+  storage.setY(2, "two");
+  EXPECT_EQ(storage[2].y, "two");
+  storage.pop_front();
+  EXPECT_EQ(storage.front().y, "1");
+}
@@ -0,0 +1,114 @@
+#include "PlotJuggler/sliding_minmax.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+
+using PJ::SlidingMinMax;
+
+TEST(SlidingMinMax, Empty)
+{
+  SlidingMinMax<double> tracker;
+  EXPECT_TRUE(tracker.empty());
+  tracker.pushBack(1.0);
+  EXPECT_FALSE(tracker.empty());
+  tracker.popFront();
+  EXPECT_TRUE(tracker.empty());
+  // popping an empty tracker is a no-op
+  tracker.popFront();
+  EXPECT_TRUE(tracker.empty());
+}
+
+TEST(SlidingMinMax, MatchesBruteForce)
+{
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<int> value(-50, 50);
+  std::uniform_int_distribution<int> action(0, 2);
+
+  SlidingMinMax<int> tracker;
+  std::deque<int> window;
+  for (int i = 0; i < 20000; i++)
+  {
+    // push twice as often as pop, duplicates included
+    if (action(rng) != 0 || window.empty())
+    {
+      const int v = value(rng);
+      tracker.pushBack(v);
+      window.push_back(v);
+    }
+    else
+    {
+      tracker.popFront();
+      window.pop_front();
+    }
+    ASSERT_EQ(tracker.empty(), window.empty());
+    if (!window.empty())
+    {
+      ASSERT_EQ(tracker.min(), *std::min_element(window.begin(), window.end()));
+      ASSERT_EQ(tracker.max(), *std::max_element(window.begin(), window.end()));
+    }
+  }
+}
+
+TEST(SlidingMinMax, Clear)
+{
+  SlidingMinMax<double> tracker;
+  for (int i = 0; i < 10; i++)
+  {
+    tracker.pushBack(i);
+  }
+  tracker.clear();
+  EXPECT_TRUE(tracker.empty());
+  tracker.pushBack(-3.0);
+  EXPECT_EQ(tracker.min(), -3.0);
+  EXPECT_EQ(tracker.max(), -3.0);
+}
+
+TEST(SlidingMinMax, TruncateAndMerge)
+{
+  std::mt19937 rng(5);
+  std::uniform_int_distribution<int> value(-50, 50);
+  std::uniform_int_distribution<int> action(0, 20);
+
+  SlidingMinMax<int> tracker;
+  std::deque<int> window;
+  for (int i = 0; i < 20000; i++)
+  {
+    const int a = action(rng);
+    if (a == 0 && !window.empty())
+    {
+      // as a merge: the newest values are pushed again, shuffled and with new ones
+      const size_t keep = std::uniform_int_distribution<size_t>(0, window.size() - 1)(rng);
+      std::vector<int> removed(window.begin() + keep, window.end());
+      removed.push_back(value(rng));
+      removed.push_back(value(rng) - 20);
+      std::shuffle(removed.begin(), removed.end(), rng);
+      window.resize(keep);
+      tracker.truncate(keep);
+      for (int v : removed)
+      {
+        tracker.pushBack(v);
+        window.push_back(v);
+      }
+    }
+    else if (a < 14 || window.empty())
+    {
+      // with a trend, so that the queues are long
+      const int v = value(rng) + ((a % 2) ? i / 50 : -i / 50);
+      tracker.pushBack(v);
+      window.push_back(v);
+    }
+    else
+    {
+      tracker.popFront();
+      window.pop_front();
+    }
+    ASSERT_EQ(tracker.empty(), window.empty());
+    if (!window.empty())
+    {
+      ASSERT_EQ(tracker.min(), *std::min_element(window.begin(), window.end()));
+      ASSERT_EQ(tracker.max(), *std::max_element(window.begin(), window.end()));
+    }
+  }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include "mcap/reader.hpp"
+
+// Reading of the summary and of the messages of a MCAP file, shared by the
+// MCAP loader and the MCAP replay streamer.
+
+enum class MessageReadMode
+{
+  ReaderMessages,
+  SelectiveSummaryRange,
+  TolerantScan
+};
+
+struct McapSummaryInfo
+{
+  std::unordered_map<mcap::SchemaId, mcap::SchemaPtr> schemas;
+  std::unordered_map<mcap::ChannelId, mcap::ChannelPtr> channels;
+  std::optional<mcap::Statistics> statistics;
+  mcap::ByteOffset summaryStart = 0;
+  mcap::ByteOffset dataStart = 0;
+  mcap::ByteOffset dataEnd = 0;
+  std::optional<mcap::Status> recoveryProblem;
+  // how readMcapMessages() reads the messages
+  MessageReadMode readMode = MessageReadMode::ReaderMessages;
+};
+
+// Reads only Schema, Channel, and Statistics records from the MCAP summary
+// by using SummaryOffset entries to seek directly to each group, skipping
+// expensive MessageIndex and ChunkIndex data.
+mcap::Status readSelectiveSummary(mcap::IReadable& reader, McapSummaryInfo& info);
+
+// Scans the records of a file with a damaged summary/footer, until the first unreadable one.
+mcap::Status readTolerantSummary(mcap::McapReader& reader, McapSummaryInfo& info);
+
+// Try the selective read first; if the summary/footer is damaged, fall back to sequential
+// scans. tryCorruptedFile() is called to ask whether a corrupted file should be read anyway.
+// Returns false if the summary can't be read (status tells why) or if the user gave up
+// (status is ok).
+bool readMcapSummary(mcap::McapReader& reader, McapSummaryInfo& info, mcap::Status& status,
+                     const std::function<bool()>& tryCorruptedFile);
+
+// Call onMessage for each message of the file, in the order in which they are stored,
+// until it returns false. readMcapSummary() must be called first.
+void readMcapMessages(mcap::McapReader& reader, const McapSummaryInfo& info,
+                      const std::function<bool(const mcap::Message&)>& onMessage);
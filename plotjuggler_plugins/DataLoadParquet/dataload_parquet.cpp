@@ -387,32 +387,38 @@ bool DataLoadParquet::readDataFromFile(FileLoadInfo* info, PlotDataMapRef& plot_
     std::sort(timestamp_to_row_index.begin(), timestamp_to_row_index.end(),
               [](const auto& a, const auto& b) { return a.first < b.first; });
 
+    // the same (ordered) timestamps are used by all the columns of the batch
+    std::vector<double> batch_timestamps(batch_rows);
+    for (int64_t row = 0; row < batch_rows; row++)
+    {
+      batch_timestamps[row] = (timestamp_column >= 0) ? timestamp_to_row_index[row].first :
+                                                        static_cast<double>(rows_processed + row);
+    }
+    std::vector<double> batch_values(batch_rows);
+
     int column = 0;
 
     for (const auto& info : columns_info)
     {
       const auto values_array = batch->column(info.column_index);
 
-      for (int64_t row = 0; row < batch_rows; row++)
+      if (info.numeric_data)
       {
-        size_t ordered_row = row;
-        double timestamp = static_cast<double>(rows_processed + row);
-        if (timestamp_column >= 0)
+        for (int64_t row = 0; row < batch_rows; row++)
         {
-          timestamp = timestamp_to_row_index[row].first;
-          ordered_row = timestamp_to_row_index[row].second;
+          const size_t ordered_row =
+              (timestamp_column >= 0) ? timestamp_to_row_index[row].second : row;
+          batch_values[row] = get_arrow_value(values_array, ordered_row, info.arrow_type);
         }
-
-        if (info.numeric_data)
-        {
-          double value = get_arrow_value(values_array, ordered_row, info.arrow_type);
-          if (!std::isnan(value))
-          {
-            info.numeric_data->pushBack({ timestamp, value });
-          }
-        }
-        else if (info.string_data)
+        // NaN values are skipped
+        info.numeric_data->pushBackBatch(batch_timestamps, batch_values);
+      }
+      else if (info.string_data)
+      {
+        for (int64_t row = 0; row < batch_rows; row++)
         {
+          const size_t ordered_row =
+              (timestamp_column >= 0) ? timestamp_to_row_index[row].second : row;
           if (values_array->IsNull(ordered_row))
           {
             continue;
@@ -437,7 +443,7 @@ bool DataLoadParquet::readDataFromFile(FileLoadInfo* info, PlotDataMapRef& plot_
           }
           if (!view.empty())
           {
-            info.string_data->pushBack({ timestamp, StringRef(view) });
+            info.string_data->pushBack({ batch_timestamps[row], StringRef(view) });
           }
         }
       }
@@ -9,6 +9,7 @@
 
 #include "ulog_parser.h"
 #include "ulog_parameters_dialog.h"
+#include <algorithm>
 
 DataLoadULog::DataLoadULog() : _main_win(nullptr)
 {
@@ -58,21 +59,29 @@ bool DataLoadULog::readDataFromFile(FileLoadInfo* fileload_info, PlotDataMapRef&
     const ULogParser::Timeseries& timeseries = it.second;
     auto group = plot_data.getOrCreateGroup(sucsctiption_name);
 
+    // all the fields of the subscription share the same timestamps
+    std::vector<double> msg_times(timeseries.timestamps.size());
+    for (size_t i = 0; i < msg_times.size(); i++)
+    {
+      const uint64_t timestamp = timeseries.timestamps[i].value_or(static_cast<uint64_t>(i));
+      msg_times[i] = static_cast<double>(timestamp) * 0.000001;
+    }
+
     for (const auto& data : timeseries.data)
     {
       std::string series_name = sucsctiption_name + data.first;
 
       auto series = plot_data.addNumeric(series_name, group);
 
-      for (size_t i = 0; i < data.second.size(); i++)
+      assert(data.second.size() <= msg_times.size());
+      const size_t count = std::min(data.second.size(), msg_times.size());
+      if (count > 0)
       {
-        assert(i < timeseries.timestamps.size());
-        const uint64_t timestamp = timeseries.timestamps[i].value_or(static_cast<uint64_t>(i));
-        double msg_time = static_cast<double>(timestamp) * 0.000001;
-        min_msg_time = std::min(min_msg_time, msg_time);
-        PlotData::Point point(msg_time, data.second[i]);
-        series->second.pushBack(point);
+        min_msg_time =
+            std::min(min_msg_time, *std::min_element(msg_times.begin(), msg_times.begin() + count));
       }
+      series->second.pushBackBatch(PJ::Span<const double>(msg_times.data(), count),
+                                   PJ::Span<const double>(data.second.data(), count));
     }
   }
 
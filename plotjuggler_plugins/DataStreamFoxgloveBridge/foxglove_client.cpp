@@ -357,8 +357,12 @@ bool FoxgloveBridgeClient::subscribeSelectedChannels(
 #ifdef PJ_BUILD
     try
     {
-      auto parser = parser_it->second->createParser(
-          channel.topic.toStdString(), channel.schema_name.toStdString(), schema_data, dataMap());
+      PJ::MessageSchema schema;
+      schema.encoding = channel.encoding.toStdString();
+      schema.schema_encoding = channel.schema_encoding.toStdString();
+      schema.name = channel.schema_name.toStdString();
+      schema.definition = schema_data;
+      auto parser = createParser(*parser_it->second, channel.topic.toStdString(), schema);
       if (!parser)
       {
         failures.push_back(QString("%1: parser creation returned null").arg(channel.topic));
@@ -735,8 +739,9 @@ void FoxgloveBridgeClient::onBinaryMessageReceived(const QByteArray& message)
   QString parse_error;
   try
   {
-    std::lock_guard<std::mutex> lock(mutex());
-    parser_it.value()->parseMessage(PJ::MessageRef(ptr, size_t(end - ptr)), timestamp);
+    auto lock = lockMutex();
+    parseMessageWithMetrics(*parser_it.value(), PJ::MessageRef(ptr, size_t(end - ptr)),
+                            timestamp);
   }
   catch (std::exception& ex)
   {
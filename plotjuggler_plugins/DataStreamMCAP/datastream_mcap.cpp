@@ -0,0 +1,476 @@
+#include "datastream_mcap.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDebug>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QDir>
+#include <QDoubleSpinBox>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFormLayout>
+#include <QMessageBox>
+#include <QSettings>
+#include <QVBoxLayout>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <set>
+
+#include "dialog_mcap.h"
+
+using namespace PJ;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// the samples are handed over to the application at least this often
+constexpr auto PUBLISH_PERIOD = std::chrono::milliseconds(20);
+// the longest sleep, to react quickly to shutdown()
+constexpr auto MAX_SLEEP = std::chrono::milliseconds(50);
+// how often the GUI is checked, while waiting for it to take the last samples
+constexpr auto PENDING_CHECK_PERIOD = std::chrono::milliseconds(5);
+
+enum ReplayMode
+{
+  REAL_TIME = 0,
+  SPEED_FACTOR,
+  AS_FAST_AS_POSSIBLE
+};
+
+bool AskReplayOptions(DataStreamMCAP::ReplayOptions& options)
+{
+  QSettings settings;
+  const QString prefix = "DataStreamMCAP::";
+
+  QDialog dialog;
+  dialog.setWindowTitle("MCAP Replay");
+
+  auto mode_combo = new QComboBox(&dialog);
+  mode_combo->addItems({ "Real time", "Speed factor", "As fast as possible" });
+  auto speed_spin = new QDoubleSpinBox(&dialog);
+  speed_spin->setRange(0.01, 10000);
+  speed_spin->setDecimals(2);
+  speed_spin->setSuffix(" x");
+  auto loop_check = new QCheckBox("Restart from the beginning at the end of the file", &dialog);
+
+  QObject::connect(mode_combo, qOverload<int>(&QComboBox::currentIndexChanged), speed_spin,
+                   [speed_spin](int mode) { speed_spin->setEnabled(mode == SPEED_FACTOR); });
+
+  mode_combo->setCurrentIndex(settings.value(prefix + "mode", REAL_TIME).toInt());
+  speed_spin->setValue(settings.value(prefix + "speed", 2.0).toDouble());
+  speed_spin->setEnabled(mode_combo->currentIndex() == SPEED_FACTOR);
+  loop_check->setChecked(settings.value(prefix + "loop", false).toBool());
+
+  auto form = new QFormLayout();
+  form->addRow("Replay:", mode_combo);
+  form->addRow("Speed:", speed_spin);
+  form->addRow(loop_check);
+
+  auto button_box = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+  QObject::connect(button_box, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+  QObject::connect(button_box, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+  auto layout = new QVBoxLayout(&dialog);
+  layout->addLayout(form);
+  layout->addWidget(button_box);
+
+  if (dialog.exec() != QDialog::Accepted)
+  {
+    return false;
+  }
+
+  const int mode = mode_combo->currentIndex();
+  settings.setValue(prefix + "mode", mode);
+  settings.setValue(prefix + "speed", speed_spin->value());
+  settings.setValue(prefix + "loop", loop_check->isChecked());
+
+  switch (mode)
+  {
+    case REAL_TIME:
+      options.speed = 1.0;
+      break;
+    case SPEED_FACTOR:
+      options.speed = speed_spin->value();
+      break;
+    default:
+      options.speed = 0.0;
+  }
+  options.loop = loop_check->isChecked();
+  return true;
+}
+}  // namespace
+
+DataStreamMCAP::DataStreamMCAP()
+{
+  _statistics_action = new QAction(this);
+
+  connect(_statistics_action, &QAction::triggered, this, [this]() {
+    QString text;
+    {
+      std::lock_guard<std::mutex> lock(_statistics_mutex);
+      text = _statistics;
+    }
+    QMessageBox::information(nullptr, "MCAP Replay",
+                             text.isEmpty() ? "No pass completed yet" : text, QMessageBox::Ok);
+    if (_notifications_count > 0)
+    {
+      _notifications_count = 0;
+      emit notificationsChanged(_notifications_count);
+    }
+  });
+}
+
+DataStreamMCAP::~DataStreamMCAP()
+{
+  shutdown();
+}
+
+bool DataStreamMCAP::start(QStringList*)
+{
+  if (_running)
+  {
+    return true;
+  }
+  // the thread of the previous replay may have ended by itself
+  shutdown();
+
+  if (parserFactories() == nullptr || parserFactories()->empty())
+  {
+    QMessageBox::warning(nullptr, "MCAP Replay", "No available MessageParsers", QMessageBox::Ok);
+    return false;
+  }
+
+  QSettings settings;
+  const QString directory =
+      settings.value("DataStreamMCAP::directory", QDir::currentPath()).toString();
+  const QString filename = QFileDialog::getOpenFileName(nullptr, "MCAP file to replay",
+                                                        directory, "MCAP files (*.mcap)");
+  if (filename.isEmpty())
+  {
+    return false;
+  }
+  settings.setValue("DataStreamMCAP::directory", QFileInfo(filename).absolutePath());
+
+  auto status = _reader.open(filename.toStdString());
+  if (!status.ok())
+  {
+    QMessageBox::warning(nullptr, "Can't open file",
+                         QString("Code: %0\n Message: %1")
+                             .arg(int(status.code))
+                             .arg(QString::fromStdString(status.message)));
+    return false;
+  }
+
+  auto askTryCorruptedFile = []() {
+    return QMessageBox::question(nullptr, "Corrupted MCAP file",
+                                 "The MCAP file appears to be corrupted.\n\n"
+                                 "Do you want to replay the readable messages anyway?") ==
+           QMessageBox::Yes;
+  };
+  if (!readMcapSummary(_reader, _summary, status, askTryCorruptedFile))
+  {
+    if (!status.ok())
+    {
+      QMessageBox::warning(nullptr, "Can't open summary of the file",
+                           QString("Code: %0\n Message: %1")
+                               .arg(int(status.code))
+                               .arg(QString::fromStdString(status.message)));
+    }
+    _reader.close();
+    return false;
+  }
+
+  std::unordered_map<int, mcap::ChannelPtr> channels;
+  std::unordered_map<int, mcap::SchemaPtr> schemas;
+  for (const auto& [schema_id, schema_ptr] : _summary.schemas)
+  {
+    schemas.insert({ schema_id, schema_ptr });
+  }
+  for (const auto& [channel_id, channel_ptr] : _summary.channels)
+  {
+    if (schemas.count(channel_ptr->schemaId) != 0)
+    {
+      channels.insert({ channel_id, channel_ptr });
+    }
+  }
+  std::unordered_map<uint16_t, uint64_t> msg_count;
+  if (_summary.statistics)
+  {
+    msg_count = _summary.statistics->channelMessageCounts;
+  }
+
+  DialogMCAP dialog(channels, schemas, msg_count, std::nullopt);
+  if (channels.empty() || dialog.exec() != QDialog::Accepted)
+  {
+    _reader.close();
+    return false;
+  }
+  const auto params = dialog.getParams();
+
+  if (!AskReplayOptions(_options))
+  {
+    _reader.close();
+    return false;
+  }
+  _options.use_log_time = params.use_mcap_log_time;
+
+  // same lookup of the parser done by DataLoadMCAP
+  _parsers.clear();
+  std::map<std::string, std::string> failures;
+  std::set<QString> missing_encodings;
+  for (const auto& [channel_id, channel_ptr] : channels)
+  {
+    if (!params.selected_topics.contains(QString::fromStdString(channel_ptr->topic)))
+    {
+      continue;
+    }
+    const auto& mcap_schema = schemas.at(channel_ptr->schemaId);
+
+    auto it = parserFactories()->find(QString::fromStdString(channel_ptr->messageEncoding));
+    if (it == parserFactories()->end())
+    {
+      it = parserFactories()->find(QString::fromStdString(mcap_schema->encoding));
+    }
+    if (it == parserFactories()->end())
+    {
+      missing_encodings.insert(QString::fromStdString(mcap_schema->encoding));
+      continue;
+    }
+
+    MessageSchema schema;
+    schema.encoding = it->first.toStdString();
+    schema.schema_encoding = mcap_schema->encoding;
+    schema.name = mcap_schema->name;
+    schema.definition.assign(reinterpret_cast<const char*>(mcap_schema->data.data()),
+                             mcap_schema->data.size());
+    try
+    {
+      auto parser = createParser(*it->second, channel_ptr->topic, schema);
+      if (!parser)
+      {
+        failures.insert({ channel_ptr->topic, "parser creation returned null" });
+        continue;
+      }
+      parser->setLargeArraysPolicy(params.clamp_large_arrays, params.max_array_size);
+      parser->enableEmbeddedTimestamp(params.use_timestamp);
+      _parsers.insert({ channel_ptr->id, parser });
+    }
+    catch (std::exception& err)
+    {
+      failures.insert({ channel_ptr->topic, err.what() });
+    }
+  }
+
+  if (!missing_encodings.empty() || !failures.empty())
+  {
+    QString message;
+    for (const auto& encoding : missing_encodings)
+    {
+      message += QString("No parser available for encoding [%1]\n").arg(encoding);
+    }
+    for (const auto& [topic, error] : failures)
+    {
+      message += QString("Topic %1: %2\n")
+                     .arg(QString::fromStdString(topic))
+                     .arg(QString::fromStdString(error));
+    }
+    QMessageBox::warning(nullptr, "MCAP Replay", message);
+  }
+  if (_parsers.empty())
+  {
+    _reader.close();
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_statistics_mutex);
+    _statistics.clear();
+  }
+  // the GUI takes the data without locking mutex(), that is used only by this plugin
+  setDoubleBuffering(true);
+  _running = true;
+  _thread = std::thread(&DataStreamMCAP::replayLoop, this);
+  return true;
+}
+
+void DataStreamMCAP::shutdown()
+{
+  _running = false;
+  if (_thread.joinable())
+  {
+    _thread.join();
+  }
+  _parsers.clear();
+  _reader.close();
+}
+
+void DataStreamMCAP::flush(std::unique_lock<std::mutex>& lock)
+{
+  if (lock.owns_lock())
+  {
+    publishData();
+    lock.unlock();
+    emit dataReceived();
+  }
+}
+
+bool DataStreamMCAP::publishPending()
+{
+  bool published = false;
+  bool pending = false;
+  {
+    auto lock = lockMutex();
+    published = hasPendingData() && publishData();
+    pending = hasPendingData();
+  }
+  if (published)
+  {
+    emit dataReceived();
+  }
+  return pending;
+}
+
+void DataStreamMCAP::replayLoop()
+{
+  // added to the timestamps of each pass, to keep them increasing when looping
+  double time_offset = 0;
+  int pass = 0;
+
+  while (_running)
+  {
+    std::unique_lock<std::mutex> lock;
+    bool first_message = true;
+    double first_time = 0;
+    double last_time = 0;
+    Clock::time_point wall_start = Clock::now();
+    auto last_publish = wall_start;
+    size_t messages = 0;
+    size_t bytes = 0;
+    size_t errors = 0;
+
+    readMcapMessages(_reader, _summary, [&](const mcap::Message& message) {
+      if (!_running)
+      {
+        return false;
+      }
+      auto parser_it = _parsers.find(message.channelId);
+      if (parser_it == _parsers.end())
+      {
+        return true;
+      }
+      // MCAP always represents the time in nanoseconds
+      const double time =
+          double(_options.use_log_time ? message.logTime : message.publishTime) * 1e-9;
+      if (first_message)
+      {
+        first_message = false;
+        first_time = time;
+        last_time = time;
+        wall_start = Clock::now();
+      }
+      last_time = std::max(last_time, time);
+
+      if (_options.speed > 0)
+      {
+        const auto due = wall_start + std::chrono::duration_cast<Clock::duration>(
+                                          std::chrono::duration<double>((time - first_time) /
+                                                                        _options.speed));
+        if (due > Clock::now())
+        {
+          // don't keep the samples while waiting
+          flush(lock);
+          while (_running && due > Clock::now())
+          {
+            std::this_thread::sleep_until(std::min(due, Clock::now() + MAX_SLEEP));
+            publishPending();
+          }
+          last_publish = Clock::now();
+        }
+      }
+
+      if (!lock.owns_lock())
+      {
+        lock = lockMutex();
+      }
+      double timestamp = time + time_offset;
+      MessageRef msg(message.data, message.dataSize);
+      try
+      {
+        parseMessageWithMetrics(*parser_it->second, msg, timestamp);
+      }
+      catch (std::exception& err)
+      {
+        if (errors++ == 0)
+        {
+          qDebug() << "MCAP Replay, problem parsing a message:" << err.what();
+        }
+      }
+      messages++;
+      bytes += message.dataSize;
+
+      // as fast as possible, the mutex is released only when the samples are published
+      const auto now = Clock::now();
+      if (now - last_publish >= PUBLISH_PERIOD)
+      {
+        flush(lock);
+        last_publish = now;
+      }
+      return true;
+    });
+    flush(lock);
+
+    // the GUI may still be taking the previous samples (likely, as fast as possible):
+    // wait until it took all of them, before looping or closing
+    while (_running && publishPending())
+    {
+      std::this_thread::sleep_for(PENDING_CHECK_PERIOD);
+    }
+
+    if (!_running || messages == 0)
+    {
+      break;
+    }
+    pass++;
+
+    const double wall_time = std::chrono::duration<double>(Clock::now() - wall_start).count();
+    const double data_time = last_time - first_time;
+    const QString statistics =
+        QString("Pass %1: %2 messages (%3 MB) in %4 s\n"
+                "%5 messages/s, %6 MB/s, %7 x real time\n%8 messages not parsed")
+            .arg(pass)
+            .arg(messages)
+            .arg(double(bytes) / (1024 * 1024), 0, 'f', 1)
+            .arg(wall_time, 0, 'f', 3)
+            .arg(double(messages) / std::max(wall_time, 1e-9), 0, 'f', 0)
+            .arg(double(bytes) / (1024 * 1024) / std::max(wall_time, 1e-9), 0, 'f', 1)
+            .arg(data_time / std::max(wall_time, 1e-9), 0, 'f', 2)
+            .arg(errors);
+    qDebug().noquote() << "MCAP Replay." << statistics;
+    {
+      std::lock_guard<std::mutex> statistics_lock(_statistics_mutex);
+      _statistics = statistics;
+    }
+    QMetaObject::invokeMethod(this, [this]() {
+      _notifications_count = 1;
+      emit notificationsChanged(_notifications_count);
+    });
+
+    if (!_options.loop)
+    {
+      break;
+    }
+    // the next pass starts one average period after the end of this one
+    time_offset += data_time + data_time / double(messages);
+  }
+
+  if (_running)
+  {
+    // end of the file: notify the GUI, that will call shutdown()
+    _running = false;
+    emit closed();
+  }
+}
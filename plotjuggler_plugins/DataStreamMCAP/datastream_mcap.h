@@ -0,0 +1,88 @@
+#ifndef DATASTREAM_MCAP_H
+#define DATASTREAM_MCAP_H
+
+#include <QAction>
+#include <QtPlugin>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "PlotJuggler/datastreamer_base.h"
+#include "mcap_summary.h"
+
+/**
+ * Replays a MCAP file through the parsers and the streaming path, as if the messages
+ * were received from the network: in real time, N times faster or as fast as possible,
+ * optionally in a loop. Useful to reproduce and benchmark a high-rate stream.
+ *
+ * The throughput achieved by each pass is available in the notifications.
+ */
+class DataStreamMCAP : public PJ::DataStreamer
+{
+  Q_OBJECT
+  Q_PLUGIN_METADATA(IID "facontidavide.PlotJuggler3.DataStreamer")
+  Q_INTERFACES(PJ::DataStreamer)
+
+public:
+  DataStreamMCAP();
+
+  virtual ~DataStreamMCAP() override;
+
+  virtual bool start(QStringList*) override;
+
+  virtual void shutdown() override;
+
+  virtual bool isRunning() const override
+  {
+    return _running;
+  }
+
+  virtual const char* name() const override
+  {
+    return "MCAP Replay";
+  }
+
+  virtual bool isDebugPlugin() override
+  {
+    return false;
+  }
+
+  std::pair<QAction*, int> notificationAction() override
+  {
+    return { _statistics_action, _notifications_count };
+  }
+
+  struct ReplayOptions
+  {
+    /// Speed factor, relative to the time of the messages. 0 means as fast as possible.
+    double speed = 1.0;
+    bool loop = false;
+    /// Use the log time of the messages instead of their publish time.
+    bool use_log_time = false;
+  };
+
+private:
+  void replayLoop();
+
+  // publish the samples parsed so far and release the lock
+  void flush(std::unique_lock<std::mutex>& lock);
+
+  // publish the samples that the GUI was not ready to take yet.
+  // Returns true if some samples were not taken yet
+  bool publishPending();
+
+  mcap::McapReader _reader;
+  McapSummaryInfo _summary;
+  std::unordered_map<mcap::ChannelId, PJ::MessageParserPtr> _parsers;
+  ReplayOptions _options;
+
+  std::thread _thread;
+  std::atomic_bool _running = false;
+
+  QAction* _statistics_action;
+  int _notifications_count = 0;
+  std::mutex _statistics_mutex;
+  QString _statistics;
+};
+
+#endif  // DATASTREAM_MCAP_H
@@ -28,6 +28,22 @@ DataStreamMQTT::DataStreamMQTT() : _running(false)
 
   _mosq = std::make_shared<MQTTClient>();
   _dialog = new MQTT_Dialog(_mosq);
+
+  // hand over the samples that were still pending, because the GUI was busy,
+  // also when no message arrives anymore
+  _publish_timer = new QTimer(this);
+  _publish_timer->setInterval(100);
+  connect(_publish_timer, &QTimer::timeout, this, [this]() {
+    bool published = false;
+    {
+      auto lk = lockMutex();
+      published = hasPendingData() && publishData();
+    }
+    if (published)
+    {
+      emit dataReceived();
+    }
+  });
 }
 
 DataStreamMQTT::~DataStreamMQTT()
@@ -92,6 +108,9 @@ bool DataStreamMQTT::start(QStringList*)
   }
   _protocol = _dialog->ui->comboBoxProtocol->currentText();
 
+  // the GUI takes the data without locking mutex(), that is used only by this plugin
+  setDoubleBuffering(true);
+
   // remove all previous subscriptions and create new ones
   for (const auto& topic : _mosq->config().topics)
   {
@@ -110,6 +129,7 @@ bool DataStreamMQTT::start(QStringList*)
   }
 
   _running = true;
+  _publish_timer->start();
   return _running;
 }
 
@@ -118,6 +138,7 @@ void DataStreamMQTT::shutdown()
   if (_running)
   {
     _running = false;
+    _publish_timer->stop();
     _mosq->disconnect();
 
     std::unique_lock<std::mutex> lk(mutex());
@@ -166,8 +187,9 @@ PJ::MessageParserPtr DataStreamMQTT::ensureTopicParser(const std::string& topic)
     if (it == _parsers.end())
     {
       auto& parser_factory = parserFactories()->at(protocol);
-      it = _parsers.insert({ topic, parser_factory->createParser({ topic }, {}, {}, dataMap()) })
-               .first;
+      PJ::MessageSchema schema;
+      schema.encoding = protocol.toStdString();
+      it = _parsers.insert({ topic, createParser(*parser_factory, topic, schema) }).first;
     }
     parser = it->second;
   };
@@ -190,14 +212,15 @@ void DataStreamMQTT::onMessageReceived(const mosquitto_message* message)
   try
   {
     auto parser = ensureTopicParser(message->topic);
-    std::unique_lock<std::mutex> lk(mutex());
+    auto lk = lockMutex();
     MessageRef msg(static_cast<uint8_t*>(message->payload), message->payloadlen);
 
     using namespace std::chrono;
     auto ts = high_resolution_clock::now().time_since_epoch();
     double timestamp = 1e-6 * double(duration_cast<microseconds>(ts).count());
 
-    result = parser->parseMessage(msg, timestamp);
+    result = parseMessageWithMetrics(*parser, msg, timestamp);
+    publishData();
   }
   catch (std::exception&)
   {
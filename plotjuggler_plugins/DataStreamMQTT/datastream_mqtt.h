@@ -67,6 +67,8 @@ private:
   QAction* _notification_action;
   int _failed_parsing = 0;
 
+  QTimer* _publish_timer;
+
   MQTT_Dialog* _dialog;
   ParserFactoryPlugin::Ptr _current_parser_creator;
 };
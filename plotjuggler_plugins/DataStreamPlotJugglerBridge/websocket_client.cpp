@@ -553,7 +553,7 @@ bool WebsocketClient::parseDecompressedPayload(const QByteArray& decompressed,
 
   uint32_t parsed = 0;
 
-  std::lock_guard<std::mutex> lock(mutex());
+  auto lock = lockMutex();
 
   // Parse until end of payload
   while (q < qend)
@@ -776,9 +776,11 @@ void WebsocketClient::createParsersForTopics()
     }
 
     // Create parser instance
-    PJ::MessageParserPtr parser =
-        it->second->createParser(t.name.toStdString(), t.schema_name.toStdString(),
-                                 t.schema_definition.toStdString(), dataMap());
+    PJ::MessageSchema schema;
+    schema.encoding = t.schema_encoding.toStdString();
+    schema.name = t.schema_name.toStdString();
+    schema.definition = t.schema_definition.toStdString();
+    PJ::MessageParserPtr parser = createParser(*it->second, t.name.toStdString(), schema);
 
     if (!parser)
     {
@@ -806,7 +808,7 @@ void WebsocketClient::onRos2CdrMessage(const QString& topic, double ts_sec, cons
   PJ::MessageRef msg_ref(cdr, len);
   try
   {
-    it.value()->parseMessage(msg_ref, ts_sec);
+    parseMessageWithMetrics(*it.value(), msg_ref, ts_sec);
     _topic_msg_count[topic]++;
   }
   catch (std::exception& err)
@@ -3,21 +3,78 @@
 #include <QFile>
 #include <QMessageBox>
 #include <QDebug>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QDoubleSpinBox>
+#include <QFormLayout>
+#include <QSettings>
+#include <QSpinBox>
+#include <QVBoxLayout>
 #include <thread>
 #include <mutex>
 #include <chrono>
 #include <thread>
+#include <algorithm>
+#include <random>
 #include <math.h>
 
 using namespace PJ;
 
+namespace
+{
+// maximum age of the samples generated out of order, in seconds
+constexpr double OUT_OF_ORDER_MAX_DELAY = 0.1;
+// when the generator is late by more than this, it doesn't try to catch up
+constexpr auto MAX_LATENESS = std::chrono::seconds(1);
+
+const char* LABELS[] = { "RED", "BLUE", "GREEN" };
+
+const QString SETTINGS_PREFIX = "DataStreamSample::load_";
+
+LoadOptions LoadOptionsFromSettings()
+{
+  QSettings settings;
+  LoadOptions options;
+  options.threads = settings.value(SETTINGS_PREFIX + "threads", options.threads).toInt();
+  options.topics = settings.value(SETTINGS_PREFIX + "topics", options.topics).toInt();
+  options.fields = settings.value(SETTINGS_PREFIX + "fields", options.fields).toInt();
+  options.array_size = settings.value(SETTINGS_PREFIX + "array_size", 0).toInt();
+  options.string_field = settings.value(SETTINGS_PREFIX + "string_field", true).toBool();
+  options.rate = settings.value(SETTINGS_PREFIX + "rate", options.rate).toDouble();
+  options.burst = settings.value(SETTINGS_PREFIX + "burst", options.burst).toInt();
+  options.out_of_order = settings.value(SETTINGS_PREFIX + "out_of_order", 0.0).toDouble();
+  options.encoding = settings.value(SETTINGS_PREFIX + "encoding").toString().toStdString();
+  return options;
+}
+
+void SaveLoadOptionsToSettings(const LoadOptions& options)
+{
+  QSettings settings;
+  settings.setValue(SETTINGS_PREFIX + "threads", options.threads);
+  settings.setValue(SETTINGS_PREFIX + "topics", options.topics);
+  settings.setValue(SETTINGS_PREFIX + "fields", options.fields);
+  settings.setValue(SETTINGS_PREFIX + "array_size", options.array_size);
+  settings.setValue(SETTINGS_PREFIX + "string_field", options.string_field);
+  settings.setValue(SETTINGS_PREFIX + "rate", options.rate);
+  settings.setValue(SETTINGS_PREFIX + "burst", options.burst);
+  settings.setValue(SETTINGS_PREFIX + "out_of_order", options.out_of_order);
+  settings.setValue(SETTINGS_PREFIX + "encoding", QString::fromStdString(options.encoding));
+}
+}  // namespace
+
 DataStreamSample::DataStreamSample()
 {
   _dummy_notification = new QAction(this);
 
   connect(_dummy_notification, &QAction::triggered, this, [this]() {
-    QMessageBox::warning(nullptr, "Dummy Notifications",
-                         QString("%1 notifications").arg(_notifications_count), QMessageBox::Ok);
+    QString text = QString("%1 notifications").arg(_notifications_count);
+    if (!_load_topics.empty())
+    {
+      text += "\n\n" + loadStatistics();
+    }
+    QMessageBox::warning(nullptr, "Dummy Notifications", text, QMessageBox::Ok);
 
     if (_notifications_count > 0)
     {
@@ -49,13 +106,34 @@ DataStreamSample::DataStreamSample()
   auto& tc_red = dataMap().addNumeric("tc/red", tcGroup)->second;
 
   tc_red.setAttribute(TEXT_COLOR, QColor(Qt::red));
+
+  _load_options = LoadOptionsFromSettings();
 }
 
 bool DataStreamSample::start(QStringList*)
 {
+  if (!editLoadOptions() || !createLoadTopics())
+  {
+    return false;
+  }
+  // the GUI takes the data without locking mutex(), shared by the generator threads
+  setDoubleBuffering(true);
+
   _running = true;
   pushSingleCycle();
   _thread = std::thread([this]() { this->loop(); });
+
+  _load_start = std::chrono::steady_clock::now();
+  _load_messages = 0;
+  _load_samples = 0;
+  if (!_load_topics.empty())
+  {
+    const size_t threads = std::min<size_t>(_load_options.threads, _load_topics.size());
+    for (size_t i = 0; i < threads; i++)
+    {
+      _load_threads.emplace_back(&DataStreamSample::loadLoop, this, i);
+    }
+  }
   return true;
 }
 
@@ -66,6 +144,15 @@ void DataStreamSample::shutdown()
   {
     _thread.join();
   }
+  for (auto& thread : _load_threads)
+  {
+    thread.join();
+  }
+  _load_threads.clear();
+  if (!_load_topics.empty())
+  {
+    qDebug().noquote() << "Dummy Streamer." << loadStatistics();
+  }
 }
 
 bool DataStreamSample::isRunning() const
@@ -80,18 +167,233 @@ DataStreamSample::~DataStreamSample()
 
 bool DataStreamSample::xmlSaveState(QDomDocument& doc, QDomElement& parent_element) const
 {
+  QDomElement elem = doc.createElement("load");
+  elem.setAttribute("threads", _load_options.threads);
+  elem.setAttribute("topics", _load_options.topics);
+  elem.setAttribute("fields", _load_options.fields);
+  elem.setAttribute("array_size", _load_options.array_size);
+  elem.setAttribute("string_field", int(_load_options.string_field));
+  elem.setAttribute("rate", _load_options.rate);
+  elem.setAttribute("burst", _load_options.burst);
+  elem.setAttribute("out_of_order", _load_options.out_of_order);
+  elem.setAttribute("encoding", QString::fromStdString(_load_options.encoding));
+  parent_element.appendChild(elem);
   return true;
 }
 
 bool DataStreamSample::xmlLoadState(const QDomElement& parent_element)
 {
+  QDomElement elem = parent_element.firstChildElement("load");
+  if (elem.isNull())
+  {
+    return true;
+  }
+  _load_options.threads = elem.attribute("threads", "1").toInt();
+  _load_options.topics = elem.attribute("topics", "0").toInt();
+  _load_options.fields = elem.attribute("fields", "10").toInt();
+  _load_options.array_size = elem.attribute("array_size", "0").toInt();
+  _load_options.string_field = bool(elem.attribute("string_field", "1").toInt());
+  _load_options.rate = elem.attribute("rate", "100").toDouble();
+  _load_options.burst = elem.attribute("burst", "1").toInt();
+  _load_options.out_of_order = elem.attribute("out_of_order", "0").toDouble();
+  _load_options.encoding = elem.attribute("encoding").toStdString();
+  return true;
+}
+
+bool DataStreamSample::editLoadOptions()
+{
+  QDialog dialog;
+  dialog.setWindowTitle("Dummy Streamer: synthetic load");
+
+  auto threads = new QSpinBox(&dialog);
+  threads->setRange(1, 256);
+  threads->setValue(_load_options.threads);
+
+  auto topics = new QSpinBox(&dialog);
+  topics->setRange(0, 100000);
+  topics->setSpecialValueText("none (sample series only)");
+  topics->setValue(_load_options.topics);
+
+  auto fields = new QSpinBox(&dialog);
+  fields->setRange(1, 100000);
+  fields->setValue(_load_options.fields);
+
+  auto array_size = new QSpinBox(&dialog);
+  array_size->setRange(0, 1000000);
+  array_size->setSpecialValueText("no array");
+  array_size->setValue(_load_options.array_size);
+
+  auto string_field = new QCheckBox("add a string field", &dialog);
+  string_field->setChecked(_load_options.string_field);
+
+  auto rate = new QDoubleSpinBox(&dialog);
+  rate->setRange(0, 1e6);
+  rate->setDecimals(1);
+  rate->setSuffix(" Hz");
+  rate->setSpecialValueText("as fast as possible");
+  rate->setValue(_load_options.rate);
+
+  auto burst = new QSpinBox(&dialog);
+  burst->setRange(1, 100000);
+  burst->setValue(_load_options.burst);
+  burst->setToolTip("Messages of each topic generated back to back");
+
+  auto out_of_order = new QDoubleSpinBox(&dialog);
+  out_of_order->setRange(0, 100);
+  out_of_order->setSuffix(" %");
+  out_of_order->setValue(_load_options.out_of_order * 100);
+  out_of_order->setToolTip("Messages with a timestamp older than the previous one");
+
+  auto encoding = new QComboBox(&dialog);
+  encoding->addItem("none (write the samples directly)");
+  for (const auto& name : LoadEncoder::supportedEncodings())
+  {
+    const QString qname = QString::fromStdString(name);
+    if (parserFactories() && parserFactories()->count(qname) != 0)
+    {
+      encoding->addItem(qname);
+    }
+  }
+  const int encoding_index = encoding->findText(QString::fromStdString(_load_options.encoding));
+  encoding->setCurrentIndex(std::max(encoding_index, 0));
+
+  auto form = new QFormLayout();
+  form->addRow("Generator threads:", threads);
+  form->addRow("Topics:", topics);
+  form->addRow("Numeric fields per topic:", fields);
+  form->addRow("Array size:", array_size);
+  form->addRow("", string_field);
+  form->addRow("Rate per topic:", rate);
+  form->addRow("Burst size:", burst);
+  form->addRow("Out of order:", out_of_order);
+  form->addRow("Serialize and parse as:", encoding);
+
+  auto button_box = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+  connect(button_box, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+  connect(button_box, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+  auto layout = new QVBoxLayout(&dialog);
+  layout->addLayout(form);
+  layout->addWidget(button_box);
+
+  if (dialog.exec() != QDialog::Accepted)
+  {
+    return false;
+  }
+
+  _load_options.threads = threads->value();
+  _load_options.topics = topics->value();
+  _load_options.fields = fields->value();
+  _load_options.array_size = array_size->value();
+  _load_options.string_field = string_field->isChecked();
+  _load_options.rate = rate->value();
+  _load_options.burst = burst->value();
+  _load_options.out_of_order = out_of_order->value() / 100.0;
+  _load_options.encoding =
+      (encoding->currentIndex() == 0) ? std::string() : encoding->currentText().toStdString();
+  SaveLoadOptionsToSettings(_load_options);
+  return true;
+}
+
+bool DataStreamSample::createLoadTopics()
+{
+  _load_topics.clear();
+  const auto& options = _load_options;
+
+  ParserFactoryPtr factory;
+  LoadEncoder::Ptr encoder;
+  if (!options.encoding.empty())
+  {
+    const QString encoding = QString::fromStdString(options.encoding);
+    encoder = CreateLoadEncoder(options.encoding, options);
+    if (!parserFactories() || parserFactories()->count(encoding) == 0 || !encoder)
+    {
+      QMessageBox::warning(nullptr, "Dummy Streamer",
+                           QString("No parser available for encoding [%1]").arg(encoding));
+      return false;
+    }
+    factory = parserFactories()->at(encoding);
+  }
+
+  // the same parameters at each run
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+  for (int t = 0; t < options.topics; t++)
+  {
+    LoadTopic topic;
+    topic.name = "load/topic_" + std::to_string(t);
+    for (int i = 0; i < options.fields; i++)
+    {
+      topic.parameters.push_back(
+          { 6 * unit(generator) - 3, 3 * unit(generator), 3 * unit(generator),
+            20 * unit(generator) });
+    }
+
+    if (encoder)
+    {
+      MessageSchema schema;
+      schema.encoding = options.encoding;
+      schema.name = encoder->typeName();
+      schema.definition = encoder->schema();
+      try
+      {
+        topic.parser = createParser(*factory, topic.name, schema);
+      }
+      catch (std::exception& err)
+      {
+        QMessageBox::warning(nullptr, "Dummy Streamer",
+                             QString("Can't create the parser: %1").arg(err.what()));
+        _load_topics.clear();
+        return false;
+      }
+    }
+    else
+    {
+      for (int i = 0; i < options.fields; i++)
+      {
+        topic.fields.push_back(dataMap().registerSeries(topic.name + "/field_" +
+                                                        std::to_string(i)));
+      }
+      if (options.string_field)
+      {
+        topic.label = dataMap().registerStringSeries(topic.name + "/label");
+      }
+      for (int i = 0; i < options.array_size; i++)
+      {
+        topic.array.push_back(
+            dataMap().registerSeries(topic.name + "/array[" + std::to_string(i) + "]"));
+      }
+      topic.metrics = metrics().topic(topic.name);
+    }
+    _load_topics.push_back(std::move(topic));
+  }
   return true;
 }
 
+QString DataStreamSample::loadStatistics() const
+{
+  using namespace std::chrono;
+  const double elapsed =
+      std::max(duration<double>(steady_clock::now() - _load_start).count(), 1e-9);
+  QString text = QString("Synthetic load, %1 topics on %2 threads:\n"
+                         "%3 messages/s, %4 samples/s")
+                     .arg(_load_topics.size())
+                     .arg(_load_threads.size())
+                     .arg(double(_load_messages) / elapsed, 0, 'f', 0)
+                     .arg(double(_load_samples) / elapsed, 0, 'f', 0);
+  if (_load_options.rate > 0)
+  {
+    text += QString(" (requested: %1 messages/s)")
+                .arg(_load_options.rate * _load_topics.size(), 0, 'f', 0);
+  }
+  return text;
+}
+
 void DataStreamSample::pushSingleCycle()
 {
   static int count = 0;
-  std::lock_guard<std::mutex> lock(mutex());
+  auto lock = lockMutex();
 
   using namespace std::chrono;
   static auto initial_time = high_resolution_clock::now();
@@ -120,6 +422,7 @@ void DataStreamSample::pushSingleCycle()
   auto& tc_red = dataMap().numeric.find("tc/red")->second;
   tc_red.pushBack({ stamp, double(count) });
 
+  publishData();
   count++;
 }
 
@@ -140,3 +443,137 @@ void DataStreamSample::loop()
     std::this_thread::sleep_until(prev + std::chrono::milliseconds(20));  // 50 Hz
   }
 }
+
+void DataStreamSample::loadLoop(int thread_index)
+{
+  using namespace std::chrono;
+  const auto& options = _load_options;
+  // _load_threads is still being filled by start()
+  const size_t threads = std::min<size_t>(options.threads, _load_topics.size());
+
+  std::vector<LoadTopic*> topics;
+  for (size_t i = thread_index; i < _load_topics.size(); i += threads)
+  {
+    topics.push_back(&_load_topics[i]);
+  }
+
+  // each thread has its own encoder and random generator: the sequence is reproducible
+  auto encoder = CreateLoadEncoder(options.encoding, options);
+  std::mt19937 generator(thread_index + 1);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+  // the messages of a burst are serialized before locking the mutex
+  struct Pending
+  {
+    LoadTopic* topic;
+    double time;
+    LoadSample sample;
+    std::vector<uint8_t> buffer;
+  };
+  std::vector<Pending> pending(topics.size() * options.burst);
+
+  // time between the timestamps of two messages of the same topic
+  const double spacing = options.rate > 0 ? 1.0 / options.rate : 0.0;
+  const auto burst_period = duration_cast<steady_clock::duration>(
+      duration<double>(spacing * options.burst));
+  const size_t samples_per_message =
+      options.fields + options.array_size + (options.string_field ? 1 : 0);
+
+  auto next_burst = steady_clock::now();
+  uint64_t count = 0;
+
+  while (_running)
+  {
+    const double now = duration<double>(system_clock::now().time_since_epoch()).count();
+    size_t index = 0;
+    for (int b = 0; b < options.burst; b++, count++)
+    {
+      // the timestamps of a burst are evenly spaced, the last one is "now"
+      const double stamp = now - (options.burst - 1 - b) * spacing;
+      for (auto topic : topics)
+      {
+        auto& message = pending[index++];
+        message.topic = topic;
+        message.time = stamp;
+        if (options.out_of_order > 0 && unit(generator) < options.out_of_order)
+        {
+          message.time -= unit(generator) * OUT_OF_ORDER_MAX_DELAY;
+        }
+        auto& sample = message.sample;
+        sample.fields.resize(options.fields);
+        for (int i = 0; i < options.fields; i++)
+        {
+          const auto& param = topic->parameters[i];
+          sample.fields[i] = param.A * sin(param.B * message.time + param.C) + param.D;
+        }
+        sample.label = options.string_field ? LABELS[(count / 10) % 3] : "";
+        sample.array.resize(options.array_size);
+        for (int i = 0; i < options.array_size; i++)
+        {
+          sample.array[i] = sin(message.time + 0.1 * i);
+        }
+        if (encoder)
+        {
+          encoder->encode(sample, message.buffer);
+        }
+      }
+    }
+
+    {
+      auto lock = lockMutex();
+      for (auto& message : pending)
+      {
+        auto topic = message.topic;
+        if (topic->parser)
+        {
+          double timestamp = message.time;
+          try
+          {
+            parseMessageWithMetrics(*topic->parser, MessageRef(message.buffer), timestamp);
+          }
+          catch (std::exception&)
+          {
+          }
+          continue;
+        }
+        const auto start_time = steady_clock::now();
+        const auto& sample = message.sample;
+        for (size_t i = 0; i < topic->fields.size(); i++)
+        {
+          if (auto series = dataMap().series(topic->fields[i]))
+          {
+            series->pushBack({ message.time, sample.fields[i] });
+          }
+        }
+        if (auto series = dataMap().stringSeries(topic->label))
+        {
+          series->pushBack({ message.time, sample.label });
+        }
+        for (size_t i = 0; i < topic->array.size(); i++)
+        {
+          if (auto series = dataMap().series(topic->array[i]))
+          {
+            series->pushBack({ message.time, sample.array[i] });
+          }
+        }
+        topic->metrics->recordMessage(samples_per_message * sizeof(double),
+                                      duration_cast<nanoseconds>(steady_clock::now() - start_time));
+      }
+      publishData();
+    }
+    _load_messages += pending.size();
+    _load_samples += pending.size() * samples_per_message;
+    emit dataReceived();
+
+    if (options.rate > 0)
+    {
+      next_burst += burst_period;
+      const auto current_time = steady_clock::now();
+      if (current_time - next_burst > MAX_LATENESS)
+      {
+        next_burst = current_time;
+      }
+      std::this_thread::sleep_until(next_burst);
+    }
+  }
+}
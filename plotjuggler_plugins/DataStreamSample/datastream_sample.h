@@ -1,8 +1,12 @@
 #pragma once
 
 #include <QtPlugin>
+#include <atomic>
+#include <chrono>
 #include <thread>
+#include <vector>
 #include "PlotJuggler/datastreamer_base.h"
+#include "load_generator.h"
 
 class DataStreamSample : public PJ::DataStreamer
 {
@@ -46,11 +50,35 @@ private:
     double A, B, C, D;
   };
 
+  // a topic of the synthetic load
+  struct LoadTopic
+  {
+    std::string name;
+    std::vector<Parameters> parameters;
+    // used when the samples are serialized
+    PJ::MessageParserPtr parser;
+    // used when the samples are written directly
+    std::vector<PJ::SeriesId> fields;
+    PJ::SeriesId label;
+    std::vector<PJ::SeriesId> array;
+    PJ::TopicMetrics::Ptr metrics;
+  };
+
   void loop();
 
+  // generate the topics of the synthetic load with index % threads == thread_index
+  void loadLoop(int thread_index);
+
+  // show the dialog to edit _load_options. Returns false if canceled
+  bool editLoadOptions();
+
+  bool createLoadTopics();
+
+  QString loadStatistics() const;
+
   std::thread _thread;
 
-  bool _running;
+  std::atomic_bool _running = false;
 
   std::map<std::string, Parameters> _parameters;
 
@@ -59,4 +87,11 @@ private:
   QAction* _dummy_notification;
 
   int _notifications_count;
+
+  LoadOptions _load_options;
+  std::vector<LoadTopic> _load_topics;
+  std::vector<std::thread> _load_threads;
+  std::chrono::steady_clock::time_point _load_start;
+  std::atomic<uint64_t> _load_messages = 0;
+  std::atomic<uint64_t> _load_samples = 0;
 };
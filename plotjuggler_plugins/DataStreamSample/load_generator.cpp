@@ -0,0 +1,318 @@
+#include "load_generator.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+std::string FieldName(int index)
+{
+  return "field_" + std::to_string(index);
+}
+
+//------------------------------------------------------------
+// {"field_0":1.5,...,"label":"RED","array":[0.1,0.2]}
+class JsonEncoder : public LoadEncoder
+{
+public:
+  std::string typeName() const override
+  {
+    return {};
+  }
+
+  std::string schema() const override
+  {
+    return {};
+  }
+
+  void encode(const LoadSample& sample, std::vector<uint8_t>& buffer) const override
+  {
+    _text.clear();
+    _text += '{';
+    for (size_t i = 0; i < sample.fields.size(); i++)
+    {
+      appendKey(FieldName(i));
+      appendNumber(sample.fields[i]);
+    }
+    if (!sample.label.empty())
+    {
+      appendKey("label");
+      _text += '"';
+      _text += sample.label;
+      _text += '"';
+    }
+    if (!sample.array.empty())
+    {
+      appendKey("array");
+      _text += '[';
+      for (size_t i = 0; i < sample.array.size(); i++)
+      {
+        if (i > 0)
+        {
+          _text += ',';
+        }
+        appendNumber(sample.array[i]);
+      }
+      _text += ']';
+    }
+    _text += '}';
+    buffer.assign(_text.begin(), _text.end());
+  }
+
+private:
+  void appendKey(const std::string& key) const
+  {
+    if (_text.size() > 1)
+    {
+      _text += ',';
+    }
+    _text += '"';
+    _text += key;
+    _text += "\":";
+  }
+
+  void appendNumber(double value) const
+  {
+    char number[32];
+    const int length = std::snprintf(number, sizeof(number), "%.9g", value);
+    _text.append(number, length);
+  }
+
+  // reused, to avoid an allocation per message
+  mutable std::string _text;
+};
+
+//------------------------------------------------------------
+// ROS2 message, serialized as little endian CDR
+class Ros2Encoder : public LoadEncoder
+{
+public:
+  explicit Ros2Encoder(const LoadOptions& options) : _options(options)
+  {
+  }
+
+  std::string typeName() const override
+  {
+    return "plotjuggler_msgs/LoadSample";
+  }
+
+  std::string schema() const override
+  {
+    std::string definition;
+    for (int i = 0; i < _options.fields; i++)
+    {
+      definition += "float64 " + FieldName(i) + "\n";
+    }
+    if (_options.string_field)
+    {
+      definition += "string label\n";
+    }
+    if (_options.array_size > 0)
+    {
+      definition += "float64[] array\n";
+    }
+    return definition;
+  }
+
+  void encode(const LoadSample& sample, std::vector<uint8_t>& buffer) const override
+  {
+    // encapsulation header: CDR, little endian
+    buffer.assign({ 0x00, 0x01, 0x00, 0x00 });
+    for (double value : sample.fields)
+    {
+      append(buffer, value);
+    }
+    if (_options.string_field)
+    {
+      append(buffer, uint32_t(sample.label.size() + 1));
+      buffer.insert(buffer.end(), sample.label.begin(), sample.label.end());
+      buffer.push_back(0);
+    }
+    if (_options.array_size > 0)
+    {
+      append(buffer, uint32_t(sample.array.size()));
+      for (double value : sample.array)
+      {
+        append(buffer, value);
+      }
+    }
+  }
+
+private:
+  // primitive types are aligned to their size, relative to the end of the header
+  template <typename T>
+  static void append(std::vector<uint8_t>& buffer, T value)
+  {
+    const size_t offset = buffer.size() - 4;
+    buffer.resize(buffer.size() + (sizeof(T) - offset % sizeof(T)) % sizeof(T), 0);
+    const size_t position = buffer.size();
+    buffer.resize(position + sizeof(T));
+    std::memcpy(buffer.data() + position, &value, sizeof(T));
+  }
+
+  LoadOptions _options;
+};
+
+//------------------------------------------------------------
+// Protobuf message (proto3). The schema is a serialized FileDescriptorSet
+class ProtobufEncoder : public LoadEncoder
+{
+public:
+  explicit ProtobufEncoder(const LoadOptions& options) : _options(options)
+  {
+  }
+
+  std::string typeName() const override
+  {
+    return "plotjuggler_msgs.LoadSample";
+  }
+
+  std::string schema() const override
+  {
+    enum
+    {
+      LABEL_OPTIONAL = 1,
+      LABEL_REPEATED = 3,
+      TYPE_DOUBLE = 1,
+      TYPE_STRING = 9
+    };
+    auto field = [](const std::string& name, int number, int label, int type) {
+      std::vector<uint8_t> proto;
+      appendBytes(proto, 1, name);
+      appendVarint(proto, 3, number);
+      appendVarint(proto, 4, label);
+      appendVarint(proto, 5, type);
+      return proto;
+    };
+
+    std::vector<uint8_t> message;
+    appendBytes(message, 1, std::string("LoadSample"));
+    for (int i = 0; i < _options.fields; i++)
+    {
+      appendBytes(message, 2, field(FieldName(i), i + 1, LABEL_OPTIONAL, TYPE_DOUBLE));
+    }
+    if (_options.string_field)
+    {
+      appendBytes(message, 2, field("label", labelNumber(), LABEL_OPTIONAL, TYPE_STRING));
+    }
+    if (_options.array_size > 0)
+    {
+      appendBytes(message, 2, field("array", arrayNumber(), LABEL_REPEATED, TYPE_DOUBLE));
+    }
+
+    std::vector<uint8_t> file;
+    appendBytes(file, 1, std::string("plotjuggler_msgs/load_sample.proto"));
+    appendBytes(file, 2, std::string("plotjuggler_msgs"));
+    appendBytes(file, 4, message);
+    appendBytes(file, 12, std::string("proto3"));
+
+    std::vector<uint8_t> file_set;
+    appendBytes(file_set, 1, file);
+    return std::string(file_set.begin(), file_set.end());
+  }
+
+  void encode(const LoadSample& sample, std::vector<uint8_t>& buffer) const override
+  {
+    buffer.clear();
+    for (size_t i = 0; i < sample.fields.size(); i++)
+    {
+      appendTag(buffer, i + 1, WIRE_FIXED64);
+      appendDouble(buffer, sample.fields[i]);
+    }
+    if (_options.string_field)
+    {
+      appendBytes(buffer, labelNumber(), sample.label);
+    }
+    if (!sample.array.empty())
+    {
+      // packed repeated field
+      appendTag(buffer, arrayNumber(), WIRE_LENGTH_DELIMITED);
+      appendRawVarint(buffer, sample.array.size() * sizeof(double));
+      for (double value : sample.array)
+      {
+        appendDouble(buffer, value);
+      }
+    }
+  }
+
+private:
+  enum WireType
+  {
+    WIRE_VARINT = 0,
+    WIRE_FIXED64 = 1,
+    WIRE_LENGTH_DELIMITED = 2
+  };
+
+  int labelNumber() const
+  {
+    return _options.fields + 1;
+  }
+
+  int arrayNumber() const
+  {
+    return _options.fields + 2;
+  }
+
+  static void appendRawVarint(std::vector<uint8_t>& buffer, uint64_t value)
+  {
+    while (value >= 0x80)
+    {
+      buffer.push_back(uint8_t(value | 0x80));
+      value >>= 7;
+    }
+    buffer.push_back(uint8_t(value));
+  }
+
+  static void appendTag(std::vector<uint8_t>& buffer, uint64_t number, WireType type)
+  {
+    appendRawVarint(buffer, (number << 3) | type);
+  }
+
+  static void appendVarint(std::vector<uint8_t>& buffer, uint64_t number, uint64_t value)
+  {
+    appendTag(buffer, number, WIRE_VARINT);
+    appendRawVarint(buffer, value);
+  }
+
+  template <typename Container>
+  static void appendBytes(std::vector<uint8_t>& buffer, uint64_t number, const Container& bytes)
+  {
+    appendTag(buffer, number, WIRE_LENGTH_DELIMITED);
+    appendRawVarint(buffer, bytes.size());
+    buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+  }
+
+  static void appendDouble(std::vector<uint8_t>& buffer, double value)
+  {
+    const size_t position = buffer.size();
+    buffer.resize(position + sizeof(double));
+    std::memcpy(buffer.data() + position, &value, sizeof(double));
+  }
+
+  LoadOptions _options;
+};
+
+}  // namespace
+
+const std::vector<std::string>& LoadEncoder::supportedEncodings()
+{
+  static const std::vector<std::string> encodings = { "json", "ros2msg", "protobuf" };
+  return encodings;
+}
+
+LoadEncoder::Ptr CreateLoadEncoder(const std::string& encoding, const LoadOptions& options)
+{
+  if (encoding == "json")
+  {
+    return std::make_unique<JsonEncoder>();
+  }
+  if (encoding == "ros2msg")
+  {
+    return std::make_unique<Ros2Encoder>(options);
+  }
+  if (encoding == "protobuf")
+  {
+    return std::make_unique<ProtobufEncoder>(options);
+  }
+  return nullptr;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Parameters of the synthetic load generated by DataStreamSample, in addition to its
+ * sample series. Each topic is a message with "fields" numeric values,
+ * an optional string and an optional array.
+ */
+struct LoadOptions
+{
+  /// Threads that generate the messages. The topics are divided among them.
+  int threads = 1;
+  /// 0 means that only the sample series are generated.
+  int topics = 0;
+  int fields = 10;
+  /// Elements of the array field. 0 means no array.
+  int array_size = 0;
+  bool string_field = true;
+  /// Messages per second, per topic. 0 means as fast as possible.
+  double rate = 100;
+  /// Messages of each topic generated back to back, every burst/rate seconds.
+  /// Their timestamps are evenly spaced.
+  int burst = 1;
+  /// Fraction [0, 1] of the messages with a timestamp older than the previous one.
+  double out_of_order = 0;
+  /// Encoding of the parser used to parse the messages (e.g. "json", "ros2msg" or "protobuf").
+  /// If empty, the samples are written directly into the series.
+  std::string encoding;
+};
+
+/// Values of a message of the synthetic load.
+struct LoadSample
+{
+  double timestamp = 0;
+  std::vector<double> fields;
+  std::string label;
+  std::vector<double> array;
+};
+
+/**
+ * Serialize the messages of the synthetic load with a given encoding,
+ * to be parsed by the corresponding ParserFactoryPlugin.
+ */
+class LoadEncoder
+{
+public:
+  using Ptr = std::unique_ptr<LoadEncoder>;
+
+  virtual ~LoadEncoder() = default;
+
+  /// Name of the type, as passed to ParserFactoryPlugin::createParser().
+  virtual std::string typeName() const = 0;
+
+  /// Definition of the type, as passed to ParserFactoryPlugin::createParser().
+  virtual std::string schema() const = 0;
+
+  /// Serialize the sample into "buffer", replacing its content.
+  virtual void encode(const LoadSample& sample, std::vector<uint8_t>& buffer) const = 0;
+
+  /// Encodings supported by CreateLoadEncoder().
+  static const std::vector<std::string>& supportedEncodings();
+};
+
+/// Returns nullptr if the encoding is not supported.
+LoadEncoder::Ptr CreateLoadEncoder(const std::string& encoding, const LoadOptions& options);
@@ -507,7 +507,7 @@ bool DatastreamSerialPort::start(QStringList*)
     _splitter = std::make_unique<JSONSplitter>();
   }
 
-  _parser = parser_creator->createParser({}, {}, {}, dataMap());
+  _parser = createParser(*parser_creator, {});
 
   Q_ASSERT(!_serialPort);
   _serialPort = new QSerialPort(this);
@@ -567,6 +567,7 @@ void DatastreamSerialPort::processMessage()
     double timestamp = 1e-6 * double(duration_cast<microseconds>(ts).count());
 
     auto msgList = _splitter->process(_serialPort->read(kChunkSize));
+    metrics().setPendingBytes(static_cast<size_t>(_serialPort->bytesAvailable()));
     if (msgList.count() == 0)
     {
       return;
@@ -574,13 +575,13 @@ void DatastreamSerialPort::processMessage()
 
     int errors_before = _failed_parsing;
     {
-      std::lock_guard<std::mutex> lock(mutex());
+      auto lock = lockMutex();
       for (const auto& data : msgList)
       {
         MessageRef msg(reinterpret_cast<const uint8_t*>(data.data()), data.count());
         try
         {
-          _parser->parseMessage(msg, timestamp);
+          parseMessageWithMetrics(*_parser, msg, timestamp);
         }
         catch (std::exception& err)
         {
@@ -333,6 +333,7 @@ void UDP_Server::processMessage()
       if (size < header_end)
       {
         // Packet too short for the declared discriminator; drop.
+        metrics().topic({})->recordDropped();
         continue;
       }
       uint64_t id =
@@ -348,14 +349,14 @@ void UDP_Server::processMessage()
 
     try
     {
-      std::lock_guard<std::mutex> lock(mutex());
+      auto lock = lockMutex();
       // important use the mutex to protect any access to the data
       auto it = _parsers.find(topic);
       if (it == _parsers.end())
       {
-        it = _parsers.emplace(topic, _parser_creator->createParser(topic, {}, {}, dataMap())).first;
+        it = _parsers.emplace(topic, createParser(*_parser_creator, topic)).first;
       }
-      it->second->parseMessage(msg, timestamp);
+      parseMessageWithMetrics(*it->second, msg, timestamp);
     }
     catch (std::exception& err)
     {
@@ -136,7 +136,7 @@ bool WebsocketServer::start(QStringList*)
   protocol = dialog->ui->comboBoxProtocol->currentText();
   dialog->deleteLater();
 
-  _parser = parser_creator->createParser({}, {}, {}, dataMap());
+  _parser = createParser(*parser_creator, {});
 
   // save back to service
   settings.setValue("WebsocketServer::protocol", protocol);
@@ -177,7 +177,7 @@ void WebsocketServer::onNewConnection()
 
 void WebsocketServer::processMessage(QString message)
 {
-  std::lock_guard<std::mutex> lock(mutex());
+  auto lock = lockMutex();
 
   using namespace std::chrono;
   auto ts = high_resolution_clock::now().time_since_epoch();
@@ -188,7 +188,7 @@ void WebsocketServer::processMessage(QString message)
 
   try
   {
-    _parser->parseMessage(msg, timestamp);
+    parseMessageWithMetrics(*_parser, msg, timestamp);
   }
   catch (std::exception& err)
   {
@@ -152,7 +152,7 @@ bool DataStreamZMQ::start(QStringList*)
   topics = dialog->ui->lineEditTopics->text();
   _is_connect = dialog->ui->radioConnect->isChecked();
 
-  _parser = _parser_creator->createParser({}, {}, {}, dataMap());
+  _parser = createParser(*_parser_creator, {});
 
   // save back to service
   settings.setValue("ZMQ_Subscriber::address", address);
@@ -188,7 +188,7 @@ bool DataStreamZMQ::start(QStringList*)
   // Add a parser for each topic
   for (const auto& topic : _topic_filters)
   {
-    _parsers[topic] = _parser_creator->createParser(topic, {}, {}, dataMap());
+    _parsers[topic] = createParser(*_parser_creator, topic);
   }
 
   _zmq_socket.set(zmq::sockopt::rcvtimeo, 100);
@@ -196,6 +196,8 @@ bool DataStreamZMQ::start(QStringList*)
   qDebug() << "ZMQ listening on address" << QString::fromStdString(_socket_address);
   _running = true;
 
+  // the GUI takes the data without locking mutex(), that is used only by this plugin
+  setDoubleBuffering(true);
   _receive_thread = std::thread(&DataStreamZMQ::receiveLoop, this);
 
   dialog->deleteLater();
@@ -233,9 +235,11 @@ void DataStreamZMQ::receiveLoop()
     zmq::message_t recv_msg;
     zmq::recv_result_t result = _zmq_socket.recv(recv_msg);
 
-    // If we did not receive anything, continue
+    // If we did not receive anything, hand over the samples that were still pending
+    // because the GUI was busy, and continue
     if (recv_msg.size() <= 0)
     {
+      publishPendingData();
       continue;
     }
 
@@ -308,12 +312,26 @@ void DataStreamZMQ::receiveLoop()
   }
 }
 
+void DataStreamZMQ::publishPendingData()
+{
+  bool published = false;
+  {
+    auto lock = lockMutex();
+    published = hasPendingData() && publishData();
+  }
+  if (published)
+  {
+    emit this->dataReceived();
+  }
+}
+
 bool DataStreamZMQ::parseMessage(const PJ::MessageRef& msg, double& timestamp)
 {
   try
   {
-    std::lock_guard<std::mutex> lock(mutex());
-    _parser->parseMessage(msg, timestamp);
+    auto lock = lockMutex();
+    parseMessageWithMetrics(*_parser, msg, timestamp);
+    publishData();
     return true;
   }
   catch (...)
@@ -340,7 +358,7 @@ PJ::MessageParserPtr DataStreamZMQ::ensureTopicParser(const std::string& topic)
     auto it = _parsers.find(topic);
     if (it == _parsers.end())
     {
-      it = _parsers.emplace(topic, _parser_creator->createParser(topic, {}, {}, dataMap())).first;
+      it = _parsers.emplace(topic, createParser(*_parser_creator, topic)).first;
     }
     parser = it->second;
   };
@@ -363,8 +381,9 @@ bool DataStreamZMQ::parseMessage(const std::string& topic, const PJ::MessageRef&
   try
   {
     auto parser = ensureTopicParser(topic);
-    std::lock_guard<std::mutex> lock(mutex());
-    parser->parseMessage(msg, timestamp);
+    auto lock = lockMutex();
+    parseMessageWithMetrics(*parser, msg, timestamp);
+    publishData();
     return true;
   }
   catch (...)
@@ -5,6 +5,23 @@
 
 namespace gp = google::protobuf;
 
+static bool IsNumeric(const gp::FieldDescriptor* field)
+{
+  switch (field->cpp_type())
+  {
+    case gp::FieldDescriptor::CPPTYPE_DOUBLE:
+    case gp::FieldDescriptor::CPPTYPE_FLOAT:
+    case gp::FieldDescriptor::CPPTYPE_UINT32:
+    case gp::FieldDescriptor::CPPTYPE_UINT64:
+    case gp::FieldDescriptor::CPPTYPE_BOOL:
+    case gp::FieldDescriptor::CPPTYPE_INT32:
+    case gp::FieldDescriptor::CPPTYPE_INT64:
+      return true;
+    default:
+      return false;
+  }
+}
+
 ProtobufParser::ProtobufParser(const std::string& topic_name, const std::string type_name,
                                const gp::FileDescriptorSet& descriptor_set, PlotDataMapRef& data)
   : MessageParser(topic_name, data), _proto_pool(&_proto_database)
@@ -111,7 +128,14 @@ bool ProtobufParser::parseMessage(const MessageRef serialized_msg, double& times
         repeated = true;
       }
 
-      if (repeated && count > maxArraySize())
+      // a large array of numbers is stored as a single ArraySeries, instead of being skipped
+      const bool as_array =
+          repeated && count > maxArraySize() && !clampLargeArray() && IsNumeric(field);
+      if (as_array)
+      {
+        _array_values.clear();
+      }
+      else if (repeated && count > maxArraySize())
       {
         if (clampLargeArray())
         {
@@ -125,7 +149,7 @@ bool ProtobufParser::parseMessage(const MessageRef serialized_msg, double& times
 
       for (unsigned index = 0; index < count; index++)
       {
-        if (repeated)
+        if (repeated && !as_array)
         {
           suffix = fmt::format("[{}]", index);
         }
@@ -179,8 +203,7 @@ bool ProtobufParser::parseMessage(const MessageRef serialized_msg, double& times
             auto tmp = !repeated ? reflection->GetEnum(msg, field) :
                                    reflection->GetRepeatedEnum(msg, field, index);
 
-            auto& series = this->getStringSeries(key + suffix);
-            series.pushBack({ timestamp, std::string(tmp->name()) });
+            pushString(key + suffix, timestamp, std::string(tmp->name()));
             is_double = false;
           }
           break;
@@ -193,8 +216,7 @@ bool ProtobufParser::parseMessage(const MessageRef serialized_msg, double& times
               // probably a blob, skip it
               continue;
             }
-            auto& series = this->getStringSeries(key + suffix);
-            series.pushBack({ timestamp, tmp });
+            pushString(key + suffix, timestamp, tmp);
             is_double = false;
           }
           break;
@@ -244,10 +266,26 @@ bool ProtobufParser::parseMessage(const MessageRef serialized_msg, double& times
           break;
         }
 
-        if (is_double)
+        if (is_double && as_array)
         {
-          auto& series = this->getSeries(key + suffix);
-          series.pushBack({ timestamp, value });
+          _array_values.push_back(value);
+        }
+        else if (is_double)
+        {
+          const std::string name = key + suffix;
+          auto& series = this->getSeries(name);
+          if (isFieldRequested(name))
+          {
+            series.pushBack({ timestamp, value });
+          }
+        }
+      }
+      if (as_array)
+      {
+        auto& series = this->getArraySeries(key);
+        if (isFieldRequested(key))
+        {
+          series.pushBack(timestamp, Span<const double>(_array_values));
         }
       }
     }
@@ -259,3 +297,12 @@ bool ProtobufParser::parseMessage(const MessageRef serialized_msg, double& times
   delete mutable_msg;
   return true;
 }
+
+void ProtobufParser::pushString(const std::string& name, double timestamp, const std::string& value)
+{
+  auto& series = this->getStringSeries(name);
+  if (isFieldRequested(name))
+  {
+    series.pushBack({ timestamp, value });
+  }
+}
@@ -28,7 +28,15 @@ public:
 
   bool parseMessage(const MessageRef serialized_msg, double& timestamp) override;
 
+  bool supportsLazyFields() const override
+  {
+    return true;
+  }
+
 protected:
+  // the series are created also when not requested (see isFieldRequested()), to be listed
+  void pushString(const std::string& name, double timestamp, const std::string& value);
+
   google::protobuf::SimpleDescriptorDatabase _proto_database;
   google::protobuf::DescriptorPool _proto_pool;
 
@@ -37,4 +45,7 @@ protected:
 
   bool _first_message = true;
   std::optional<size_t> _timestamp_field_index;
+
+  // values of the large array being parsed
+  std::vector<double> _array_values;
 };
@@ -3,6 +3,7 @@
 #include "fmt/core.h"
 #include <queue>
 #include <algorithm>
+#include <cstring>
 #include <unordered_map>
 #include <tuple>
 #include <vector>
@@ -17,6 +18,42 @@ constexpr double RAD_TO_DEG = 180.0 / M_PI;
 
 static std::unordered_map<uint64_t, DataTamerParser::Schema> _global_data_tamer_schemas;
 
+static bool SameKeySuffix(const KeySuffix& a, const KeySuffix& b)
+{
+  return a.len == b.len && std::memcmp(a.data, b.data, a.len) == 0;
+}
+
+// true if the two leaves have the same name
+static bool SameLeaf(const FieldLeaf& a, const FieldLeaf& b)
+{
+  if (a.node != b.node || a.index_array != b.index_array ||
+      a.index_depth_array != b.index_depth_array || !SameKeySuffix(a.key_suffix, b.key_suffix) ||
+      a.key_suffixes.size() != b.key_suffixes.size())
+  {
+    return false;
+  }
+  for (size_t i = 0; i < a.key_suffixes.size(); i++)
+  {
+    if (a.key_suffixes[i].depth != b.key_suffixes[i].depth ||
+        !SameKeySuffix(a.key_suffixes[i].suffix, b.key_suffixes[i].suffix))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static std::runtime_error TruncationError(const RangeException& ex)
+{
+  std::string msg = std::string(ex.what());
+  if (msg == "Floating point truncated")
+  {
+    msg += ".\n\nYou can disable this check in:\n"
+           "App -> Preferences... -> Behavior -> Parsing";
+  }
+  return std::runtime_error(msg);
+}
+
 ParserROS::ParserROS(const std::string& topic_name, const std::string& type_name,
                      const std::string& schema, RosMsgParser::Deserializer* deserializer,
                      PlotDataMapRef& data, RosMsgParser::SchemaFormat schema_format)
@@ -28,6 +65,8 @@ ParserROS::ParserROS(const std::string& topic_name, const std::string& type_name
   auto policy = clampLargeArray() ? Parser::KEEP_LARGE_ARRAYS : Parser::DISCARD_LARGE_ARRAYS;
 
   _parser.setMaxArrayPolicy(policy, maxArraySize());
+  // discarded arrays are stored as ArraySeries instead, when parsed by parseValues()
+  _parser.setWholeLargeArrays(true);
 
   const auto& root_fields = _parser.getSchema()->root_msg->fields();
   _has_header = !root_fields.empty() && root_fields.front().type().baseName() == "std_"
@@ -106,7 +145,8 @@ ParserROS::ParserROS(const std::string& topic_name, const std::string& type_name
 
 bool ParserROS::parseMessage(const PJ::MessageRef serialized_msg, double& timestamp)
 {
-  const auto serialized_span = Span<const uint8_t>(serialized_msg.data(), serialized_msg.size());
+  const auto serialized_span =
+      RosMsgParser::Span<const uint8_t>(serialized_msg.data(), serialized_msg.size());
 
   if (_customized_parser)
   {
@@ -115,7 +155,14 @@ bool ParserROS::parseMessage(const PJ::MessageRef serialized_msg, double& timest
     return true;
   }
 
+  if (parseValues(serialized_span, timestamp))
+  {
+    return true;
+  }
+
   _parser.deserialize(serialized_span, &_flat_msg, _deserializer.get());
+  updateLeafSeries();
+  _plan_leaves_valid = false;
 
   if (_has_header && this->useEmbeddedTimestamp())
   {
@@ -135,18 +182,41 @@ bool ParserROS::parseMessage(const PJ::MessageRef serialized_msg, double& timest
 
   std::string series_name;
 
-  for (const auto& [key, value] : _flat_msg.value)
+  for (size_t i = 0; i < _flat_msg.value.size(); i++)
   {
-    key.toStr(series_name);
+    const auto& [key, value] = _flat_msg.value[i];
+    auto& cached = _leaf_series[i];
+    const bool requested = isLeafRequested(cached, series_name);
 
+    // the series are created also when not requested, to be listed
     if (value.getTypeID() == RosMsgParser::BuiltinType::STRING)
     {
-      StringSeries& sdata = getStringSeries(series_name);
-      sdata.pushBack({ timestamp, value.extract<std::string>() });
+      StringSeries* sdata = _plot_data.stringSeries(cached.id);
+      if (!sdata)
+      {
+        key.toStr(series_name);
+        cached.id = registerStringSeries(series_name);
+        sdata = _plot_data.stringSeries(cached.id);
+      }
+      if (requested)
+      {
+        sdata->pushBack({ timestamp, value.extract<std::string>() });
+      }
       continue;
     }
 
-    PlotData& data = getSeries(series_name);
+    PlotData* series = _plot_data.series(cached.id);
+    if (!series)
+    {
+      key.toStr(series_name);
+      cached.id = registerSeries(series_name);
+      series = _plot_data.series(cached.id);
+    }
+    if (!requested)
+    {
+      continue;
+    }
+    PlotData& data = *series;
 
     if (!_strict_truncation_check)
     {
@@ -168,18 +238,131 @@ bool ParserROS::parseMessage(const PJ::MessageRef serialized_msg, double& timest
     }
     catch (RangeException& ex)
     {
-      std::string msg = std::string(ex.what());
-      if (msg == "Floating point truncated")
+      throw TruncationError(ex);
+    }
+  }
+  return true;
+}
+
+bool ParserROS::parseValues(const RosMsgParser::Span<const uint8_t>& serialized_span,
+                            double& timestamp)
+{
+  try
+  {
+    if (!_parser.deserializeValues(serialized_span, &_flat_values, _deserializer.get(),
+                                   _strict_truncation_check))
+    {
+      return false;
+    }
+  }
+  catch (RangeException& ex)
+  {
+    throw TruncationError(ex);
+  }
+
+  const auto& values = _flat_values.values;
+  const auto& strings = _flat_values.strings;
+
+  // the names of the leaves change only if the size of a sequence does
+  if (!_plan_leaves_valid || _plan_sequence_sizes != _flat_values.sequence_sizes ||
+      _leaf_series.size() != values.size())
+  {
+    _parser.deserialize(serialized_span, &_flat_msg, _deserializer.get());
+    if (_flat_msg.value.size() != values.size())
+    {
+      return false;
+    }
+    updateLeafSeries();
+    _plan_sequence_sizes = _flat_values.sequence_sizes;
+    _plan_leaves_valid = true;
+  }
+
+  if (_has_header && this->useEmbeddedTimestamp())
+  {
+    // ROS2: stamp.sec and stamp.nanosec. ROS1: seq and stamp, already in seconds
+    const double ts = _deserializer->isROS2() ? values[0] + 1e-9 * values[1] : values[1];
+    timestamp = (ts > 0) ? ts : timestamp;
+  }
+
+  std::string series_name;
+  size_t string_index = 0;
+
+  for (size_t i = 0; i < values.size(); i++)
+  {
+    auto& cached = _leaf_series[i];
+    const bool requested = isLeafRequested(cached, series_name);
+
+    if (string_index < strings.size() && strings[string_index].first == i)
+    {
+      StringSeries* sdata = _plot_data.stringSeries(cached.id);
+      if (!sdata)
+      {
+        cached.leaf.toStr(series_name);
+        cached.id = registerStringSeries(series_name);
+        sdata = _plot_data.stringSeries(cached.id);
+      }
+      if (requested)
       {
-        msg += ".\n\nYou can disable this check in:\n"
-               "App -> Preferences... -> Behavior -> Parsing";
+        sdata->pushBack({ timestamp, std::string(strings[string_index].second) });
       }
-      throw std::runtime_error(msg);
+      string_index++;
+      continue;
+    }
+
+    PlotData* series = _plot_data.series(cached.id);
+    if (!series)
+    {
+      cached.leaf.toStr(series_name);
+      cached.id = registerSeries(series_name);
+      series = _plot_data.series(cached.id);
+    }
+    if (requested)
+    {
+      series->pushBack({ timestamp, values[i] });
+    }
+  }
+
+  for (const auto& array : _flat_values.large_arrays)
+  {
+    series_name = _topic_name;
+    series_name += '/';
+    series_name.append(array.path.data(), array.path.size());
+    ArraySeries& array_series = getArraySeries(series_name);
+    if (isFieldRequested(series_name))
+    {
+      const double* first = _flat_values.array_values.data() + array.offset;
+      array_series.pushBack(timestamp, PJ::Span<const double>(first, array.size));
     }
   }
   return true;
 }
 
+bool ParserROS::isLeafRequested(LeafSeries& cached, std::string& series_name)
+{
+  const uint64_t generation = fieldDemandGeneration();
+  if (cached.demand_generation != generation)
+  {
+    cached.leaf.toStr(series_name);
+    cached.requested = isFieldRequested(series_name);
+    cached.demand_generation = generation;
+  }
+  return cached.requested;
+}
+
+void ParserROS::updateLeafSeries()
+{
+  _leaf_series.resize(_flat_msg.value.size());
+  for (size_t i = 0; i < _flat_msg.value.size(); i++)
+  {
+    const auto& key = _flat_msg.value[i].first;
+    auto& cached = _leaf_series[i];
+    if (!SameLeaf(cached.leaf, key))
+    {
+      cached = LeafSeries{ key };
+    }
+  }
+}
+
 void ParserROS::setLargeArraysPolicy(bool clamp, unsigned max_size)
 {
   auto policy =
@@ -217,12 +400,27 @@ void ParserROS::parseHeader(const std::string& prefix, double& timestamp)
 {
   const auto header = readHeader(timestamp);
 
-  getSeries(prefix + "/stamp/sec").pushBack({ timestamp, double(header.stamp.sec) });
-  getSeries(prefix + "/stamp/nanosec").pushBack({ timestamp, double(header.stamp.nanosec) });
-  getStringSeries(prefix + "/frame_id").pushBack({ timestamp, header.frame_id });
+  if (prefix != _header_prefix)
+  {
+    _header_prefix = prefix;
+    _header_series = {};
+  }
+  auto& ids = _header_series;
+  pushToSeries(ids[0], [&] { return prefix + "/stamp/sec"; }, timestamp, header.stamp.sec);
+  pushToSeries(ids[1], [&] { return prefix + "/stamp/nanosec"; }, timestamp,
+               header.stamp.nanosec);
+
+  StringSeries* frame_id = _plot_data.stringSeries(ids[2]);
+  if (!frame_id)
+  {
+    ids[2] = registerStringSeries(prefix + "/frame_id");
+    frame_id = _plot_data.stringSeries(ids[2]);
+  }
+  frame_id->pushBack({ timestamp, header.frame_id });
+
   if (dynamic_cast<ROS_Deserializer*>(_deserializer.get()) != nullptr)
   {
-    getSeries(prefix + "/seq").pushBack({ timestamp, double(header.seq) });
+    pushToSeries(ids[3], [&] { return prefix + "/seq"; }, timestamp, header.seq);
   }
 }
 
@@ -462,21 +660,26 @@ void ParserROS::parseJointStateMsg(const std::string& prefix, double& timestamp)
     }
   }
   //---------------------------
-  std::string series_name;
+  // the names of the joints rarely change: the series are resolved only when they do
+  if (msg.name != _joint_names)
+  {
+    _joint_names = msg.name;
+    _joint_series.assign(_joint_names.size(), {});
+  }
   for (size_t i = 0; i < std::min(name_size, pos_size); i++)
   {
-    series_name = fmt::format("{}/{}/position", _topic, msg.name[i]);
-    getSeries(series_name).pushBack({ timestamp, msg.position[i] });
+    auto name = [&] { return fmt::format("{}/{}/position", _topic, msg.name[i]); };
+    pushToSeries(_joint_series[i][0], name, timestamp, msg.position[i]);
   }
   for (size_t i = 0; i < std::min(name_size, vel_size); i++)
   {
-    series_name = fmt::format("{}/{}/velocity", _topic, msg.name[i]);
-    getSeries(series_name).pushBack({ timestamp, msg.velocity[i] });
+    auto name = [&] { return fmt::format("{}/{}/velocity", _topic, msg.name[i]); };
+    pushToSeries(_joint_series[i][1], name, timestamp, msg.velocity[i]);
   }
   for (size_t i = 0; i < std::min(name_size, eff_size); i++)
   {
-    series_name = fmt::format("{}/{}/effort", _topic, msg.name[i]);
-    getSeries(series_name).pushBack({ timestamp, msg.effort[i] });
+    auto name = [&] { return fmt::format("{}/{}/effort", _topic, msg.name[i]); };
+    pushToSeries(_joint_series[i][2], name, timestamp, msg.effort[i]);
   }
 }
 
@@ -489,22 +692,60 @@ void ParserROS::parseTF2Msg(const std::string& prefix, double& timestamp)
     return;
   }
 
+  // same series created by parseTransform()
+  static const std::array<const char*, 10> suffixes = {
+    "/translation/x", "/translation/y", "/translation/z", "/rotation/x",     "/rotation/y",
+    "/rotation/z",    "/rotation/w",    "/rotation/roll", "/rotation/pitch", "/rotation/yaw"
+  };
+
+  if (_tf_series.size() < transform_size)
+  {
+    _tf_series.resize(transform_size);
+  }
+  std::string child_frame_id;
+
   for (size_t i = 0; i < transform_size; i++)
   {
     const auto header = readHeader(timestamp);
-    std::string child_frame_id;
     _deserializer->deserializeString(child_frame_id);
 
-    std::string new_prefix;
-    if (header.frame_id.empty())
+    // the transforms are usually the same, in the same order, at each message
+    auto& cached = _tf_series[i];
+    if (cached.prefix.empty() || cached.frame_id != header.frame_id ||
+        cached.child_frame_id != child_frame_id)
     {
-      new_prefix = fmt::format("{}/{}", prefix, child_frame_id);
+      cached.frame_id = header.frame_id;
+      cached.child_frame_id = child_frame_id;
+      if (header.frame_id.empty())
+      {
+        cached.prefix = fmt::format("{}/{}", prefix, child_frame_id);
+      }
+      else
+      {
+        cached.prefix = fmt::format("{}/{}/{}", prefix, header.frame_id, child_frame_id);
+      }
+      cached.ids = {};
     }
-    else
+
+    std::array<double, 10> values;
+    PJ::Msg::Quaternion quat;
+    values[0] = _deserializer->deserialize(FLOAT64).convert<double>();
+    values[1] = _deserializer->deserialize(FLOAT64).convert<double>();
+    values[2] = _deserializer->deserialize(FLOAT64).convert<double>();
+    values[3] = quat.x = _deserializer->deserialize(FLOAT64).convert<double>();
+    values[4] = quat.y = _deserializer->deserialize(FLOAT64).convert<double>();
+    values[5] = quat.z = _deserializer->deserialize(FLOAT64).convert<double>();
+    values[6] = quat.w = _deserializer->deserialize(FLOAT64).convert<double>();
+    const auto rpy = Msg::QuaternionToRPY(quat);
+    values[7] = rpy.roll;
+    values[8] = rpy.pitch;
+    values[9] = rpy.yaw;
+
+    for (size_t v = 0; v < values.size(); v++)
     {
-      new_prefix = fmt::format("{}/{}/{}", prefix, header.frame_id, child_frame_id);
+      pushToSeries(
+          cached.ids[v], [&] { return cached.prefix + suffixes[v]; }, timestamp, values[v]);
     }
-    parseTransform(new_prefix, timestamp);
   }
 }
 
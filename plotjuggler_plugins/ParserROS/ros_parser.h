@@ -1,6 +1,7 @@
 #ifndef ROS_PARSER_H
 #define ROS_PARSER_H
 
+#include <limits>
 #include "fmt/core.h"
 #include "PlotJuggler/messageparser_base.h"
 #include "rosx_introspection/ros_parser.hpp"
@@ -17,6 +18,12 @@ public:
 
   void setLargeArraysPolicy(bool clamp, unsigned max_size) override;
 
+  // the customized parsers store all the fields
+  bool supportsLazyFields() const override
+  {
+    return !_customized_parser;
+  }
+
   void enableTruncationCheck(bool enable)
   {
     _strict_truncation_check = enable;
@@ -73,6 +80,58 @@ protected:
 
   std::function<void(const std::string& prefix, double&)> _customized_parser;
 
+  /// Parse the message with Parser::deserializeValues(). Returns false if the
+  /// schema or the encoding are not supported by it.
+  bool parseValues(const RosMsgParser::Span<const uint8_t>& serialized_span, double& timestamp);
+
+  /// Update _leaf_series with the leaves of _flat_msg.
+  void updateLeafSeries();
+
+  /// Push a value into the series "id". The name is built with make_name() and hashed
+  /// only if the handle is not valid yet or expired (the series was removed).
+  template <typename MakeName>
+  void pushToSeries(PJ::SeriesId& id, const MakeName& make_name, double timestamp, double value);
+
+  // Series of each leaf of _flat_msg, in the same order. The leaves are the same at each
+  // message, unless the size of an array (or a @key value) changes: only the entries of the
+  // leaves that changed are resolved by name again.
+  struct LeafSeries
+  {
+    RosMsgParser::FieldLeaf leaf;
+    PJ::SeriesId id;
+    // isFieldRequested(), at fieldDemandGeneration() == demand_generation
+    bool requested = true;
+    uint64_t demand_generation = std::numeric_limits<uint64_t>::max();
+  };
+  std::vector<LeafSeries> _leaf_series;
+
+  /// True if the samples of the leaf must be stored (see MessageParser::isFieldRequested()).
+  bool isLeafRequested(LeafSeries& cached, std::string& series_name);
+
+  // Output of Parser::deserializeValues(). _leaf_series is valid for it if the
+  // sizes of its sequences are the same of the message used to update _leaf_series.
+  RosMsgParser::FlatValues _flat_values;
+  std::vector<uint32_t> _plan_sequence_sizes;
+  bool _plan_leaves_valid = false;
+
+  // Series of the header, parsed by parseHeader()
+  std::string _header_prefix;
+  std::array<PJ::SeriesId, 4> _header_series;
+
+  // Series of position, velocity and effort, for each joint of the last JointState
+  std::vector<std::string> _joint_names;
+  std::vector<std::array<PJ::SeriesId, 3>> _joint_series;
+
+  // Series of each transform of the last TFMessage, valid while its frames are the same
+  struct TransformSeries
+  {
+    std::string frame_id;
+    std::string child_frame_id;
+    std::string prefix;
+    std::array<PJ::SeriesId, 10> ids;
+  };
+  std::vector<TransformSeries> _tf_series;
+
   bool _has_header = false;
   bool _strict_truncation_check = true;
 };
@@ -95,4 +154,17 @@ inline void ParserROS::parseCovariance(const std::string& prefix, double& timest
   }
 }
 
+template <typename MakeName>
+inline void ParserROS::pushToSeries(PJ::SeriesId& id, const MakeName& make_name,
+                                    double timestamp, double value)
+{
+  PJ::PlotData* series = _plot_data.series(id);
+  if (!series)
+  {
+    id = registerSeries(make_name());
+    series = _plot_data.series(id);
+  }
+  series->pushBack({ timestamp, value });
+}
+
 #endif  // ROS_PARSER_H
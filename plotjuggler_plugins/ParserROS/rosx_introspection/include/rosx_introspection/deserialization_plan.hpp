@@ -0,0 +1,109 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "rosx_introspection/ros_message.hpp"
+
+namespace RosMsgParser {
+
+/// Values of a message, written by Parser::deserializeValues().
+/// They are the leaves of FlatMessage::value, in the same order, without their names.
+struct FlatValues {
+  /// One value per leaf, converted to double. The strings have a NaN placeholder.
+  std::vector<double> values;
+
+  /// Index in "values" and content of each string leaf.
+  /// The content points into the deserialized buffer.
+  std::vector<std::pair<uint32_t, std::string_view>> strings;
+
+  /// Length of each stored sequence, in order of appearance. Two messages with the same
+  /// sequence sizes have the same leaves: the names can be taken once from a FlatMessage.
+  std::vector<uint32_t> sequence_sizes;
+
+  /// False if some arrays were discarded or truncated (see Parser::setMaxArrayPolicy()).
+  bool entire_message_parsed = true;
+
+  /// A numeric array larger than max_array_size, stored entirely (see
+  /// DeserializationPlan::Options::whole_large_arrays). It has no leaves in "values".
+  struct LargeArray {
+    /// Names of the fields from the root, separated by '/', e.g. "ranges".
+    std::string_view path;
+    /// First value in "array_values".
+    uint32_t offset = 0;
+    uint32_t size = 0;
+  };
+  std::vector<LargeArray> large_arrays;
+  std::vector<double> array_values;
+};
+
+/**
+ * @brief A schema compiled into a flat list of operations, such as "read 7 FLOAT64",
+ * "read a string" or "repeat these operations N times, N read from the buffer".
+ *
+ * Executing it doesn't walk the ROSMessage tree, doesn't call the virtual methods
+ * of Deserializer and doesn't create a Variant or a FieldLeaf per value: consecutive
+ * numbers of the same type are read in a single loop, directly as double.
+ *
+ * Schemas with @key, @optional, enum or union fields, or with multi-dimensional
+ * arrays, are not supported: use Parser::deserialize() for those.
+ */
+class DeserializationPlan {
+ public:
+  enum Encoding { ROS1, CDR };
+
+  struct Options {
+    size_t max_array_size = 100;
+    bool discard_large_arrays = true;
+    /// Throw RangeException if an INT64 or UINT64 can not be represented exactly as double.
+    bool check_truncation = true;
+    /// With discard_large_arrays: store the numeric arrays larger than max_array_size in
+    /// FlatValues::large_arrays, instead of discarding them. Only the arrays that are not
+    /// inside an array of structs; uint8 arrays are skipped as blobs anyway.
+    bool whole_large_arrays = false;
+  };
+
+  /// Returns nullptr if the schema is not supported.
+  static std::unique_ptr<DeserializationPlan> Compile(const MessageSchema& schema);
+
+  /**
+   * @brief Deserialize the buffer into "output", replacing its content.
+   *
+   * @return false if the buffer can't be deserialized by the plan (e.g. CDR encapsulations
+   *         other than plain CDR, or max_array_size == 0). The output is invalid in that case.
+   */
+  bool execute(Span<const uint8_t> buffer, Encoding encoding, const Options& options, FlatValues* output) const;
+
+  size_t operationsCount() const {
+    return _operations.size();
+  }
+
+ private:
+  struct Operation {
+    enum Code : uint8_t { VALUES, STRINGS, STRUCTS };
+    Code code = VALUES;
+    BuiltinType type = OTHER;
+    /// Number of elements, or -1 if the length is read from the buffer.
+    int32_t count = 1;
+    /// Arrays are subject to Options::max_array_size. Scalars (merged into
+    /// a single operation when consecutive and of the same type) are not.
+    bool is_array = false;
+    /// STRUCTS only: the body is [index + 1, end).
+    uint32_t end = 0;
+    /// VALUES arrays outside of arrays of structs: index in _array_paths.
+    int32_t array_path = -1;
+  };
+
+  class Compiler;
+
+  template <class Reader>
+  class Executor;
+
+  std::vector<Operation> _operations;
+  std::vector<std::string> _array_paths;
+};
+
+}  // namespace RosMsgParser
@@ -24,6 +24,7 @@
 
 #include <unordered_set>
 
+#include "rosx_introspection/deserialization_plan.hpp"
 #include "rosx_introspection/deserializer.hpp"
 #include "rosx_introspection/idl_parser.hpp"
 #include "rosx_introspection/message_writer.hpp"
@@ -80,6 +81,17 @@ class Parser {
     return _max_array_size;
   }
 
+  /// With DISCARD_LARGE_ARRAYS, deserializeValues() stores the large numeric arrays
+  /// entirely in FlatValues::large_arrays (see DeserializationPlan::Options::whole_large_arrays).
+  /// deserialize() still discards them. Default false.
+  void setWholeLargeArrays(bool enable) {
+    _whole_large_arrays = enable;
+  }
+
+  bool wholeLargeArrays() const {
+    return _whole_large_arrays;
+  }
+
   enum BlobPolicy { STORE_BLOB_AS_COPY, STORE_BLOB_AS_REFERENCE };
 
   // If set to STORE_BLOB_AS_COPY, a copy of the original vector will be stored in the
@@ -124,6 +136,24 @@ class Parser {
    */
   bool deserialize(Span<const uint8_t> buffer, FlatMessage* flat_output, Deserializer* deserializer) const;
 
+  /**
+   * @brief Faster alternative to deserialize(), that stores only the values of the leaves,
+   * converted to double (see FlatValues). The schema is compiled once into a
+   * DeserializationPlan, specialized for ROS_Deserializer and NanoCDR_Deserializer.
+   *
+   * @param buffer            raw memory to be parsed.
+   * @param output            output to store the result. Reuse it to avoid memory allocations.
+   * @param deserializer      used only to identify the encoding.
+   * @param check_truncation  throw RangeException, like Variant::convert<double>(), if an INT64
+   *                          or UINT64 can not be represented exactly.
+   *
+   * @return false if the schema, the deserializer or the encoding of this buffer are not
+   *         supported: use deserialize() instead.
+   */
+  bool deserializeValues(
+      Span<const uint8_t> buffer, FlatValues* output, const Deserializer* deserializer,
+      bool check_truncation = true) const;
+
   bool deserializeIntoJson(
       Span<const uint8_t> buffer, std::string* json_txt, Deserializer* deserializer, int indent = 0,
       bool ignore_constants = false) const;
@@ -191,11 +221,15 @@ class Parser {
   std::vector<int8_t> _substituted;
   MaxArrayPolicy _discard_large_array;
   size_t _max_array_size;
+  bool _whole_large_arrays = false;
   BlobPolicy _blob_policy;
   mutable size_t _estimated_field_count = 0;
   std::shared_ptr<ROSField> _dummy_root_field;
 
   std::unique_ptr<Deserializer> _deserializer;
+
+  // nullptr if the schema is not supported by DeserializationPlan
+  std::unique_ptr<DeserializationPlan> _plan;
 };
 
 //--------------------------------------------------------------------------
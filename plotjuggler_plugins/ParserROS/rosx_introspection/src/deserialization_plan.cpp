@@ -0,0 +1,432 @@
+#include "rosx_introspection/deserialization_plan.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "rosx_introspection/contrib/nanocdr.hpp"
+#include "rosx_introspection/details/conversion_impl.hpp"
+
+namespace RosMsgParser {
+
+namespace {
+
+constexpr int MAX_DEPTH = 32;
+
+template <typename T>
+inline T ByteSwap(T value) {
+  uint8_t bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  std::reverse(bytes, bytes + sizeof(T));
+  std::memcpy(&value, bytes, sizeof(T));
+  return value;
+}
+
+class ReaderBase {
+ public:
+  ReaderBase(const uint8_t* ptr, const uint8_t* end) : _ptr(ptr), _end(end) {}
+
+  size_t bytesLeft() const {
+    return static_cast<size_t>(_end - _ptr);
+  }
+
+  const uint8_t* take(size_t bytes) {
+    if (bytes > bytesLeft()) {
+      throw std::runtime_error("Buffer overrun in DeserializationPlan");
+    }
+    const uint8_t* out = _ptr;
+    _ptr += bytes;
+    return out;
+  }
+
+ protected:
+  const uint8_t* _ptr;
+  const uint8_t* _end;
+};
+
+// Same format of ROS_Deserializer: little endian, without padding
+class Ros1Reader : public ReaderBase {
+ public:
+  explicit Ros1Reader(Span<const uint8_t> buffer) : ReaderBase(buffer.data(), buffer.data() + buffer.size()) {}
+
+  void align(size_t) {}
+
+  bool swapBytes() const {
+    return false;
+  }
+
+  uint32_t readLength() {
+    uint32_t length = 0;
+    std::memcpy(&length, take(sizeof(length)), sizeof(length));
+    return length;
+  }
+
+  std::string_view readString() {
+    const uint32_t length = readLength();
+    return {reinterpret_cast<const char*>(take(length)), length};
+  }
+};
+
+// Same format of NanoCDR_Deserializer: plain CDR, values aligned to their size
+// relative to the end of the encapsulation header
+class CdrReader : public ReaderBase {
+ public:
+  CdrReader(Span<const uint8_t> buffer, bool swap_bytes)
+      : ReaderBase(buffer.data() + 4, buffer.data() + buffer.size()), _origin(buffer.data() + 4), _swap(swap_bytes) {}
+
+  void align(size_t size) {
+    const size_t offset = static_cast<size_t>(_ptr - _origin);
+    take((size - offset % size) & (size - 1));
+  }
+
+  bool swapBytes() const {
+    return _swap;
+  }
+
+  uint32_t readLength() {
+    align(sizeof(uint32_t));
+    uint32_t length = 0;
+    std::memcpy(&length, take(sizeof(length)), sizeof(length));
+    return _swap ? ByteSwap(length) : length;
+  }
+
+  std::string_view readString() {
+    const uint32_t length = readLength();
+    const char* data = reinterpret_cast<const char*>(take(length));
+    // the null terminator is serialized too
+    const size_t size = (length > 0 && data[length - 1] == '\0') ? length - 1 : length;
+    return {data, size};
+  }
+
+ private:
+  const uint8_t* _origin;
+  bool _swap;
+};
+
+}  // namespace
+
+//-----------------------------------------------------------------
+
+class DeserializationPlan::Compiler {
+ public:
+  Compiler(const RosMessageLibrary& library, std::vector<Operation>& operations, std::vector<std::string>& array_paths)
+      : _library(library), _operations(operations), _array_paths(array_paths) {}
+
+  // "prefix" is the path of msg, empty inside an array of structs
+  bool compile(const ROSMessage& msg, int depth, const std::string& prefix, bool in_array) {
+    if (depth > MAX_DEPTH) {
+      return false;
+    }
+    for (const ROSField& field : msg.fields()) {
+      if (field.isConstant()) {
+        continue;
+      }
+      if (field.isKey() || field.isOptional() || field.getEnum() != nullptr || field.getUnion() != nullptr ||
+          field.arrayDimensions().size() > 1) {
+        return false;
+      }
+      const ROSType& type = field.type();
+      Operation op;
+      op.count = field.isArray() ? field.arraySize() : 1;
+      op.is_array = field.isArray();
+
+      if (type.typeID() == STRING) {
+        op.code = Operation::STRINGS;
+        op.type = STRING;
+        push(op);
+      } else if (type.isBuiltin()) {
+        op.code = Operation::VALUES;
+        op.type = type.typeID();
+        if (op.is_array && !in_array) {
+          op.array_path = static_cast<int32_t>(_array_paths.size());
+          _array_paths.push_back(prefix + field.name());
+        }
+        // "read N values" instead of N operations: typical of Point, Quaternion, etc.
+        if (!op.is_array && _mergeable < _operations.size() && _operations[_mergeable].type == op.type) {
+          _operations[_mergeable].count++;
+          continue;
+        }
+        push(op);
+        if (!op.is_array) {
+          _mergeable = _operations.size() - 1;
+        }
+      } else {
+        auto child = field.getMessagePtr(_library);
+        if (!child) {
+          return false;
+        }
+        if (!op.is_array) {
+          // nested structs are flattened
+          if (!compile(*child, depth + 1, in_array ? prefix : prefix + field.name() + "/", in_array)) {
+            return false;
+          }
+          continue;
+        }
+        op.code = Operation::STRUCTS;
+        const size_t index = _operations.size();
+        push(op);
+        if (!compile(*child, depth + 1, {}, true)) {
+          return false;
+        }
+        _operations[index].end = static_cast<uint32_t>(_operations.size());
+        // the values after the array can not be merged with those in its body
+        _mergeable = NONE;
+      }
+    }
+    return true;
+  }
+
+ private:
+  static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+  void push(const Operation& op) {
+    _operations.push_back(op);
+    _mergeable = NONE;
+  }
+
+  const RosMessageLibrary& _library;
+  std::vector<Operation>& _operations;
+  std::vector<std::string>& _array_paths;
+  // index of the operation that can absorb the next scalar value, if of the same type
+  size_t _mergeable = NONE;
+};
+
+std::unique_ptr<DeserializationPlan> DeserializationPlan::Compile(const MessageSchema& schema) {
+  auto root_msg = schema.field_tree.croot()->value()->getMessagePtr(schema.msg_library);
+  if (!root_msg) {
+    return {};
+  }
+  std::unique_ptr<DeserializationPlan> plan(new DeserializationPlan());
+  Compiler compiler(schema.msg_library, plan->_operations, plan->_array_paths);
+  if (!compiler.compile(*root_msg, 0, {}, false)) {
+    return {};
+  }
+  return plan;
+}
+
+//-----------------------------------------------------------------
+
+template <class Reader>
+class DeserializationPlan::Executor {
+ public:
+  Executor(
+      const std::vector<Operation>& operations, const std::vector<std::string>& array_paths, Reader& reader,
+      const Options& options, FlatValues* output)
+      : _operations(operations), _array_paths(array_paths), _reader(reader), _options(options), _output(output) {}
+
+  // same rules of Parser::walkImpl(), in particular for the arrays larger than max_array_size
+  void run(size_t first, size_t last, bool store) {
+    size_t index = first;
+    while (index < last) {
+      const Operation& op = _operations[index];
+      size_t count = static_cast<size_t>(op.count);
+      if (op.count < 0) {
+        count = _reader.readLength();
+        if (store) {
+          _output->sequence_sizes.push_back(static_cast<uint32_t>(count));
+        }
+      }
+
+      size_t stored = store ? count : 0;
+      bool is_blob = false;
+      bool is_large_array = false;
+      if (op.is_array && count > _options.max_array_size) {
+        if (op.code == Operation::VALUES && builtinSize(op.type) == 1) {
+          is_blob = true;
+          stored = 0;
+        } else if (
+            _options.whole_large_arrays && _options.discard_large_arrays && op.array_path >= 0 &&
+            op.code == Operation::VALUES) {
+          is_large_array = true;
+        } else {
+          stored = _options.discard_large_arrays ? 0 : std::min(stored, _options.max_array_size);
+          _output->entire_message_parsed = false;
+        }
+      }
+
+      switch (op.code) {
+        case Operation::VALUES:
+          if (is_blob) {
+            _reader.take(count);
+          } else if (is_large_array) {
+            FlatValues::LargeArray array;
+            array.path = _array_paths[op.array_path];
+            array.offset = static_cast<uint32_t>(_output->array_values.size());
+            array.size = static_cast<uint32_t>(count);
+            readValues(op.type, count, count, _output->array_values);
+            _output->large_arrays.push_back(array);
+          } else {
+            readValues(op.type, count, stored, _output->values);
+          }
+          index++;
+          break;
+
+        case Operation::STRINGS:
+          for (size_t i = 0; i < count; i++) {
+            const std::string_view str = _reader.readString();
+            if (i < stored) {
+              _output->strings.push_back({static_cast<uint32_t>(_output->values.size()), str});
+              _output->values.push_back(std::numeric_limits<double>::quiet_NaN());
+            }
+          }
+          index++;
+          break;
+
+        case Operation::STRUCTS:
+          if (op.end > index + 1) {
+            for (size_t i = 0; i < count; i++) {
+              run(index + 1, op.end, i < stored);
+            }
+          }
+          index = op.end;
+          break;
+      }
+    }
+  }
+
+ private:
+  // the first "stored" values are appended to "out"
+  void readValues(BuiltinType type, size_t count, size_t stored, std::vector<double>& out) {
+    switch (type) {
+      case BOOL:
+      case BYTE:
+      case UINT8:
+        return readNumbers<uint8_t>(count, stored, out);
+      case CHAR:
+      case INT8:
+        return readNumbers<int8_t>(count, stored, out);
+      case UINT16:
+        return readNumbers<uint16_t>(count, stored, out);
+      case UINT32:
+        return readNumbers<uint32_t>(count, stored, out);
+      case UINT64:
+        return readNumbers<uint64_t>(count, stored, out);
+      case INT16:
+        return readNumbers<int16_t>(count, stored, out);
+      case INT32:
+        return readNumbers<int32_t>(count, stored, out);
+      case INT64:
+        return readNumbers<int64_t>(count, stored, out);
+      case FLOAT32:
+        return readNumbers<float>(count, stored, out);
+      case FLOAT64:
+        return readNumbers<double>(count, stored, out);
+      case TIME:
+      case DURATION:
+        return readTimes(count, stored, out);
+      default:
+        throw std::runtime_error("DeserializationPlan: type not recognized");
+    }
+  }
+
+  template <typename T>
+  void readNumbers(size_t count, size_t stored, std::vector<double>& out_values) {
+    if (count == 0) {
+      return;
+    }
+    _reader.align(sizeof(T));
+    if (count > _reader.bytesLeft() / sizeof(T)) {
+      throw std::runtime_error("Buffer overrun in DeserializationPlan");
+    }
+    const uint8_t* data = _reader.take(count * sizeof(T));
+    double* out = appendValues(out_values, stored);
+
+    if constexpr (std::is_same_v<T, double>) {
+      if (!_reader.swapBytes()) {
+        std::memcpy(out, data, stored * sizeof(double));
+        return;
+      }
+    }
+    for (size_t i = 0; i < stored; i++) {
+      T value;
+      std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+      if constexpr (sizeof(T) > 1) {
+        if (_reader.swapBytes()) {
+          value = ByteSwap(value);
+        }
+      }
+      out[i] = toDouble(value);
+    }
+  }
+
+  // two uint32: seconds and nanoseconds
+  void readTimes(size_t count, size_t stored, std::vector<double>& out_values) {
+    if (count == 0) {
+      return;
+    }
+    _reader.align(sizeof(uint32_t));
+    if (count > _reader.bytesLeft() / (2 * sizeof(uint32_t))) {
+      throw std::runtime_error("Buffer overrun in DeserializationPlan");
+    }
+    const uint8_t* data = _reader.take(count * 2 * sizeof(uint32_t));
+    double* out = appendValues(out_values, stored);
+    for (size_t i = 0; i < stored; i++) {
+      Time time;
+      std::memcpy(&time.sec, data + i * 8, sizeof(uint32_t));
+      std::memcpy(&time.nsec, data + i * 8 + 4, sizeof(uint32_t));
+      if (_reader.swapBytes()) {
+        time.sec = ByteSwap(time.sec);
+        time.nsec = ByteSwap(time.nsec);
+      }
+      out[i] = time.toSec();
+    }
+  }
+
+  template <typename T>
+  double toDouble(T value) const {
+    if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>) {
+      if (_options.check_truncation) {
+        double target = 0;
+        details::convert_impl<T, double>(value, target);
+        return target;
+      }
+    }
+    return static_cast<double>(value);
+  }
+
+  static double* appendValues(std::vector<double>& values, size_t count) {
+    const size_t offset = values.size();
+    values.resize(offset + count);
+    return values.data() + offset;
+  }
+
+  const std::vector<Operation>& _operations;
+  const std::vector<std::string>& _array_paths;
+  Reader& _reader;
+  const Options& _options;
+  FlatValues* _output;
+};
+
+bool DeserializationPlan::execute(
+    Span<const uint8_t> buffer, Encoding encoding, const Options& options, FlatValues* output) const {
+  if (options.max_array_size == 0) {
+    return false;
+  }
+  output->values.clear();
+  output->strings.clear();
+  output->sequence_sizes.clear();
+  output->large_arrays.clear();
+  output->array_values.clear();
+  output->entire_message_parsed = true;
+
+  if (encoding == ROS1) {
+    Ros1Reader reader(buffer);
+    Executor<Ros1Reader>(_operations, _array_paths, reader, options, output).run(0, _operations.size(), true);
+    return true;
+  }
+
+  // encapsulation header: {0, PLAIN_CDR | endianness, options}. Other encodings are
+  // left to NanoCDR_Deserializer.
+  if (buffer.size() < 4 || buffer[0] != 0 || (buffer[1] & ~0x1) != 0) {
+    return false;
+  }
+  const bool little_endian = (buffer[1] & 0x1) != 0;
+  const bool host_little_endian = nanocdr::getCurrentEndianness() == nanocdr::Endianness::CDR_LITTLE_ENDIAN;
+  CdrReader reader(buffer, little_endian != host_little_endian);
+  Executor<CdrReader>(_operations, _array_paths, reader, options, output).run(0, _operations.size(), true);
+  return true;
+}
+
+}  // namespace RosMsgParser
@@ -98,6 +98,7 @@ Parser::Parser(
     auto parsed_msgs = ParseMessageDefinitions(definition, msg_type);
     _schema = BuildMessageSchema(topic_name, parsed_msgs);
   }
+  _plan = DeserializationPlan::Compile(*_schema);
 }
 
 const std::shared_ptr<MessageSchema>& Parser::getSchema() const {
@@ -408,6 +409,27 @@ bool Parser::deserialize(Span<const uint8_t> buffer, FlatMessage* flat_container
   return walkSchema(buffer, deserializer, &writer);
 }
 
+bool Parser::deserializeValues(
+    Span<const uint8_t> buffer, FlatValues* output, const Deserializer* deserializer, bool check_truncation) const {
+  if (!_plan) {
+    return false;
+  }
+  DeserializationPlan::Encoding encoding;
+  if (dynamic_cast<const ROS_Deserializer*>(deserializer) != nullptr) {
+    encoding = DeserializationPlan::ROS1;
+  } else if (dynamic_cast<const NanoCDR_Deserializer*>(deserializer) != nullptr) {
+    encoding = DeserializationPlan::CDR;
+  } else {
+    return false;
+  }
+  DeserializationPlan::Options options;
+  options.max_array_size = _max_array_size;
+  options.discard_large_arrays = _discard_large_array;
+  options.check_truncation = check_truncation;
+  options.whole_large_arrays = _whole_large_arrays;
+  return _plan->execute(buffer, encoding, options, output);
+}
+
 //=============================================================================
 // JSON support
 //=============================================================================
@@ -0,0 +1,295 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "rosx_introspection/ros_parser.hpp"
+
+using namespace RosMsgParser;
+
+// DeserializationPlan must produce the same values of Parser::deserialize(),
+// in the same order.
+
+namespace {
+
+const char* ROS2_HEADER =
+    "================================================================================\n"
+    "MSG: std_msgs/Header\n"
+    "builtin_interfaces/Time stamp\n"
+    "string frame_id\n"
+    "================================================================================\n"
+    "MSG: builtin_interfaces/Time\n"
+    "int32 sec\n"
+    "uint32 nanosec\n";
+
+const char* ROS2_SCHEMA =
+    "std_msgs/Header header\n"
+    "geometry_msgs/Point[] points\n"
+    "float32[3] gains\n"
+    "uint8 mode\n"
+    "int16 offset\n"
+    "string[] names\n"
+    "uint8[] data\n"
+    "int64 counter\n"
+    "bool enabled\n"
+    "================================================================================\n"
+    "MSG: geometry_msgs/Point\n"
+    "float64 x\n"
+    "float64 y\n"
+    "float64 z\n";
+
+// Minimal encoder, with the alignment rules of CDR (or none, for ROS1)
+class Writer {
+ public:
+  Writer(bool cdr, bool little_endian = true) : _cdr(cdr), _swap(!little_endian) {
+    if (_cdr) {
+      _buffer = {0, uint8_t(little_endian ? 1 : 0), 0, 0};
+    }
+  }
+
+  template <typename T>
+  void put(T value) {
+    if (_cdr) {
+      const size_t offset = _buffer.size() - 4;
+      _buffer.resize(_buffer.size() + (sizeof(T) - offset % sizeof(T)) % sizeof(T), 0);
+    }
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    if (_swap) {
+      std::reverse(bytes, bytes + sizeof(T));
+    }
+    _buffer.insert(_buffer.end(), bytes, bytes + sizeof(T));
+  }
+
+  void putString(const std::string& str) {
+    put<uint32_t>(str.size() + (_cdr ? 1 : 0));
+    _buffer.insert(_buffer.end(), str.begin(), str.end());
+    if (_cdr) {
+      _buffer.push_back(0);
+    }
+  }
+
+  Span<const uint8_t> span() const {
+    return {_buffer.data(), _buffer.size()};
+  }
+
+ private:
+  bool _cdr;
+  bool _swap;
+  std::vector<uint8_t> _buffer;
+};
+
+void WriteRos2Message(Writer& writer, int points, int names, int data, int64_t counter = 42) {
+  writer.put<int32_t>(1700000000);
+  writer.put<uint32_t>(123456789);
+  writer.putString("base_link");
+  writer.put<uint32_t>(points);
+  for (int i = 0; i < points; i++) {
+    writer.put<double>(i);
+    writer.put<double>(i + 0.5);
+    writer.put<double>(-i);
+  }
+  for (int i = 0; i < 3; i++) {
+    writer.put<float>(0.25f * i);
+  }
+  writer.put<uint8_t>(7);
+  writer.put<int16_t>(-300);
+  writer.put<uint32_t>(names);
+  for (int i = 0; i < names; i++) {
+    writer.putString("name_" + std::to_string(i));
+  }
+  writer.put<uint32_t>(data);
+  for (int i = 0; i < data; i++) {
+    writer.put<uint8_t>(i);
+  }
+  writer.put<int64_t>(counter);
+  writer.put<uint8_t>(1);
+}
+
+void ExpectSameValues(const Parser& parser, Span<const uint8_t> buffer, Deserializer* deserializer) {
+  FlatMessage flat;
+  const bool flat_complete = parser.deserialize(buffer, &flat, deserializer);
+
+  FlatValues values;
+  ASSERT_TRUE(parser.deserializeValues(buffer, &values, deserializer));
+  EXPECT_EQ(values.entire_message_parsed, flat_complete);
+  ASSERT_EQ(values.values.size(), flat.value.size());
+
+  size_t string_index = 0;
+  for (size_t i = 0; i < flat.value.size(); i++) {
+    const auto& [leaf, variant] = flat.value[i];
+    if (variant.getTypeID() == STRING) {
+      ASSERT_LT(string_index, values.strings.size());
+      EXPECT_EQ(values.strings[string_index].first, i);
+      EXPECT_EQ(values.strings[string_index].second, variant.extract<std::string>()) << leaf.toStdString();
+      string_index++;
+    } else {
+      EXPECT_EQ(values.values[i], variant.convert<double>()) << leaf.toStdString();
+    }
+  }
+  EXPECT_EQ(string_index, values.strings.size());
+}
+
+}  // namespace
+
+TEST(DeserializationPlan, SameValuesCDR) {
+  Parser parser("/topic", ROSType("test_msgs/Sample"), std::string(ROS2_SCHEMA) + ROS2_HEADER);
+  ROS2_Deserializer deserializer;
+
+  for (int points : {0, 1, 3}) {
+    for (int names : {0, 2}) {
+      Writer writer(true);
+      WriteRos2Message(writer, points, names, 5);
+      ExpectSameValues(parser, writer.span(), &deserializer);
+    }
+  }
+}
+
+TEST(DeserializationPlan, BigEndianCDR) {
+  Parser parser("/topic", ROSType("test_msgs/Sample"), std::string(ROS2_SCHEMA) + ROS2_HEADER);
+  ROS2_Deserializer deserializer;
+
+  Writer writer(true, false);
+  WriteRos2Message(writer, 2, 2, 3);
+  ExpectSameValues(parser, writer.span(), &deserializer);
+
+  FlatValues values;
+  ASSERT_TRUE(parser.deserializeValues(writer.span(), &values, &deserializer));
+  EXPECT_EQ(values.values[0], 1700000000);
+  EXPECT_EQ(values.values[3], 0.0);
+  EXPECT_EQ(values.values[4], 0.5);
+}
+
+TEST(DeserializationPlan, SequenceSizes) {
+  Parser parser("/topic", ROSType("test_msgs/Sample"), std::string(ROS2_SCHEMA) + ROS2_HEADER);
+  ROS2_Deserializer deserializer;
+
+  Writer writer(true);
+  WriteRos2Message(writer, 3, 2, 5);
+  FlatValues values;
+  ASSERT_TRUE(parser.deserializeValues(writer.span(), &values, &deserializer));
+  EXPECT_EQ(values.sequence_sizes, (std::vector<uint32_t>{3, 2, 5}));
+  // header (3) + points (9) + gains (3) + mode, offset (2) + names (2) + data (5) + counter, enabled (2)
+  EXPECT_EQ(values.values.size(), 26);
+  ASSERT_EQ(values.strings.size(), 3);
+  EXPECT_EQ(values.strings[0].second, "base_link");
+  EXPECT_EQ(values.strings[2].second, "name_1");
+}
+
+TEST(DeserializationPlan, LargeArrays) {
+  const std::string schema = std::string(ROS2_SCHEMA) + ROS2_HEADER;
+  ROS2_Deserializer deserializer;
+  Writer writer(true);
+  WriteRos2Message(writer, 10, 10, 20);
+
+  for (auto policy : {Parser::DISCARD_LARGE_ARRAYS, Parser::KEEP_LARGE_ARRAYS}) {
+    Parser parser("/topic", ROSType("test_msgs/Sample"), schema);
+    parser.setMaxArrayPolicy(policy, 4);
+    ExpectSameValues(parser, writer.span(), &deserializer);
+  }
+}
+
+TEST(DeserializationPlan, Ros1) {
+  const std::string schema =
+      "Header header\n"
+      "duration elapsed\n"
+      "float64[2] position\n"
+      "string label\n"
+      "================================================================================\n"
+      "MSG: std_msgs/Header\n"
+      "uint32 seq\n"
+      "time stamp\n"
+      "string frame_id\n";
+  Parser parser("/topic", ROSType("test_msgs/Sample"), schema);
+  ROS_Deserializer deserializer;
+
+  Writer writer(false);
+  writer.put<uint32_t>(12);
+  writer.put<uint32_t>(1700000000);
+  writer.put<uint32_t>(500000000);
+  writer.putString("map");
+  writer.put<uint32_t>(3);
+  writer.put<uint32_t>(250000000);
+  writer.put<double>(1.5);
+  writer.put<double>(-2.5);
+  writer.putString("ok");
+  ExpectSameValues(parser, writer.span(), &deserializer);
+
+  FlatValues values;
+  ASSERT_TRUE(parser.deserializeValues(writer.span(), &values, &deserializer));
+  ASSERT_EQ(values.values.size(), 7);
+  EXPECT_DOUBLE_EQ(values.values[1], 1700000000.5);
+  EXPECT_DOUBLE_EQ(values.values[3], 3.25);
+}
+
+TEST(DeserializationPlan, Truncation) {
+  Parser parser("/topic", ROSType("test_msgs/Sample"), std::string(ROS2_SCHEMA) + ROS2_HEADER);
+  ROS2_Deserializer deserializer;
+
+  Writer writer(true);
+  const int64_t counter = (int64_t(1) << 62) + 1;
+  WriteRos2Message(writer, 0, 0, 0, counter);
+
+  FlatValues values;
+  EXPECT_THROW(parser.deserializeValues(writer.span(), &values, &deserializer), RangeException);
+  ASSERT_TRUE(parser.deserializeValues(writer.span(), &values, &deserializer, false));
+  EXPECT_EQ(values.values[values.values.size() - 2], double(counter));
+}
+
+TEST(DeserializationPlan, Overrun) {
+  Parser parser("/topic", ROSType("test_msgs/Sample"), std::string(ROS2_SCHEMA) + ROS2_HEADER);
+  ROS2_Deserializer deserializer;
+
+  Writer writer(true);
+  WriteRos2Message(writer, 3, 2, 5);
+  auto span = writer.span();
+  FlatValues values;
+  EXPECT_THROW(parser.deserializeValues(span.subspan(0, span.size() - 4), &values, &deserializer), std::runtime_error);
+}
+
+TEST(DeserializationPlan, WholeLargeArrays) {
+  const std::string schema =
+      "float32[] ranges\n"
+      "test_msgs/Inner inner\n"
+      "float64 last\n"
+      "================================================================================\n"
+      "MSG: test_msgs/Inner\n"
+      "int16[] samples\n";
+  Parser parser("/topic", ROSType("test_msgs/Sample"), schema);
+  parser.setMaxArrayPolicy(Parser::DISCARD_LARGE_ARRAYS, 4);
+  parser.setWholeLargeArrays(true);
+  ROS2_Deserializer deserializer;
+
+  Writer writer(true);
+  writer.put<uint32_t>(10);
+  for (int i = 0; i < 10; i++) {
+    writer.put<float>(0.5f * i);
+  }
+  writer.put<uint32_t>(6);
+  for (int i = 0; i < 6; i++) {
+    writer.put<int16_t>(-i);
+  }
+  writer.put<double>(1.5);
+
+  FlatValues values;
+  ASSERT_TRUE(parser.deserializeValues(writer.span(), &values, &deserializer));
+  // the large arrays have no leaves, as in deserialize()
+  FlatMessage flat;
+  parser.deserialize(writer.span(), &flat, &deserializer);
+  ASSERT_EQ(values.values.size(), flat.value.size());
+  EXPECT_EQ(values.values, (std::vector<double>{1.5}));
+
+  ASSERT_EQ(values.large_arrays.size(), 2);
+  EXPECT_EQ(values.large_arrays[0].path, "ranges");
+  EXPECT_EQ(values.large_arrays[0].size, 10);
+  EXPECT_EQ(values.large_arrays[1].path, "inner/samples");
+  EXPECT_EQ(values.large_arrays[1].size, 6);
+  EXPECT_EQ(values.array_values.size(), 16);
+  EXPECT_EQ(values.array_values[values.large_arrays[0].offset + 9], 4.5);
+  EXPECT_EQ(values.array_values[values.large_arrays[1].offset + 5], -5);
+
+  // small arrays are leaves, as usual
+  parser.setMaxArrayPolicy(Parser::DISCARD_LARGE_ARRAYS, 100);
+  ExpectSameValues(parser, writer.span(), &deserializer);
+  ASSERT_TRUE(parser.deserializeValues(writer.span(), &values, &deserializer));
+  EXPECT_TRUE(values.large_arrays.empty());
+}
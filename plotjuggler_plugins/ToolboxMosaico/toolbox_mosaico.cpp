@@ -338,10 +338,10 @@ void ToolboxMosaico::onAllFetchesComplete()
 // Recursively flattens an Arrow array into PlotJuggler series.
 // For numeric arrays, creates a series directly.
 // For struct arrays, recurses into each child field, building the path with '/'.
+// "timestamps" contains the time (in seconds) of each row of the record batch.
 void ToolboxMosaico::flattenArray(const std::shared_ptr<arrow::Array>& array,
-                                  const std::shared_ptr<arrow::Array>& ts_array,
-                                  arrow::Type::type ts_type, bool ts_is_ns, int64_t num_rows,
-                                  const std::string& path, std::set<std::string>& created_series)
+                                  const std::vector<double>& timestamps, const std::string& path,
+                                  std::set<std::string>& created_series)
 {
   auto type_id = array->type_id();
 
@@ -349,12 +349,12 @@ void ToolboxMosaico::flattenArray(const std::shared_ptr<arrow::Array>& array,
   {
     auto& series = imported_data_.getOrCreateNumeric(path);
     created_series.insert(path);
-    for (int64_t row = 0; row < num_rows; ++row)
+    std::vector<double> values(timestamps.size());
+    for (size_t row = 0; row < values.size(); ++row)
     {
-      double t = getTimestampSeconds(ts_array, row, ts_type, ts_is_ns);
-      double v = getArrowValue(array, row, type_id);
-      series.pushBack({ t, v });
+      values[row] = getArrowValue(array, static_cast<int64_t>(row), type_id);
     }
+    series.pushBackBatch(timestamps, values);
     return;
   }
 
@@ -371,8 +371,7 @@ void ToolboxMosaico::flattenArray(const std::shared_ptr<arrow::Array>& array,
         continue;
       }
       auto child_path = path + "/" + child_name;
-      flattenArray(struct_arr->field(i), ts_array, ts_type, ts_is_ns, num_rows, child_path,
-                   created_series);
+      flattenArray(struct_arr->field(i), timestamps, child_path, created_series);
     }
   }
 }
@@ -490,6 +489,11 @@ void ToolboxMosaico::appendRecordBatchToSeries(const QString& sequence_name,
   }
 
   auto ts_array = batch->column(state.ts_col);
+  std::vector<double> timestamps(batch->num_rows());
+  for (int64_t row = 0; row < batch->num_rows(); ++row)
+  {
+    timestamps[row] = getTimestampSeconds(ts_array, row, state.ts_type, state.ts_is_ns);
+  }
 
   for (int col = 0; col < batch->num_columns(); ++col)
   {
@@ -503,8 +507,7 @@ void ToolboxMosaico::appendRecordBatchToSeries(const QString& sequence_name,
       continue;
     }
     auto col_path = state.prefix + "/" + field->name();
-    flattenArray(batch->column(col), ts_array, state.ts_type, state.ts_is_ns, batch->num_rows(),
-                 col_path, state.created_series);
+    flattenArray(batch->column(col), timestamps, col_path, state.created_series);
   }
 }
 
@@ -22,6 +22,7 @@ using mosaico::TopicInfo;
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 #include <unordered_map>
 
 class MainWindow;
@@ -67,8 +68,7 @@ private:
   void appendRecordBatchToSeries(const QString& sequence_name, const QString& topic_name,
                                  const std::shared_ptr<arrow::RecordBatch>& batch);
   void flattenArray(const std::shared_ptr<arrow::Array>& array,
-                    const std::shared_ptr<arrow::Array>& ts_array, arrow::Type::type ts_type,
-                    bool ts_is_ns, int64_t num_rows, const std::string& path,
+                    const std::vector<double>& timestamps, const std::string& path,
                     std::set<std::string>& created_series);
 
   PJ::PlotDataMapRef* plot_data_ = nullptr;